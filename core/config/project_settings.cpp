@@ -376,6 +376,30 @@ Variant ProjectSettings::get_setting_with_override(const StringName &p_name) con
 	return props[name].variant;
 }
 
+// Like `get_setting_with_override()`, for the features of another target, such as an export preset.
+Variant ProjectSettings::get_setting_with_override_and_custom_features(const StringName &p_name, const Vector<String> &p_features) const {
+	_THREAD_SAFE_METHOD_
+
+	StringName name = p_name;
+	if (feature_overrides.has(name)) {
+		const LocalVector<Pair<StringName, StringName>> &overrides = feature_overrides[name];
+		for (uint32_t i = 0; i < overrides.size(); i++) {
+			if (p_features.has(overrides[i].first)) {
+				if (props.has(overrides[i].second)) {
+					name = overrides[i].second;
+					break;
+				}
+			}
+		}
+	}
+
+	if (!props.has(name)) {
+		WARN_PRINT("Property not found: " + String(name));
+		return Variant();
+	}
+	return props[name].variant;
+}
+
 struct _VCSort {
 	String name;
 	Variant::Type type = Variant::VARIANT_MAX;
@@ -53,6 +53,7 @@
 
 #include "bvh_tree.h"
 #include "core/os/mutex.h"
+#include "core/templates/parallel.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
 #define BVH_LOCKED_FUNCTION BVHLockedFunction _lock_guard(&_mutex, BVH_THREAD_SAFE &&_thread_safe);
@@ -88,6 +89,14 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// when enabled, update() culls for the moved items on the WorkerThreadPool,
+	// then sends the callbacks from the calling thread. The callbacks are the same,
+	// and in the same order, as without it.
+	void params_set_parallel_pairing(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pairing = p_enable;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -300,7 +309,11 @@ public:
 	void update() {
 		BVH_LOCKED_FUNCTION
 		tree.update();
-		_check_for_collisions();
+		if (_parallel_pairing) {
+			_check_for_collisions_parallel();
+		} else {
+			_check_for_collisions();
+		}
 #ifdef BVH_INTEGRITY_CHECKS
 		tree._integrity_check_all();
 #endif
@@ -309,7 +322,11 @@ public:
 	// this can be called more frequently than per frame if necessary
 	void update_collisions() {
 		BVH_LOCKED_FUNCTION
-		_check_for_collisions();
+		if (_parallel_pairing) {
+			_check_for_collisions_parallel();
+		} else {
+			_check_for_collisions();
+		}
 	}
 
 	// prefer calling this directly as type safe
@@ -480,6 +497,81 @@ private:
 		_reset();
 	}
 
+	// the candidates found for the changed items of one chunk, by _check_for_collisions_parallel().
+	struct PairingCandidates {
+		LocalVector<uint32_t> hits; // cull hits of all the items, one after the other.
+		LocalVector<uint32_t> item_ends; // end of each item's hits.
+	};
+
+	// same as _check_for_collisions(), with the culls for the changed items run in parallel.
+	// They don't modify anything, and the pairs don't change the tree, so each cull finds what
+	// the serial check would. Leavers and enterers are then processed in the order of
+	// changed_items, so the callbacks are the same as with the serial check.
+	void _check_for_collisions_parallel() {
+		if (!changed_items.size()) {
+			// noop
+			return;
+		}
+
+		LocalVector<PairingCandidates> chunk_candidates;
+
+		auto find_candidates = [&](int64_t p_chunk, int64_t p_from, int64_t p_to) {
+			PairingCandidates &candidates = chunk_candidates[p_chunk];
+			LocalVector<uint32_t, uint32_t, true> hits;
+
+			typename BVHTREE_CLASS::CullParams params;
+			params.result_count_overall = 0;
+			params.result_max = INT_MAX;
+			params.result_array = nullptr;
+			params.subindex_array = nullptr;
+			params.hits = &hits;
+
+			for (int64_t i = p_from; i < p_to; i++) {
+				const BVHHandle h = changed_items[i];
+				tree.item_fill_cullparams(h, params);
+				params.abb.from(tree._pairs[h.id()].expanded_aabb);
+				params.result_count_overall = 0;
+				tree.cull_aabb(params, false);
+
+				for (const uint32_t ref_id : hits) {
+					candidates.hits.push_back(ref_id);
+				}
+				candidates.item_ends.push_back(candidates.hits.size());
+			}
+		};
+
+		// few items aren't worth waking up the threads for
+		const int64_t grain_size = changed_items.size() < PARALLEL_PAIRING_MIN_ITEMS ? changed_items.size() : 0;
+		ParallelChunks<decltype(find_candidates)> chunks(0, changed_items.size(), grain_size, find_candidates);
+		chunk_candidates.resize(chunks.get_chunk_count());
+		chunks.run();
+
+		// the chunks are contiguous, so this follows the order of changed_items.
+		uint32_t item = 0;
+		for (const PairingCandidates &candidates : chunk_candidates) {
+			uint32_t hit = 0;
+			for (const uint32_t item_end : candidates.item_ends) {
+				const BVHHandle h = changed_items[item++];
+				BVHABB_CLASS abb;
+				abb.from(tree._pairs[h.id()].expanded_aabb);
+				_find_leavers(h, abb, false);
+
+				for (; hit < item_end; hit++) {
+					const uint32_t ref_id = candidates.hits[hit];
+					// don't collide against ourself
+					if (ref_id == h.id()) {
+						continue;
+					}
+
+					BVHHandle h_collidee;
+					h_collidee.set_id(ref_id);
+					_collide(h, h_collidee);
+				}
+			}
+		}
+		_reset();
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -773,6 +865,11 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	enum {
+		PARALLEL_PAIRING_MIN_ITEMS = 64,
+	};
+	bool _parallel_pairing = false;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -54,6 +54,28 @@
 	}
 #endif
 
+// Same as above, but keeps track of pushes that had to wait for another thread.
+#ifdef DEV_ENABLED
+#define LOCK_MUTEX_PUSH                                \
+	if (this != MessageQueue::thread_singleton) {      \
+		DEV_ASSERT(!this->is_current_thread_override); \
+		if (!mutex.try_lock()) {                       \
+			contended_pushes.increment();              \
+			mutex.lock();                              \
+		}                                              \
+	} else {                                           \
+		DEV_ASSERT(this->is_current_thread_override);  \
+	}
+#else
+#define LOCK_MUTEX_PUSH                           \
+	if (this != MessageQueue::thread_singleton) { \
+		if (!mutex.try_lock()) {                  \
+			contended_pushes.increment();         \
+			mutex.lock();                         \
+		}                                         \
+	}
+#endif
+
 #define UNLOCK_MUTEX                              \
 	if (this != MessageQueue::thread_singleton) { \
 		mutex.unlock();                           \
@@ -89,7 +111,13 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 
 	ERR_FAIL_COND_V_MSG(room_needed > uint32_t(PAGE_SIZE_BYTES), ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(PAGE_SIZE_BYTES) + " bytes), consider passing less arguments.");
 
-	LOCK_MUTEX;
+	if (CallQueue *staging = _get_thread_staging()) {
+		Error err = staging->push_callablep(p_callable, p_args, p_argcount, p_show_error);
+		has_staged_messages.set();
+		return err;
+	}
+
+	LOCK_MUTEX_PUSH;
 
 	_ensure_first_page();
 
@@ -135,7 +163,13 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 }
 
 Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	LOCK_MUTEX;
+	if (CallQueue *staging = _get_thread_staging()) {
+		Error err = staging->push_set(p_id, p_prop, p_value);
+		has_staged_messages.set();
+		return err;
+	}
+
+	LOCK_MUTEX_PUSH;
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
 	_ensure_first_page();
@@ -176,7 +210,14 @@ Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant
 
 Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
-	LOCK_MUTEX;
+
+	if (CallQueue *staging = _get_thread_staging()) {
+		Error err = staging->push_notification(p_id, p_notification);
+		has_staged_messages.set();
+		return err;
+	}
+
+	LOCK_MUTEX_PUSH;
 	uint32_t room_needed = sizeof(Message);
 
 	_ensure_first_page();
@@ -276,12 +317,38 @@ Error CallQueue::_transfer_messages_to_main_queue() {
 	return OK;
 }
 
+void CallQueue::_enable_thread_staging() {
+	ERR_FAIL_COND(!thread_staging.is_empty());
+	thread_staging.resize(THREAD_STAGING_QUEUES);
+	for (uint32_t i = 0; i < thread_staging.size(); i++) {
+		thread_staging[i] = memnew(CallQueue(nullptr, max_pages, error_text));
+	}
+}
+
+void CallQueue::_merge_thread_staging() {
+	// Messages are only ever moved into the main queue.
+	DEV_ASSERT(this == MessageQueue::main_singleton);
+
+	// Cleared first, so anything staged while merging flags it again.
+	has_staged_messages.clear();
+	for (CallQueue *staging : thread_staging) {
+		staging->mutex.lock();
+		staging->_transfer_messages_to_main_queue();
+		staging->mutex.unlock();
+	}
+}
+
 Error CallQueue::flush() {
 	// Thread overrides are not meant to be flushed, but appended to the main one.
 	if (unlikely(this == MessageQueue::thread_singleton)) {
 		return _transfer_messages_to_main_queue();
 	}
 
+	// Only merged when not already flushing, since that would append behind the messages being processed.
+	if (has_staged_messages.is_set() && !flushing) {
+		_merge_thread_staging();
+	}
+
 	LOCK_MUTEX;
 
 	if (pages.size() == 0) {
@@ -353,6 +420,21 @@ Error CallQueue::flush() {
 			i++;
 			offset = 0;
 		}
+
+		if (i == pages_used && has_staged_messages.is_set()) {
+			// Other threads staged messages while flushing. Process them in this same flush,
+			// as if they had been pushed to this queue directly.
+			// Go back to the end of the last page first, since they may be appended to it.
+			i--;
+			offset = page_bytes[i];
+			UNLOCK_MUTEX;
+			_merge_thread_staging();
+			LOCK_MUTEX;
+			if (offset == page_bytes[i] && i + 1 < pages_used) {
+				i++;
+				offset = 0;
+			}
+		}
 	}
 
 	page_bytes[0] = 0;
@@ -364,6 +446,11 @@ Error CallQueue::flush() {
 }
 
 void CallQueue::clear() {
+	for (CallQueue *staging : thread_staging) {
+		staging->clear();
+	}
+	has_staged_messages.clear();
+
 	LOCK_MUTEX;
 
 	if (pages.size() == 0) {
@@ -483,6 +570,7 @@ void CallQueue::statistics() {
 
 	print_line("TOTAL PAGES: " + itos(pages_used) + " (" + itos(pages_used * PAGE_SIZE_BYTES) + " bytes).");
 	print_line("NULL count: " + itos(null_count));
+	print_line("CONTENDED pushes: " + itos(get_contended_push_count()));
 
 	for (const KeyValue<StringName, int> &E : set_count) {
 		print_line("SET " + E.key + ": " + itos(E.value));
@@ -504,6 +592,9 @@ bool CallQueue::is_flushing() const {
 }
 
 bool CallQueue::has_messages() const {
+	if (has_staged_messages.is_set()) {
+		return true;
+	}
 	if (pages_used == 0) {
 		return false;
 	}
@@ -518,6 +609,14 @@ int CallQueue::get_max_buffer_usage() const {
 	return pages.size() * PAGE_SIZE_BYTES;
 }
 
+uint64_t CallQueue::get_contended_push_count() const {
+	uint64_t count = contended_pushes.get();
+	for (const CallQueue *staging : thread_staging) {
+		count += staging->contended_pushes.get();
+	}
+	return count;
+}
+
 CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text) {
 	if (p_custom_allocator) {
 		allocator = p_custom_allocator;
@@ -532,6 +631,9 @@ CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const
 
 CallQueue::~CallQueue() {
 	clear();
+	for (CallQueue *staging : thread_staging) {
+		memdelete(staging);
+	}
 	// Let go of pages.
 	for (uint32_t i = 0; i < pages.size(); i++) {
 		allocator->free(pages[i]);
@@ -571,6 +673,7 @@ MessageQueue::MessageQueue() :
 				"Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_mb' in project settings.") {
 	ERR_FAIL_COND_MSG(main_singleton != nullptr, "A MessageQueue singleton already exists.");
 	main_singleton = this;
+	_enable_thread_staging();
 }
 
 MessageQueue::~MessageQueue() {
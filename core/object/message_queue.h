@@ -32,9 +32,11 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
+#include "core/os/thread.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
 class Object;
@@ -44,7 +46,8 @@ class CallQueue {
 
 public:
 	enum {
-		PAGE_SIZE_BYTES = 4096
+		PAGE_SIZE_BYTES = 4096,
+		THREAD_STAGING_QUEUES = 16,
 	};
 
 	struct Page {
@@ -77,6 +80,13 @@ private:
 	uint32_t pages_used = 0;
 	bool flushing = false;
 
+	// Optional staging queues for pushes coming from threads other than the main one.
+	// Each thread always maps to the same staging queue, so its messages keep their order.
+	// They are merged into this queue at the beginning of every flush.
+	LocalVector<CallQueue *> thread_staging;
+	SafeFlag has_staged_messages;
+	SafeNumeric<uint64_t> contended_pushes;
+
 #ifdef DEV_ENABLED
 	bool is_current_thread_override = false;
 #endif
@@ -100,6 +110,15 @@ private:
 
 	Error _transfer_messages_to_main_queue();
 
+	_FORCE_INLINE_ CallQueue *_get_thread_staging() {
+		if (likely(thread_staging.is_empty() || Thread::is_main_thread())) {
+			return nullptr;
+		}
+		return thread_staging[Thread::get_caller_id() % thread_staging.size()];
+	}
+	void _enable_thread_staging();
+	void _merge_thread_staging();
+
 	void _add_page();
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
@@ -154,6 +173,7 @@ public:
 
 	bool is_flushing() const;
 	int get_max_buffer_usage() const;
+	uint64_t get_contended_push_count() const;
 
 	CallQueue(Allocator *p_custom_allocator = 0, uint32_t p_max_pages = 8192, const String &p_error_text = String());
 	virtual ~CallQueue();
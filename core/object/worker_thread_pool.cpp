@@ -74,7 +74,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 
 	if (p_task->group) {
 		// Handling a group
-		bool do_post = false;
+		bool do_post = p_task->group->max == 0; // Empty groups only have a task when they had to wait for dependencies.
 
 		while (true) {
 			uint32_t work_index = p_task->group->index.postincrement();
@@ -103,8 +103,18 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		}
 
 		if (do_post) {
-			p_task->group->done_semaphore.post();
+			LocalVector<Task *> process_on_calling_thread;
+			task_mutex.lock();
+			// Set with the mutex held, so dependencies added concurrently are either released here or not registered at all.
 			p_task->group->completed.set_to(true);
+			_release_dependents(p_task->group->dependents, process_on_calling_thread);
+			task_mutex.unlock();
+
+			p_task->group->done_semaphore.post();
+
+			for (Task *task : process_on_calling_thread) {
+				_process_task(task);
+			}
 		}
 		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = p_task->group->finished.increment();
@@ -121,6 +131,8 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		task_mutex.lock();
 		task_allocator.free(p_task);
 	} else {
+		LocalVector<Task *> process_on_calling_thread;
+
 		if (p_task->native_func) {
 			p_task->native_func(p_task->native_func_userdata);
 		} else if (p_task->template_userdata) {
@@ -143,6 +155,16 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 				threads[i].signaled = true;
 			}
 		}
+		_release_dependents(p_task->dependents, process_on_calling_thread);
+
+		if (unlikely(process_on_calling_thread.size())) {
+			// No pool threads, so this is already the calling thread.
+			task_mutex.unlock();
+			for (Task *task : process_on_calling_thread) {
+				_process_task(task);
+			}
+			task_mutex.lock();
+		}
 	}
 
 #ifdef THREADS_ENABLED
@@ -165,11 +187,79 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 #endif
 }
 
+WorkerThreadPool::Task *WorkerThreadPool::_pop_or_steal_task(ThreadData *p_thread_data) {
+	Task *task = nullptr;
+	if (p_thread_data->work_queue.pop(task)) {
+		return task;
+	}
+
+	uint32_t thread_count = threads.size();
+	if (thread_count < 2) {
+		return nullptr;
+	}
+
+	// Start at a random victim (xorshift) so idle threads don't all hammer the same queue.
+	uint32_t &seed = p_thread_data->steal_seed;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	uint32_t first_victim = seed % thread_count;
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		ThreadData &victim = threads[(first_victim + i) % thread_count];
+		if (&victim == p_thread_data) {
+			continue;
+		}
+		if (victim.work_queue.steal(task)) {
+			return task;
+		}
+	}
+
+	return nullptr;
+}
+
+bool WorkerThreadPool::_has_stealable_tasks() const {
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (!threads[i].work_queue.is_empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WorkerThreadPool::_push_to_work_queue(ThreadData *p_thread_data, Task *p_task) {
+	// Called by the owner of the queue, without task_mutex held.
+	if (!p_thread_data->work_queue.push(p_task)) {
+		return false;
+	}
+
+	// Pairs with the fence in _can_sleep(): either a thread about to sleep sees the new task,
+	// or it's counted here and gets notified.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (sleeping_threads.get()) {
+		MutexLock lock(task_mutex);
+		_notify_threads(p_thread_data, 1, 0);
+	}
+	return true;
+}
+
+bool WorkerThreadPool::_can_sleep() {
+	// Must be called with task_mutex held. If it returns true, the thread must wait and then call sleeping_threads.decrement().
+	sleeping_threads.increment();
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_has_stealable_tasks()) {
+		sleeping_threads.decrement();
+		return false;
+	}
+	return true;
+}
+
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
+		// Lock-free path first: own queue, then stealing from other threads' queues.
+		Task *task_to_process = singleton->_pop_or_steal_task(thread_data);
+		if (!task_to_process) {
 			MutexLock lock(singleton->task_mutex);
 			if (singleton->exit_threads) {
 				return;
@@ -179,8 +269,9 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 			if (singleton->task_queue.first()) {
 				task_to_process = singleton->task_queue.first()->self();
 				singleton->task_queue.remove(singleton->task_queue.first());
-			} else {
+			} else if (singleton->_can_sleep()) {
 				thread_data->cond_var.wait(lock);
+				singleton->sleeping_threads.decrement();
 				DEV_ASSERT(singleton->exit_threads || thread_data->signaled);
 			}
 		}
@@ -204,6 +295,13 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 		return;
 	}
 
+	_post_tasks(p_tasks, p_count, p_high_priority);
+
+	task_mutex.unlock();
+}
+
+void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority) {
+	// Must be called with task_mutex held and with pool threads available.
 	uint32_t to_process = 0;
 	uint32_t to_promote = 0;
 
@@ -211,7 +309,10 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
-		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
+		if (p_high_priority && caller_pool_thread && caller_pool_thread->work_queue.push(p_tasks[i])) {
+			// Posted from a pool thread: keep it local. Idle threads will steal it if needed.
+			to_process++;
+		} else if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
 			task_queue.add_last(&p_tasks[i]->task_elem);
 			if (!p_high_priority) {
 				low_priority_threads_used++;
@@ -225,8 +326,58 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 	}
 
 	_notify_threads(caller_pool_thread, to_process, to_promote);
+}
 
-	task_mutex.unlock();
+bool WorkerThreadPool::_add_dependencies(Task **p_tasks, uint32_t p_count, const Vector<TaskID> &p_dependencies, TaskID p_self) {
+	// Must be called with task_mutex held. Returns true if the tasks have to wait before being posted.
+	uint32_t pending = 0;
+
+	for (const TaskID &dependency : p_dependencies) {
+		ERR_CONTINUE_MSG(dependency == p_self, "A task can't depend on itself.");
+
+		LocalVector<Task *> *dependents = nullptr;
+		if (Task **taskp = tasks.getptr(dependency)) {
+			if (!(*taskp)->completed) {
+				dependents = &(*taskp)->dependents;
+			}
+		} else if (Group **groupp = groups.getptr(dependency)) {
+			if (!(*groupp)->completed.is_set()) {
+				dependents = &(*groupp)->dependents;
+			}
+		} else {
+			// IDs are never reused, so a known one not found anymore was already completed and awaited.
+			ERR_CONTINUE_MSG(dependency < 1 || dependency >= (TaskID)last_task, "Invalid Task or Group ID in dependencies.");
+		}
+
+		if (dependents) {
+			for (uint32_t i = 0; i < p_count; i++) {
+				dependents->push_back(p_tasks[i]);
+			}
+			pending++;
+		}
+	}
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_tasks[i]->dependencies_left = pending;
+	}
+
+	return pending > 0;
+}
+
+void WorkerThreadPool::_release_dependents(LocalVector<Task *> &p_dependents, LocalVector<Task *> &r_process_on_calling_thread) {
+	// Must be called with task_mutex held.
+	for (Task *dependent : p_dependents) {
+		DEV_ASSERT(dependent->dependencies_left > 0);
+		dependent->dependencies_left--;
+		if (dependent->dependencies_left == 0) {
+			if (threads.size() == 0) {
+				r_process_on_calling_thread.push_back(dependent);
+			} else {
+				_post_tasks(&dependent, 1, !dependent->low_priority);
+			}
+		}
+	}
+	p_dependents.clear();
 }
 
 void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count) {
@@ -309,7 +460,7 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
 	task_mutex.lock();
 	// Get a free task
 	Task *task = task_allocator.alloc();
@@ -322,8 +473,28 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->template_userdata = p_template_userdata;
 	tasks.insert(id, task);
 
-	_post_tasks_and_unlock(&task, 1, p_high_priority);
+	if (_add_dependencies(&task, 1, p_dependencies, id)) {
+		// Will be posted by the last dependency to complete.
+		task->low_priority = !p_high_priority;
+		task_mutex.unlock();
+		return id;
+	}
 
+	if (p_high_priority && threads.size()) {
+		ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
+		if (caller_pool_thread) {
+			// Posted from a pool thread: only the bookkeeping above needs the mutex,
+			// the task goes to the thread's own queue without it.
+			task->low_priority = false;
+			task_mutex.unlock();
+			if (_push_to_work_queue(caller_pool_thread, task)) {
+				return id;
+			}
+			task_mutex.lock(); // Queue full, post it to the shared one.
+		}
+	}
+
+	_post_tasks_and_unlock(&task, 1, p_high_priority);
 	return id;
 }
 
@@ -331,6 +502,14 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bo
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
 
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task_with_dependencies(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task_with_dependencies(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, p_dependencies);
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	task_mutex.lock();
 	const Task *const *taskp = tasks.getptr(p_task_id);
@@ -400,7 +579,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 					// This thread was awaken also for some reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
 					if (!exit_threads && was_signaled) {
-						uint32_t to_process = task_queue.first() ? 1 : 0;
+						uint32_t to_process = (task_queue.first() || _has_stealable_tasks()) ? 1 : 0;
 						uint32_t to_promote = caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
 						if (to_process || to_promote) {
 							// This thread must be left alone since it won't loop again.
@@ -428,12 +607,14 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 						}
 					}
 
-					if (singleton->task_queue.first()) {
+					task_to_process = _pop_or_steal_task(caller_pool_thread);
+
+					if (!task_to_process && task_queue.first()) {
 						task_to_process = task_queue.first()->self();
 						task_queue.remove(task_queue.first());
 					}
 
-					if (!task_to_process) {
+					if (!task_to_process && _can_sleep()) {
 						caller_pool_thread->awaited_task = task;
 
 						if (flushing_cmd_queue) {
@@ -443,6 +624,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 						if (flushing_cmd_queue) {
 							flushing_cmd_queue->lock();
 						}
+						sleeping_threads.decrement();
 
 						DEV_ASSERT(exit_threads || caller_pool_thread->signaled || task->completed);
 						caller_pool_thread->awaited_task = nullptr;
@@ -468,7 +650,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	return OK;
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
@@ -480,37 +662,48 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 	group->max = p_elements;
 	group->self = id;
 
-	Task **tasks_posted = nullptr;
 	if (p_elements == 0) {
 		// Should really not call it with zero Elements, but at least it should work.
+		// A single task is still created, so the group doesn't complete before its dependencies.
+		p_tasks = 1;
+	}
+
+	group->tasks_used = p_tasks;
+	Task **tasks_posted = (Task **)alloca(sizeof(Task *) * p_tasks);
+	for (int i = 0; i < p_tasks; i++) {
+		Task *task = task_allocator.alloc();
+		task->native_group_func = p_func;
+		task->native_func_userdata = p_userdata;
+		task->description = p_description;
+		task->group = group;
+		task->callable = p_callable;
+		task->template_userdata = p_template_userdata;
+		tasks_posted[i] = task;
+		// No task ID is used.
+	}
+
+	groups[id] = group;
+
+	if (_add_dependencies(tasks_posted, p_tasks, p_dependencies, id)) {
+		// Will be posted by the last dependency to complete.
+		for (int i = 0; i < p_tasks; i++) {
+			tasks_posted[i]->low_priority = !p_high_priority;
+		}
+		task_mutex.unlock();
+	} else if (p_elements == 0) {
+		// Nothing to wait for, so the group is already completed.
+		task_allocator.free(tasks_posted[0]);
+		group->tasks_used = 0;
 		group->completed.set_to(true);
 		group->done_semaphore.post();
-		group->tasks_used = 0;
-		p_tasks = 0;
+		task_mutex.unlock();
 		if (p_template_userdata) {
 			memdelete(p_template_userdata);
 		}
-
 	} else {
-		group->tasks_used = p_tasks;
-		tasks_posted = (Task **)alloca(sizeof(Task *) * p_tasks);
-		for (int i = 0; i < p_tasks; i++) {
-			Task *task = task_allocator.alloc();
-			task->native_group_func = p_func;
-			task->native_func_userdata = p_userdata;
-			task->description = p_description;
-			task->group = group;
-			task->callable = p_callable;
-			task->template_userdata = p_template_userdata;
-			tasks_posted[i] = task;
-			// No task ID is used.
-		}
+		_post_tasks_and_unlock(tasks_posted, p_tasks, p_high_priority);
 	}
 
-	groups[id] = group;
-
-	_post_tasks_and_unlock(tasks_posted, p_tasks, p_high_priority);
-
 	return id;
 }
 
@@ -522,6 +715,14 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task_with_dependencies(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_group_task_with_dependencies(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
 	task_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
@@ -609,6 +810,7 @@ void WorkerThreadPool::init(int p_thread_count, float p_low_priority_task_ratio)
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
+		threads[i].steal_seed = (i + 1) * 2654435761u;
 		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
 		thread_ids.insert(threads[i].thread.get_id(), i);
 	}
@@ -651,10 +853,12 @@ void WorkerThreadPool::finish() {
 
 void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("add_task", "action", "high_priority", "description"), &WorkerThreadPool::add_task, DEFVAL(false), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("add_task_with_dependencies", "action", "dependencies", "high_priority", "description"), &WorkerThreadPool::add_task_with_dependencies, DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
 	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
 
 	ClassDB::bind_method(D_METHOD("add_group_task", "action", "elements", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_group_task, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
+	ClassDB::bind_method(D_METHOD("add_group_task_with_dependencies", "action", "elements", "dependencies", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_group_task_with_dependencies, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
 	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
 	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
@@ -40,6 +40,7 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_queue.h"
 
 class CommandQueueMT;
 
@@ -71,6 +72,7 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		LocalVector<Task *> dependents; // Tasks to post once this group is completed.
 	};
 
 	struct Task {
@@ -89,6 +91,8 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
+		uint32_t dependencies_left = 0; // Task is only posted once it reaches zero.
+		LocalVector<Task *> dependents; // Tasks to post once this one is completed.
 
 		void free_template_userdata();
 		Task() :
@@ -97,6 +101,7 @@ private:
 
 	static const uint32_t TASKS_PAGE_SIZE = 1024;
 	static const uint32_t GROUPS_PAGE_SIZE = 256;
+	static const uint32_t THREAD_WORK_QUEUE_SIZE = 256;
 
 	PagedAllocator<Task, false, TASKS_PAGE_SIZE> task_allocator;
 	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
@@ -114,6 +119,9 @@ private:
 		Task *current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable. Special value for idle-waiting.
 		ConditionVariable cond_var;
+		// High-priority tasks posted by this thread. Other pool threads steal from it when idle.
+		WorkStealingQueue<Task *, THREAD_WORK_QUEUE_SIZE> work_queue;
+		uint32_t steal_seed = 0;
 	};
 
 	TightLocalVector<ThreadData> threads;
@@ -138,6 +146,7 @@ private:
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
 	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
+	SafeNumeric<uint32_t> sleeping_threads; // Pool threads about to wait, or waiting, on their condition variable.
 
 	uint64_t last_task = 1;
 
@@ -145,7 +154,15 @@ private:
 
 	void _process_task(Task *task);
 
+	Task *_pop_or_steal_task(ThreadData *p_thread_data);
+	bool _has_stealable_tasks() const;
+	bool _push_to_work_queue(ThreadData *p_thread_data, Task *p_task);
+	bool _can_sleep();
+
+	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority);
 	void _post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority);
+	bool _add_dependencies(Task **p_tasks, uint32_t p_count, const Vector<TaskID> &p_dependencies, TaskID p_self);
+	void _release_dependents(LocalVector<Task *> &p_dependents, LocalVector<Task *> &r_process_on_calling_thread);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
 	bool _try_promote_low_priority_task();
@@ -154,8 +171,8 @@ private:
 
 	static thread_local CommandQueueMT *flushing_cmd_queue;
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
 
 	template <class C, class M, class U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -193,6 +210,10 @@ public:
 	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority = false, const String &p_description = String());
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Continuations: the task is only posted once all the tasks/groups in p_dependencies are completed.
+	TaskID add_native_task_with_dependencies(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_task_with_dependencies(const Callable &p_action, const Vector<TaskID> &p_dependencies, bool p_high_priority = false, const String &p_description = String());
+
 	bool is_task_completed(TaskID p_task_id) const;
 	Error wait_for_task_completion(TaskID p_task_id);
 
@@ -207,6 +228,8 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_native_group_task_with_dependencies(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_group_task_with_dependencies(const Callable &p_action, int p_elements, const Vector<TaskID> &p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
@@ -0,0 +1,185 @@
+/**************************************************************************/
+/*  frame_arena.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/string/ustring.h"
+
+#include <string.h>
+
+thread_local FrameArena::ThreadArena *FrameArena::thread_arena = nullptr;
+FrameArena::ThreadArena *FrameArena::thread_arenas = nullptr;
+BinaryMutex FrameArena::thread_arenas_mutex;
+SafeNumeric<uint64_t> FrameArena::frame;
+SafeNumeric<uint64_t> FrameArena::chunk_allocs;
+
+FrameArena::ThreadArena *FrameArena::_create_thread_arena() {
+	ThreadArena *arena = memnew(ThreadArena);
+	arena->frame = frame.get();
+	{
+		MutexLock lock(thread_arenas_mutex);
+		arena->next = thread_arenas;
+		thread_arenas = arena;
+	}
+	thread_arena = arena;
+	return arena;
+}
+
+FrameArena::Chunk *FrameArena::_add_chunk(ThreadArena *p_arena, size_t p_min_size) {
+	size_t size = MAX(p_min_size, MIN_CHUNK_SIZE);
+	if (p_arena->chunk) {
+		// Grow geometrically, so a busy frame settles on a few chunks.
+		size = MAX(size, p_arena->chunk->size * 2);
+	}
+
+	Chunk *chunk = memnew_placement(Memory::alloc_static(CHUNK_HEADER_SIZE + size), Chunk);
+	chunk->size = size;
+	chunk->prev = p_arena->chunk;
+	p_arena->chunk = chunk;
+	chunk_allocs.increment();
+	return chunk;
+}
+
+void FrameArena::_reset(ThreadArena *p_arena) {
+	p_arena->frame = frame.get();
+#ifdef DEBUG_ENABLED
+	if (p_arena->live_allocs > 0) {
+		ERR_PRINT(itos(p_arena->live_allocs) + " frame arena allocation(s) outlived the frame they were made in.");
+	}
+#endif
+	p_arena->live_allocs = 0;
+
+	Chunk *chunk = p_arena->chunk;
+	if (!chunk) {
+		return;
+	}
+
+	if (!chunk->prev) {
+		chunk->used = 0;
+		return;
+	}
+
+	// More than one chunk was needed last frame. Replace them with a single one
+	// big enough for all of it, so the next frames don't need to allocate at all.
+	size_t total_size = 0;
+	while (chunk) {
+		Chunk *prev = chunk->prev;
+		total_size += chunk->size;
+		Memory::free_static(chunk);
+		chunk = prev;
+	}
+	p_arena->chunk = nullptr;
+	_add_chunk(p_arena, total_size);
+}
+
+void *FrameArena::realloc(void *p_memory, size_t p_bytes) {
+	if (!p_memory) {
+		return alloc(p_bytes);
+	}
+
+	uint8_t *mem = (uint8_t *)p_memory - ALLOC_HEADER_SIZE;
+	AllocHeader *header = (AllocHeader *)mem;
+	ERR_FAIL_COND_V_MSG(header->owner != thread_arena, nullptr, "Frame arena memory must be reallocated from the thread that allocated it.");
+	size_t old_bytes = header->bytes;
+
+	// If it's the last allocation, just move the end of the chunk.
+	ThreadArena *arena = header->owner;
+	Chunk *chunk = arena->chunk;
+	if (chunk) {
+		uint8_t *chunk_end = _get_chunk_data(chunk) + chunk->used;
+		size_t old_size = _get_alloc_size(old_bytes);
+		if (mem + old_size == chunk_end) {
+			size_t new_size = _get_alloc_size(p_bytes);
+			if (chunk->used - old_size + new_size <= chunk->size) {
+				chunk->used = chunk->used - old_size + new_size;
+				header->bytes = p_bytes;
+				return p_memory;
+			}
+		}
+	}
+
+	void *new_memory = alloc(p_bytes);
+	memcpy(new_memory, p_memory, MIN(old_bytes, p_bytes));
+	free(p_memory);
+	return new_memory;
+}
+
+void FrameArena::free(void *p_memory) {
+	if (!p_memory) {
+		return;
+	}
+
+	uint8_t *mem = (uint8_t *)p_memory - ALLOC_HEADER_SIZE;
+	AllocHeader *header = (AllocHeader *)mem;
+	ThreadArena *arena = thread_arena;
+	ERR_FAIL_COND_MSG(header->owner != arena, "Frame arena memory must be freed from the thread that allocated it.");
+	ERR_FAIL_COND_MSG(arena->live_allocs == 0, "Frame arena memory must be freed within the frame it was allocated in.");
+	arena->live_allocs--;
+
+	// Only the most recent allocation can be given back.
+	Chunk *chunk = arena->chunk;
+	size_t size = _get_alloc_size(header->bytes);
+	if (mem + size == _get_chunk_data(chunk) + chunk->used) {
+		chunk->used -= size;
+	}
+}
+
+void FrameArena::end_frame() {
+	frame.increment();
+	if (thread_arena && !thread_arena->owns_frames) {
+		_reset(thread_arena);
+	}
+}
+
+void FrameArena::end_thread_frame() {
+	ThreadArena *arena = thread_arena;
+	if (unlikely(!arena)) {
+		arena = _create_thread_arena();
+	}
+	arena->owns_frames = true;
+	_reset(arena);
+}
+
+void FrameArena::cleanup() {
+	MutexLock lock(thread_arenas_mutex);
+	while (thread_arenas) {
+		ThreadArena *arena = thread_arenas;
+		thread_arenas = arena->next;
+
+		Chunk *chunk = arena->chunk;
+		while (chunk) {
+			Chunk *prev = chunk->prev;
+			Memory::free_static(chunk);
+			chunk = prev;
+		}
+		memdelete(arena);
+	}
+	thread_arena = nullptr;
+}
@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  frame_arena.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Thread-local bump allocator for temporaries that don't outlive the current frame.
+// Every thread gets its own arena, so allocating never locks. Freeing only gives memory
+// back for the most recent allocation; instead, all the memory of an arena is reclaimed
+// at once at the end of the frame.
+//
+// end_frame() resets the arena of the calling thread (the main thread). Threads that run
+// their own frame loop (e.g. the rendering thread) call end_thread_frame() instead, which
+// does the same for their arena. Other threads, like the worker pool ones, have theirs
+// reset on their first allocation of a new frame, once nothing they allocated is alive.
+// Memory must be freed within the same frame, by the thread that allocated it.
+
+class FrameArena {
+	struct Chunk {
+		Chunk *prev = nullptr;
+		size_t size = 0; // Usable bytes, after the header.
+		size_t used = 0;
+	};
+
+	struct ThreadArena {
+		Chunk *chunk = nullptr; // Most recent one; older ones are linked through prev.
+		uint64_t frame = 0;
+		uint32_t live_allocs = 0;
+		bool owns_frames = false; // Only reset through end_thread_frame().
+		ThreadArena *next = nullptr;
+	};
+
+	struct AllocHeader {
+		size_t bytes = 0; // Requested size, needed by realloc().
+		ThreadArena *owner = nullptr;
+	};
+
+	static constexpr size_t ALIGN = 16;
+	static constexpr size_t CHUNK_HEADER_SIZE = (sizeof(Chunk) + ALIGN - 1) & ~(ALIGN - 1);
+	static constexpr size_t ALLOC_HEADER_SIZE = (sizeof(AllocHeader) + ALIGN - 1) & ~(ALIGN - 1);
+	static constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
+
+	static thread_local ThreadArena *thread_arena;
+	static ThreadArena *thread_arenas; // All of them, so they can be released on cleanup.
+	static BinaryMutex thread_arenas_mutex;
+	static SafeNumeric<uint64_t> frame;
+	static SafeNumeric<uint64_t> chunk_allocs;
+
+	static ThreadArena *_create_thread_arena();
+	static Chunk *_add_chunk(ThreadArena *p_arena, size_t p_min_size);
+	static void _reset(ThreadArena *p_arena);
+
+	_FORCE_INLINE_ static ThreadArena *_get_thread_arena() {
+		ThreadArena *arena = thread_arena;
+		if (unlikely(!arena)) {
+			arena = _create_thread_arena();
+		}
+		if (unlikely(arena->frame != frame.get() && arena->live_allocs == 0 && !arena->owns_frames)) {
+			_reset(arena);
+		}
+		return arena;
+	}
+
+	_FORCE_INLINE_ static size_t _get_alloc_size(size_t p_bytes) {
+		return (p_bytes + ALLOC_HEADER_SIZE + ALIGN - 1) & ~(ALIGN - 1);
+	}
+
+	_FORCE_INLINE_ static uint8_t *_get_chunk_data(Chunk *p_chunk) {
+		return (uint8_t *)p_chunk + CHUNK_HEADER_SIZE;
+	}
+
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_bytes) {
+		ThreadArena *arena = _get_thread_arena();
+		size_t size = _get_alloc_size(p_bytes);
+
+		Chunk *chunk = arena->chunk;
+		if (unlikely(!chunk || chunk->used + size > chunk->size)) {
+			chunk = _add_chunk(arena, size);
+		}
+
+		uint8_t *mem = _get_chunk_data(chunk) + chunk->used;
+		chunk->used += size;
+		arena->live_allocs++;
+		AllocHeader *header = (AllocHeader *)mem;
+		header->bytes = p_bytes;
+		header->owner = arena;
+		return mem + ALLOC_HEADER_SIZE;
+	}
+
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Invalidates all the frame allocations done so far, on every thread that doesn't own its frames.
+	static void end_frame();
+	// Invalidates the frame allocations of the calling thread only, which from now on owns its frames.
+	static void end_thread_frame();
+	// Number of chunks requested to the system allocator so far.
+	static uint64_t get_chunk_alloc_count() { return chunk_allocs.get(); }
+
+	static void cleanup();
+};
+
+// For containers that take a static allocator, like LocalVector.
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_memory, size_t p_bytes) { return FrameArena::realloc(p_memory, p_bytes); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameArena::free(p_ptr); }
+};
+
+// For containers that take a typed element allocator, like HashMap.
+template <class T>
+class FrameArenaTypedAllocator {
+public:
+	template <class... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_placement(FrameArena::alloc(sizeof(T)), T(p_args...)); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		p_allocation->~T();
+		FrameArena::free(p_allocation);
+	}
+};
+
+template <class T, class U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, false, FrameArenaAllocator>;
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+using FrameHashMap = HashMap<TKey, TValue, Hasher, Comparator, FrameArenaTypedAllocator<HashMapElement<TKey, TValue>>>;
+
+#endif // FRAME_ARENA_H
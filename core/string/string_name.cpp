@@ -40,6 +40,8 @@ StaticCString StaticCString::create(const char *p_ptr) {
 }
 
 StringName::_Data *StringName::_table[STRING_TABLE_LEN];
+RWLock StringName::_table_locks[STRING_TABLE_LOCK_COUNT];
+SafeNumeric<uint64_t> StringName::insertion_count;
 
 StringName _scs_create(const char *p_chr, bool p_static) {
 	return (p_chr[0] ? StringName(StaticCString::create(p_chr), p_static) : StringName());
@@ -80,10 +82,10 @@ void StringName::cleanup() {
 		int unreferenced_stringnames = 0;
 		int rarely_referenced_stringnames = 0;
 		for (int i = 0; i < data.size(); i++) {
-			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references));
-			if (data[i]->debug_references == 0) {
+			print_line(itos(i + 1) + ": " + data[i]->get_name() + " - " + itos(data[i]->debug_references.get()));
+			if (data[i]->debug_references.get() == 0) {
 				unreferenced_stringnames += 1;
-			} else if (data[i]->debug_references < 5) {
+			} else if (data[i]->debug_references.get() < 5) {
 				rarely_referenced_stringnames += 1;
 			}
 		}
@@ -120,7 +122,7 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(mutex);
+		RWLockWrite lock(_get_table_lock(_data->idx));
 
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			if (_data->cname) {
@@ -207,6 +209,62 @@ void StringName::assign_static_unique_class_name(StringName *ptr, const char *p_
 	mutex.unlock();
 }
 
+template <class T>
+StringName::_Data *StringName::_find_and_ref(const T &p_name, uint32_t p_hash, uint32_t p_idx, bool p_static) {
+	// Must be called with the bucket lock held, for either reading or writing.
+	_Data *data = _table[p_idx];
+
+	while (data) {
+		// compare hash first
+		if (data->hash == p_hash && data->get_name() == p_name) {
+			break;
+		}
+		data = data->next;
+	}
+
+	// A name whose count already dropped to zero is being removed, treat it as missing.
+	if (!data || !data->refcount.ref()) {
+		return nullptr;
+	}
+
+	if (p_static) {
+		data->static_count.increment();
+	}
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		data->debug_references.increment();
+	}
+#endif
+	return data;
+}
+
+StringName::_Data *StringName::_insert(uint32_t p_hash, uint32_t p_idx, bool p_static) {
+	// Must be called with the bucket lock held for writing.
+	insertion_count.increment();
+
+	_Data *data = memnew(_Data);
+	data->refcount.init();
+	data->static_count.set(p_static ? 1 : 0);
+	data->hash = p_hash;
+	data->idx = p_idx;
+	data->cname = nullptr;
+	data->next = _table[p_idx];
+	data->prev = nullptr;
+
+#ifdef DEBUG_ENABLED
+	if (unlikely(debug_stringname)) {
+		// Keep in memory, force static.
+		data->refcount.ref();
+		data->static_count.increment();
+	}
+#endif
+	if (_table[p_idx]) {
+		_table[p_idx]->prev = data;
+	}
+	_table[p_idx] = data;
+	return data;
+}
+
 StringName::StringName(const char *p_name, bool p_static) {
 	_data = nullptr;
 
@@ -216,56 +274,27 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
+	{
+		RWLockRead lock(_get_table_lock(idx));
+		_data = _find_and_ref(p_name, hash, idx, p_static);
 	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	if (_data) {
 		return;
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
+	RWLockWrite lock(_get_table_lock(idx));
 
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	// Another thread may have inserted it while unlocked.
+	_data = _find_and_ref(p_name, hash, idx, p_static);
+	if (_data) {
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _insert(hash, idx, p_static);
+	_data->name = p_name;
 }
 
 StringName::StringName(const StaticCString &p_static_string, bool p_static) {
@@ -275,55 +304,27 @@ StringName::StringName(const StaticCString &p_static_string, bool p_static) {
 
 	ERR_FAIL_COND(!p_static_string.ptr || !p_static_string.ptr[0]);
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_static_string.ptr);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_static_string.ptr) {
-			break;
-		}
-		_data = _data->next;
+	{
+		RWLockRead lock(_get_table_lock(idx));
+		_data = _find_and_ref(p_static_string.ptr, hash, idx, p_static);
 	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	if (_data) {
 		return;
 	}
 
-	_data = memnew(_Data);
+	RWLockWrite lock(_get_table_lock(idx));
 
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = p_static_string.ptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	// Another thread may have inserted it while unlocked.
+	_data = _find_and_ref(p_static_string.ptr, hash, idx, p_static);
+	if (_data) {
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _insert(hash, idx, p_static);
+	_data->cname = p_static_string.ptr;
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -335,54 +336,27 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_data = _table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
+	{
+		RWLockRead lock(_get_table_lock(idx));
+		_data = _find_and_ref(p_name, hash, idx, p_static);
 	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
+	if (_data) {
 		return;
 	}
 
-	_data = memnew(_Data);
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->idx = idx;
-	_data->cname = nullptr;
-	_data->next = _table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
+	RWLockWrite lock(_get_table_lock(idx));
 
-	if (_table[idx]) {
-		_table[idx]->prev = _data;
+	// Another thread may have inserted it while unlocked.
+	_data = _find_and_ref(p_name, hash, idx, p_static);
+	if (_data) {
+		return;
 	}
-	_table[idx] = _data;
+
+	_data = _insert(hash, idx, p_static);
+	_data->name = p_name;
 }
 
 StringName StringName::search(const char *p_name) {
@@ -393,32 +367,13 @@ StringName StringName::search(const char *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
+	RWLockRead lock(_get_table_lock(idx));
+	_Data *_data = _find_and_ref(p_name, hash, idx, false);
 
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-
-		return StringName(_data);
-	}
-
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 StringName StringName::search(const char32_t *p_name) {
@@ -429,58 +384,25 @@ StringName StringName::search(const char32_t *p_name) {
 		return StringName();
 	}
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = String::hash(p_name);
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->get_name() == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		return StringName(_data);
-	}
+	RWLockRead lock(_get_table_lock(idx));
+	_Data *_data = _find_and_ref(p_name, hash, idx, false);
 
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 StringName StringName::search(const String &p_name) {
 	ERR_FAIL_COND_V(p_name.is_empty(), StringName());
 
-	MutexLock lock(mutex);
-
 	uint32_t hash = p_name.hash();
-
 	uint32_t idx = hash & STRING_TABLE_MASK;
 
-	_Data *_data = _table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && p_name == _data->get_name()) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return StringName(_data);
-	}
+	RWLockRead lock(_get_table_lock(idx));
+	_Data *_data = _find_and_ref(p_name, hash, idx, false);
 
-	return StringName(); //does not exist
+	return _data ? StringName(_data) : StringName();
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
@@ -32,6 +32,7 @@
 #define STRING_NAME_H
 
 #include "core/os/mutex.h"
+#include "core/os/rw_lock.h"
 #include "core/string/ustring.h"
 #include "core/templates/safe_refcount.h"
 
@@ -48,7 +49,10 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_LOCK_BITS = 6,
+		STRING_TABLE_LOCK_COUNT = 1 << STRING_TABLE_LOCK_BITS,
+		STRING_TABLE_LOCK_MASK = STRING_TABLE_LOCK_COUNT - 1
 	};
 
 	struct _Data {
@@ -57,7 +61,7 @@ class StringName {
 		const char *cname = nullptr;
 		String name;
 #ifdef DEBUG_ENABLED
-		uint32_t debug_references = 0;
+		SafeNumeric<uint32_t> debug_references;
 #endif
 		String get_name() const { return cname ? String(cname) : name; }
 		int idx = 0;
@@ -68,6 +72,15 @@ class StringName {
 	};
 
 	static _Data *_table[STRING_TABLE_LEN];
+	// Buckets are guarded by striped locks, so lookups only ever wait for insertions
+	// or removals in the same stripe, never for other lookups.
+	static RWLock _table_locks[STRING_TABLE_LOCK_COUNT];
+	static SafeNumeric<uint64_t> insertion_count;
+
+	static _FORCE_INLINE_ RWLock &_get_table_lock(uint32_t p_idx) { return _table_locks[p_idx & STRING_TABLE_LOCK_MASK]; }
+	template <class T>
+	static _Data *_find_and_ref(const T &p_name, uint32_t p_hash, uint32_t p_idx, bool p_static);
+	static _Data *_insert(uint32_t p_hash, uint32_t p_idx, bool p_static);
 
 	_Data *_data = nullptr;
 
@@ -87,7 +100,7 @@ class StringName {
 #ifdef DEBUG_ENABLED
 	struct DebugSortReferences {
 		bool operator()(const _Data *p_left, const _Data *p_right) const {
-			return p_left->debug_references > p_right->debug_references;
+			return p_left->debug_references.get() > p_right->debug_references.get();
 		}
 	};
 
@@ -159,6 +172,9 @@ public:
 	static StringName search(const char32_t *p_name);
 	static StringName search(const String &p_name);
 
+	// Number of times a name was not interned yet and had to be inserted (the slow path).
+	static uint64_t get_insertion_count() { return insertion_count.get(); }
+
 	struct AlphCompare {
 		_FORCE_INLINE_ bool operator()(const StringName &l, const StringName &r) const {
 			const char *l_cname = l._data ? l._data->cname : "";
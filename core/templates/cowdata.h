@@ -33,11 +33,16 @@
 
 #include "core/error/error_macros.h"
 #include "core/os/memory.h"
+#include "core/templates/cowdata_audit.h"
 #include "core/templates/safe_refcount.h"
 
 #include <string.h>
 #include <type_traits>
 
+#ifdef COWDATA_AUDIT_ENABLED
+#include <typeinfo>
+#endif
+
 template <class T>
 class Vector;
 class String;
@@ -142,13 +147,15 @@ private:
 	void _unref(void *p_data);
 	void _ref(const CowData *p_from);
 	void _ref(const CowData &p_from);
-	USize _copy_on_write();
+	USize _copy_on_write(const void *p_caller = nullptr);
+	template <bool p_ensure_zero>
+	Error _resize(Size p_size, const void *p_caller);
 
 public:
 	void operator=(const CowData<T> &p_from) { _ref(p_from); }
 
-	_FORCE_INLINE_ T *ptrw() {
-		_copy_on_write();
+	COWDATA_AUDIT_ENTRY T *ptrw() {
+		_copy_on_write(COWDATA_AUDIT_CALLER());
 		return _ptr;
 	}
 
@@ -168,15 +175,15 @@ public:
 	_FORCE_INLINE_ void clear() { resize(0); }
 	_FORCE_INLINE_ bool is_empty() const { return _ptr == nullptr; }
 
-	_FORCE_INLINE_ void set(Size p_index, const T &p_elem) {
+	COWDATA_AUDIT_ENTRY void set(Size p_index, const T &p_elem) {
 		ERR_FAIL_INDEX(p_index, size());
-		_copy_on_write();
+		_copy_on_write(COWDATA_AUDIT_CALLER());
 		_ptr[p_index] = p_elem;
 	}
 
-	_FORCE_INLINE_ T &get_m(Size p_index) {
+	COWDATA_AUDIT_ENTRY T &get_m(Size p_index) {
 		CRASH_BAD_INDEX(p_index, size());
-		_copy_on_write();
+		_copy_on_write(COWDATA_AUDIT_CALLER());
 		return _ptr[p_index];
 	}
 
@@ -187,26 +194,32 @@ public:
 	}
 
 	template <bool p_ensure_zero = false>
-	Error resize(Size p_size);
+	COWDATA_AUDIT_NO_INLINE Error resize(Size p_size) {
+		return _resize<p_ensure_zero>(p_size, COWDATA_AUDIT_CALLER());
+	}
 
-	_FORCE_INLINE_ void remove_at(Size p_index) {
+	COWDATA_AUDIT_ENTRY void remove_at(Size p_index) {
 		ERR_FAIL_INDEX(p_index, size());
-		T *p = ptrw();
+		const void *caller = COWDATA_AUDIT_CALLER();
+		_copy_on_write(caller);
+		T *p = _ptr;
 		Size len = size();
 		for (Size i = p_index; i < len - 1; i++) {
 			p[i] = p[i + 1];
 		}
 
-		resize(len - 1);
+		_resize<false>(len - 1, caller);
 	}
 
-	Error insert(Size p_pos, const T &p_val) {
+	COWDATA_AUDIT_NO_INLINE Error insert(Size p_pos, const T &p_val) {
 		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
-		resize(size() + 1);
+		Error err = _resize<false>(size() + 1, COWDATA_AUDIT_CALLER());
+		ERR_FAIL_COND_V(err, err);
+		// Resizing made the data unique already.
 		for (Size i = (size() - 1); i > p_pos; i--) {
-			set(i, get(i - 1));
+			_ptr[i] = _ptr[i - 1];
 		}
-		set(p_pos, p_val);
+		_ptr[p_pos] = p_val;
 
 		return OK;
 	}
@@ -248,7 +261,7 @@ void CowData<T>::_unref(void *p_data) {
 }
 
 template <class T>
-typename CowData<T>::USize CowData<T>::_copy_on_write() {
+typename CowData<T>::USize CowData<T>::_copy_on_write(const void *p_caller) {
 	if (!_ptr) {
 		return 0;
 	}
@@ -260,6 +273,10 @@ typename CowData<T>::USize CowData<T>::_copy_on_write() {
 		/* in use by more than me */
 		USize current_size = *_get_size();
 
+#ifdef COWDATA_AUDIT_ENABLED
+		CowDataAudit::record(typeid(T).name(), current_size * sizeof(T), p_caller);
+#endif
+
 		USize *mem_new = (USize *)Memory::alloc_static(_get_alloc_size(current_size) + ALLOC_PAD, false);
 		mem_new += 2;
 
@@ -288,7 +305,7 @@ typename CowData<T>::USize CowData<T>::_copy_on_write() {
 
 template <class T>
 template <bool p_ensure_zero>
-Error CowData<T>::resize(Size p_size) {
+Error CowData<T>::_resize(Size p_size, const void *p_caller) {
 	ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
 
 	Size current_size = size();
@@ -305,7 +322,7 @@ Error CowData<T>::resize(Size p_size) {
 	}
 
 	// possibly changing size, copy on write
-	USize rc = _copy_on_write();
+	USize rc = _copy_on_write(p_caller);
 
 	USize current_alloc_size = _get_alloc_size(current_size);
 	USize alloc_size;
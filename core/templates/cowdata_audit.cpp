@@ -0,0 +1,192 @@
+/**************************************************************************/
+/*  cowdata_audit.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "cowdata_audit.h"
+
+#include "core/object/script_language.h"
+#include "core/os/mutex.h"
+#include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+#if defined(COWDATA_AUDIT_ENABLED) && defined(UNIX_ENABLED)
+#include <dlfcn.h>
+#endif
+
+bool CowDataAudit::print_report_at_exit = false;
+
+#ifdef COWDATA_AUDIT_ENABLED
+
+namespace {
+
+struct CallSite {
+	const char *type = nullptr;
+	const void *caller = nullptr;
+	String script_location;
+	uint64_t count = 0;
+	uint64_t bytes = 0;
+	uint64_t max_bytes = 0;
+};
+
+struct CallSiteSort {
+	bool operator()(const CallSite *p_a, const CallSite *p_b) const {
+		return p_a->bytes > p_b->bytes;
+	}
+};
+
+SafeNumeric<uint64_t> copy_count;
+SafeNumeric<uint64_t> copied_bytes;
+
+BinaryMutex call_sites_mutex;
+// Allocated on first use, copies can happen during static initialization.
+HashMap<String, CallSite> *call_sites = nullptr;
+
+// Recording copies strings and vectors too, which must not be recorded again.
+thread_local bool recording = false;
+
+String caller_to_string(const void *p_caller) {
+#ifdef UNIX_ENABLED
+	// Show it as an offset in its module, so it can be resolved with addr2line.
+	Dl_info info;
+	if (dladdr(p_caller, &info) && info.dli_fname) {
+		String location = String(info.dli_fname).get_file() + "+0x" + String::num_uint64((uint64_t)((const uint8_t *)p_caller - (const uint8_t *)info.dli_fbase), 16);
+		if (info.dli_sname) {
+			location += " (" + String(info.dli_sname) + ")";
+		}
+		return location;
+	}
+#endif
+	return "0x" + String::num_uint64((uint64_t)p_caller, 16);
+}
+
+} // namespace
+
+#endif // COWDATA_AUDIT_ENABLED
+
+void CowDataAudit::record(const char *p_type, uint64_t p_bytes, const void *p_caller) {
+#ifdef COWDATA_AUDIT_ENABLED
+	copy_count.increment();
+	copied_bytes.add(p_bytes);
+
+	if (recording) {
+		return;
+	}
+	recording = true;
+
+	String script_location;
+	for (int i = 0; i < ScriptServer::get_language_count(); i++) {
+		Vector<ScriptLanguage::StackInfo> si = ScriptServer::get_language(i)->debug_get_current_stack_info();
+		if (si.size()) {
+			script_location = si[0].file + ":" + itos(si[0].line) + " in " + si[0].func + "()";
+			break;
+		}
+	}
+
+	String key = String::num_uint64((uint64_t)p_caller, 16) + "|" + script_location;
+
+	{
+		MutexLock lock(call_sites_mutex);
+		if (!call_sites) {
+			call_sites = memnew((HashMap<String, CallSite>));
+		}
+		CallSite *site = call_sites->getptr(key);
+		if (!site) {
+			site = &call_sites->insert(key, CallSite())->value;
+			site->type = p_type;
+			site->caller = p_caller;
+			site->script_location = script_location;
+		}
+		site->count++;
+		site->bytes += p_bytes;
+		site->max_bytes = MAX(site->max_bytes, p_bytes);
+	}
+
+	recording = false;
+#endif
+}
+
+uint64_t CowDataAudit::get_copy_count() {
+#ifdef COWDATA_AUDIT_ENABLED
+	return copy_count.get();
+#else
+	return 0;
+#endif
+}
+
+uint64_t CowDataAudit::get_copied_bytes() {
+#ifdef COWDATA_AUDIT_ENABLED
+	return copied_bytes.get();
+#else
+	return 0;
+#endif
+}
+
+void CowDataAudit::print_report() {
+#ifdef COWDATA_AUDIT_ENABLED
+	recording = true;
+
+	LocalVector<CallSite *> sites;
+	{
+		MutexLock lock(call_sites_mutex);
+		if (call_sites) {
+			for (KeyValue<String, CallSite> &E : *call_sites) {
+				sites.push_back(&E.value);
+			}
+		}
+	}
+	sites.sort_custom<CallSiteSort>();
+
+	print_line(vformat("\nCowData copy-on-write copies: %d, %s copied in total.", copy_count.get(), String::humanize_size(copied_bytes.get())));
+	print_line("Call sites, from most to least bytes copied:\n");
+	for (uint32_t i = 0; i < sites.size(); i++) {
+		const CallSite *site = sites[i];
+		String line = vformat("%d: %s - %d copies, %s total, %s largest - %s", i + 1, caller_to_string(site->caller), site->count, String::humanize_size(site->bytes), String::humanize_size(site->max_bytes), site->type);
+		if (!site->script_location.is_empty()) {
+			line += " - " + site->script_location;
+		}
+		print_line(line);
+	}
+
+	recording = false;
+#else
+	print_line("CowData copies are only recorded when building with `cowdata_audit=yes`.");
+#endif
+}
+
+void CowDataAudit::cleanup() {
+#ifdef COWDATA_AUDIT_ENABLED
+	recording = true; // Stop recording, strings are freed here.
+	MutexLock lock(call_sites_mutex);
+	if (call_sites) {
+		memdelete(call_sites);
+		call_sites = nullptr;
+	}
+#endif
+}
@@ -0,0 +1,75 @@
+/**************************************************************************/
+/*  cowdata_audit.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef COWDATA_AUDIT_H
+#define COWDATA_AUDIT_H
+
+#include "core/typedefs.h"
+
+// Keeps track of the copies made by CowData when writing to shared data, which are
+// easy to trigger by accident and can be very expensive for big arrays.
+// Only recorded when building with `cowdata_audit=yes` (COWDATA_AUDIT_ENABLED).
+class CowDataAudit {
+	static bool print_report_at_exit;
+
+public:
+	// Called by CowData on every copy, p_caller is the code address that requested write access.
+	static void record(const char *p_type, uint64_t p_bytes, const void *p_caller);
+
+	static uint64_t get_copy_count();
+	static uint64_t get_copied_bytes();
+
+	// Prints every call site that caused copies, sorted by the total amount of bytes copied.
+	static void print_report();
+	static void set_print_report_at_exit(bool p_enable) { print_report_at_exit = p_enable; }
+	static bool is_print_report_at_exit_enabled() { return print_report_at_exit; }
+
+	static void cleanup();
+};
+
+#ifdef COWDATA_AUDIT_ENABLED
+// The CowData members that can copy are kept out of line and capture their own return address,
+// which points to the code requesting write access; internal calls pass it along.
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define COWDATA_AUDIT_CALLER() _ReturnAddress()
+#define COWDATA_AUDIT_NO_INLINE __declspec(noinline)
+#else
+#define COWDATA_AUDIT_CALLER() __builtin_return_address(0)
+#define COWDATA_AUDIT_NO_INLINE __attribute__((noinline))
+#endif
+#define COWDATA_AUDIT_ENTRY COWDATA_AUDIT_NO_INLINE
+#else
+#define COWDATA_AUDIT_CALLER() nullptr
+#define COWDATA_AUDIT_NO_INLINE
+#define COWDATA_AUDIT_ENTRY _FORCE_INLINE_
+#endif
+
+#endif // COWDATA_AUDIT_H
@@ -0,0 +1,565 @@
+/**************************************************************************/
+/*  group_hash_map.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GROUP_HASH_MAP_H
+#define GROUP_HASH_MAP_H
+
+#include "core/os/memory.h"
+#include "core/templates/hash_group.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+/**
+ * A HashMap with the same API as HashMap, but using Swiss-table style open
+ * addressing: every slot has a control byte holding 7 bits of the hash, and
+ * probing compares a whole group of them at once (see HashGroup). Most lookups
+ * only touch one group of control bytes and one element, which makes it faster
+ * than HashMap for big, lookup-heavy maps.
+ *
+ * As in HashMap, keys and values are stored in a double linked list by
+ * insertion order, so iteration order and iterator stability are the same.
+ *
+ * Capacity is a power of two multiple of the group width, and the table grows
+ * when 7/8 of the slots are used (counting the ones left by erased elements).
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>,
+		class Allocator = DefaultTypedAllocator<HashMapElement<TKey, TValue>>>
+class GroupHashMap {
+public:
+	static constexpr uint32_t MIN_CAPACITY = HashGroup::WIDTH;
+	static constexpr uint32_t MAX_CAPACITY = 1u << 31;
+
+private:
+	Allocator element_alloc;
+	HashMapElement<TKey, TValue> **elements = nullptr;
+	uint8_t *ctrl = nullptr;
+	HashMapElement<TKey, TValue> *head_element = nullptr;
+	HashMapElement<TKey, TValue> *tail_element = nullptr;
+
+	uint32_t capacity = MIN_CAPACITY;
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty slots that can still be used before having to rehash.
+
+	static _FORCE_INLINE_ uint32_t _get_growth_limit(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	bool _lookup_pos_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (ctrl == nullptr || num_elements == 0) {
+			return false; // Failed lookups, no elements
+		}
+
+		const uint8_t h2 = p_hash & HashGroup::H2_MASK;
+		const uint32_t group_mask = capacity / HashGroup::WIDTH - 1;
+		uint32_t group = (p_hash >> HashGroup::H1_SHIFT) & group_mask;
+
+		// Triangular probing visits every group when their amount is a power of two.
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * HashGroup::WIDTH;
+			const HashGroup g(ctrl + base);
+
+			for (HashGroup::Mask m = g.match(h2); m; m.clear_lowest()) {
+				const uint32_t pos = base + m.lowest();
+				if (Comparator::compare(elements[pos]->data.key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+			}
+
+			if (g.match_empty()) {
+				return false;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		return _lookup_pos_with_hash(p_key, Hasher::hash(p_key), r_pos);
+	}
+
+	// The key must not be in the map already and there must be room for it.
+	void _insert_with_hash(uint32_t p_hash, HashMapElement<TKey, TValue> *p_value) {
+		const uint32_t group_mask = capacity / HashGroup::WIDTH - 1;
+		uint32_t group = (p_hash >> HashGroup::H1_SHIFT) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * HashGroup::WIDTH;
+			HashGroup::Mask m = HashGroup(ctrl + base).match_empty_or_deleted();
+			if (m) {
+				const uint32_t pos = base + m.lowest();
+				if (ctrl[pos] == HashGroup::CTRL_EMPTY) {
+					growth_left--;
+				}
+				ctrl[pos] = p_hash & HashGroup::H2_MASK;
+				elements[pos] = p_value;
+				num_elements++;
+				return;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _erase_slot(uint32_t p_pos) {
+		// If the group still has an empty slot, no probe sequence ever went past it,
+		// so this slot can become empty again. Otherwise, it must be kept as a tombstone.
+		if (HashGroup(ctrl + (p_pos & ~(HashGroup::WIDTH - 1))).match_empty()) {
+			ctrl[p_pos] = HashGroup::CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[p_pos] = HashGroup::CTRL_DELETED;
+		}
+		elements[p_pos] = nullptr;
+		num_elements--;
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = reinterpret_cast<uint8_t *>(Memory::alloc_static(sizeof(uint8_t) * capacity));
+		elements = reinterpret_cast<HashMapElement<TKey, TValue> **>(Memory::alloc_static(sizeof(HashMapElement<TKey, TValue> *) * capacity));
+		memset(ctrl, HashGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_growth_limit(capacity);
+		num_elements = 0;
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		uint32_t old_capacity = capacity;
+		uint8_t *old_ctrl = ctrl;
+		HashMapElement<TKey, TValue> **old_elements = elements;
+
+		_allocate(MAX(p_new_capacity, MIN_CAPACITY));
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] & HashGroup::CTRL_EMPTY) {
+				continue; // Empty or deleted.
+			}
+			_insert_with_hash(Hasher::hash(old_elements[i]->data.key), old_elements[i]);
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_elements);
+	}
+
+	static uint32_t _get_capacity_for(uint32_t p_elements) {
+		uint32_t new_capacity = MIN_CAPACITY;
+		while (_get_growth_limit(new_capacity) < p_elements) {
+			ERR_FAIL_COND_V_MSG(new_capacity == MAX_CAPACITY, MAX_CAPACITY, "Hash table maximum capacity reached.");
+			new_capacity <<= 1;
+		}
+		return new_capacity;
+	}
+
+	_FORCE_INLINE_ HashMapElement<TKey, TValue> *_insert(const TKey &p_key, const TValue &p_value, bool p_front_insert = false) {
+		if (unlikely(ctrl == nullptr)) {
+			// Allocate on demand to save memory.
+			_allocate(capacity);
+		}
+
+		uint32_t hash = Hasher::hash(p_key);
+		uint32_t pos = 0;
+		bool exists = _lookup_pos_with_hash(p_key, hash, pos);
+
+		if (exists) {
+			elements[pos]->data.value = p_value;
+			return elements[pos];
+		} else {
+			if (growth_left == 0) {
+				// Grow if really full, otherwise just rehash in place to get rid of tombstones.
+				uint32_t new_capacity = capacity;
+				if (num_elements + 1 > _get_growth_limit(capacity) / 2) {
+					ERR_FAIL_COND_V_MSG(capacity == MAX_CAPACITY, nullptr, "Hash table maximum capacity reached, aborting insertion.");
+					new_capacity <<= 1;
+				}
+				_resize_and_rehash(new_capacity);
+			}
+
+			HashMapElement<TKey, TValue> *elem = element_alloc.new_allocation(HashMapElement<TKey, TValue>(p_key, p_value));
+
+			if (tail_element == nullptr) {
+				head_element = elem;
+				tail_element = elem;
+			} else if (p_front_insert) {
+				head_element->prev = elem;
+				elem->next = head_element;
+				head_element = elem;
+			} else {
+				tail_element->next = elem;
+				elem->prev = tail_element;
+				tail_element = elem;
+			}
+
+			_insert_with_hash(hash, elem);
+			return elem;
+		}
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (ctrl == nullptr || num_elements == 0) {
+			return;
+		}
+
+		HashMapElement<TKey, TValue> *E = head_element;
+		while (E) {
+			HashMapElement<TKey, TValue> *next = E->next;
+			element_alloc.delete_allocation(E);
+			E = next;
+		}
+
+		memset(ctrl, HashGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_growth_limit(capacity);
+		tail_element = nullptr;
+		head_element = nullptr;
+		num_elements = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "GroupHashMap key not found.");
+		return elements[pos]->data.value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "GroupHashMap key not found.");
+		return elements[pos]->data.value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &elements[pos]->data.value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &elements[pos]->data.value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+
+		if (!exists) {
+			return false;
+		}
+
+		HashMapElement<TKey, TValue> *element = elements[pos];
+		_erase_slot(pos);
+
+		if (head_element == element) {
+			head_element = element->next;
+		}
+
+		if (tail_element == element) {
+			tail_element = element->prev;
+		}
+
+		if (element->prev) {
+			element->prev->next = element->next;
+		}
+
+		if (element->next) {
+			element->next->prev = element->prev;
+		}
+
+		element_alloc.delete_allocation(element);
+		return true;
+	}
+
+	// Replace the key of an entry in-place, without invalidating iterators or changing the entries position during iteration.
+	// p_old_key must exist in the map and p_new_key must not, unless it is equal to p_old_key.
+	bool replace_key(const TKey &p_old_key, const TKey &p_new_key) {
+		if (p_old_key == p_new_key) {
+			return true;
+		}
+		uint32_t pos = 0;
+		ERR_FAIL_COND_V(_lookup_pos(p_new_key, pos), false);
+		ERR_FAIL_COND_V(!_lookup_pos(p_old_key, pos), false);
+		HashMapElement<TKey, TValue> *element = elements[pos];
+
+		_erase_slot(pos);
+		if (growth_left == 0) {
+			_resize_and_rehash(capacity);
+		}
+
+		// Update the HashMapElement with the new key and reinsert it.
+		const_cast<TKey &>(element->data.key) = p_new_key;
+		_insert_with_hash(Hasher::hash(p_new_key), element);
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// If adding a known (possibly large) number of elements at once, must be larger than old capacity.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = _get_capacity_for(p_new_capacity);
+
+		if (new_capacity <= capacity) {
+			return;
+		}
+
+		if (ctrl == nullptr) {
+			capacity = new_capacity;
+			return; // Unallocated yet.
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return E->data;
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (E) {
+				E = E->next;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			if (E) {
+				E = E->prev;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return E != nullptr;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const HashMapElement<TKey, TValue> *p_E) { E = p_E; }
+		_FORCE_INLINE_ ConstIterator() {}
+		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_it) { E = p_it.E; }
+		_FORCE_INLINE_ void operator=(const ConstIterator &p_it) {
+			E = p_it.E;
+		}
+
+	private:
+		const HashMapElement<TKey, TValue> *E = nullptr;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return E->data;
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &E->data; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (E) {
+				E = E->next;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (E) {
+				E = E->prev;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return E == b.E; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return E != b.E; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return E != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(HashMapElement<TKey, TValue> *p_E) { E = p_E; }
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) { E = p_it.E; }
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			E = p_it.E;
+		}
+
+		operator ConstIterator() const {
+			return ConstIterator(E);
+		}
+
+	private:
+		HashMapElement<TKey, TValue> *E = nullptr;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(head_element);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(nullptr);
+	}
+	_FORCE_INLINE_ Iterator last() {
+		return Iterator(tail_element);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(elements[pos]);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(head_element);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(nullptr);
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		return ConstIterator(tail_element);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return ConstIterator(elements[pos]);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return elements[pos]->data.value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return _insert(p_key, TValue())->data.value;
+		} else {
+			return elements[pos]->data.value;
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value, bool p_front_insert = false) {
+		return Iterator(_insert(p_key, p_value, p_front_insert));
+	}
+
+	/* Constructors */
+
+	GroupHashMap(const GroupHashMap &p_other) {
+		reserve(p_other.num_elements);
+
+		if (p_other.num_elements == 0) {
+			return;
+		}
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const GroupHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		if (num_elements != 0) {
+			clear();
+		}
+
+		reserve(p_other.num_elements);
+
+		if (p_other.ctrl == nullptr) {
+			return; // Nothing to copy.
+		}
+
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	GroupHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	GroupHashMap() {}
+
+	~GroupHashMap() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(elements);
+		}
+	}
+};
+
+#endif // GROUP_HASH_MAP_H
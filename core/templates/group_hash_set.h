@@ -0,0 +1,427 @@
+/**************************************************************************/
+/*  group_hash_set.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GROUP_HASH_SET_H
+#define GROUP_HASH_SET_H
+
+#include "core/os/memory.h"
+#include "core/templates/hash_group.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hashfuncs.h"
+
+/**
+ * A HashSet with the same API as HashSet, but using Swiss-table style group
+ * probing (see GroupHashMap and HashGroup).
+ *
+ * As in HashSet, keys are kept packed in a single array, so iteration is
+ * linear and erasing moves the last key into the erased one's place.
+ */
+
+template <class TKey,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class GroupHashSet {
+public:
+	static constexpr uint32_t MIN_CAPACITY = HashGroup::WIDTH;
+	static constexpr uint32_t MAX_CAPACITY = 1u << 31;
+
+private:
+	TKey *keys = nullptr;
+	uint32_t *slot_to_key = nullptr;
+	uint32_t *key_to_slot = nullptr;
+	uint8_t *ctrl = nullptr;
+
+	uint32_t capacity = MIN_CAPACITY;
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty slots that can still be used before having to rehash.
+
+	static _FORCE_INLINE_ uint32_t _get_growth_limit(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	// Returns the slot, not the key index.
+	bool _lookup_slot_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_slot) const {
+		if (keys == nullptr || num_elements == 0) {
+			return false; // Failed lookups, no elements
+		}
+
+		const uint8_t h2 = p_hash & HashGroup::H2_MASK;
+		const uint32_t group_mask = capacity / HashGroup::WIDTH - 1;
+		uint32_t group = (p_hash >> HashGroup::H1_SHIFT) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * HashGroup::WIDTH;
+			const HashGroup g(ctrl + base);
+
+			for (HashGroup::Mask m = g.match(h2); m; m.clear_lowest()) {
+				const uint32_t slot = base + m.lowest();
+				if (Comparator::compare(keys[slot_to_key[slot]], p_key)) {
+					r_slot = slot;
+					return true;
+				}
+			}
+
+			if (g.match_empty()) {
+				return false;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		uint32_t slot = 0;
+		if (_lookup_slot_with_hash(p_key, Hasher::hash(p_key), slot)) {
+			r_pos = slot_to_key[slot];
+			return true;
+		}
+		return false;
+	}
+
+	void _insert_with_hash(uint32_t p_hash, uint32_t p_index) {
+		const uint32_t group_mask = capacity / HashGroup::WIDTH - 1;
+		uint32_t group = (p_hash >> HashGroup::H1_SHIFT) & group_mask;
+
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * HashGroup::WIDTH;
+			HashGroup::Mask m = HashGroup(ctrl + base).match_empty_or_deleted();
+			if (m) {
+				const uint32_t slot = base + m.lowest();
+				if (ctrl[slot] == HashGroup::CTRL_EMPTY) {
+					growth_left--;
+				}
+				ctrl[slot] = p_hash & HashGroup::H2_MASK;
+				slot_to_key[slot] = p_index;
+				key_to_slot[p_index] = slot;
+				return;
+			}
+
+			group = (group + step) & group_mask;
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		capacity = MAX(p_new_capacity, MIN_CAPACITY);
+
+		Memory::free_static(ctrl);
+		Memory::free_static(slot_to_key);
+
+		ctrl = reinterpret_cast<uint8_t *>(Memory::alloc_static(sizeof(uint8_t) * capacity));
+		slot_to_key = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
+		keys = reinterpret_cast<TKey *>(Memory::realloc_static(keys, sizeof(TKey) * capacity));
+		key_to_slot = reinterpret_cast<uint32_t *>(Memory::realloc_static(key_to_slot, sizeof(uint32_t) * capacity));
+
+		memset(ctrl, HashGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_growth_limit(capacity);
+
+		for (uint32_t i = 0; i < num_elements; i++) {
+			_insert_with_hash(Hasher::hash(keys[i]), i);
+		}
+	}
+
+	void _allocate() {
+		ctrl = reinterpret_cast<uint8_t *>(Memory::alloc_static(sizeof(uint8_t) * capacity));
+		keys = reinterpret_cast<TKey *>(Memory::alloc_static(sizeof(TKey) * capacity));
+		slot_to_key = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
+		key_to_slot = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
+
+		memset(ctrl, HashGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_growth_limit(capacity);
+	}
+
+	void _free() {
+		if (keys != nullptr) {
+			Memory::free_static(keys);
+			Memory::free_static(key_to_slot);
+			Memory::free_static(slot_to_key);
+			Memory::free_static(ctrl);
+			keys = nullptr;
+			ctrl = nullptr;
+			slot_to_key = nullptr;
+			key_to_slot = nullptr;
+		}
+	}
+
+	_FORCE_INLINE_ int32_t _insert(const TKey &p_key) {
+		if (unlikely(keys == nullptr)) {
+			// Allocate on demand to save memory.
+			_allocate();
+		}
+
+		uint32_t hash = Hasher::hash(p_key);
+		uint32_t slot = 0;
+		bool exists = _lookup_slot_with_hash(p_key, hash, slot);
+
+		if (exists) {
+			return slot_to_key[slot];
+		} else {
+			if (growth_left == 0) {
+				// Grow if really full, otherwise just rehash in place to get rid of tombstones.
+				uint32_t new_capacity = capacity;
+				if (num_elements + 1 > _get_growth_limit(capacity) / 2) {
+					ERR_FAIL_COND_V_MSG(capacity == MAX_CAPACITY, -1, "Hash table maximum capacity reached, aborting insertion.");
+					new_capacity <<= 1;
+				}
+				_resize_and_rehash(new_capacity);
+			}
+
+			memnew_placement(&keys[num_elements], TKey(p_key));
+			_insert_with_hash(hash, num_elements);
+			num_elements++;
+			return num_elements - 1;
+		}
+	}
+
+	void _init_from(const GroupHashSet &p_other) {
+		capacity = p_other.capacity;
+		num_elements = p_other.num_elements;
+
+		if (p_other.num_elements == 0) {
+			return;
+		}
+
+		_allocate();
+
+		for (uint32_t i = 0; i < num_elements; i++) {
+			memnew_placement(&keys[i], TKey(p_other.keys[i]));
+			key_to_slot[i] = p_other.key_to_slot[i];
+		}
+
+		memcpy(ctrl, p_other.ctrl, sizeof(uint8_t) * capacity);
+		memcpy(slot_to_key, p_other.slot_to_key, sizeof(uint32_t) * capacity);
+		growth_left = p_other.growth_left;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (keys == nullptr || num_elements == 0) {
+			return;
+		}
+		memset(ctrl, HashGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_growth_limit(capacity);
+		for (uint32_t i = 0; i < num_elements; i++) {
+			keys[i].~TKey();
+		}
+
+		num_elements = 0;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t slot = 0;
+		bool exists = _lookup_slot_with_hash(p_key, Hasher::hash(p_key), slot);
+
+		if (!exists) {
+			return false;
+		}
+
+		uint32_t key_pos = slot_to_key[slot];
+
+		// See GroupHashMap::_erase_slot().
+		if (HashGroup(ctrl + (slot & ~(HashGroup::WIDTH - 1))).match_empty()) {
+			ctrl[slot] = HashGroup::CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[slot] = HashGroup::CTRL_DELETED;
+		}
+
+		keys[key_pos].~TKey();
+		num_elements--;
+		if (key_pos < num_elements) {
+			// Not the last key, move the last one here to keep keys lineal
+			memnew_placement(&keys[key_pos], TKey(keys[num_elements]));
+			keys[num_elements].~TKey();
+			key_to_slot[key_pos] = key_to_slot[num_elements];
+			slot_to_key[key_to_slot[num_elements]] = key_pos;
+		}
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// If adding a known (possibly large) number of elements at once, must be larger than old capacity.
+	void reserve(uint32_t p_new_capacity) {
+		uint32_t new_capacity = capacity;
+		while (_get_growth_limit(new_capacity) < p_new_capacity) {
+			ERR_FAIL_COND_MSG(new_capacity == MAX_CAPACITY, "Hash table maximum capacity reached.");
+			new_capacity <<= 1;
+		}
+
+		if (new_capacity == capacity) {
+			return;
+		}
+
+		if (keys == nullptr) {
+			capacity = new_capacity;
+			return; // Unallocated yet.
+		}
+		_resize_and_rehash(new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct Iterator {
+		_FORCE_INLINE_ const TKey &operator*() const {
+			return keys[index];
+		}
+		_FORCE_INLINE_ const TKey *operator->() const {
+			return &keys[index];
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			index++;
+			if (index >= (int32_t)num_keys) {
+				index = -1;
+				keys = nullptr;
+				num_keys = 0;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			index--;
+			if (index < 0) {
+				index = -1;
+				keys = nullptr;
+				num_keys = 0;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return keys == b.keys && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return keys != b.keys || index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return keys != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(const TKey *p_keys, uint32_t p_num_keys, int32_t p_index = -1) {
+			keys = p_keys;
+			num_keys = p_num_keys;
+			index = p_index;
+		}
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) {
+			keys = p_it.keys;
+			num_keys = p_it.num_keys;
+			index = p_it.index;
+		}
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			keys = p_it.keys;
+			num_keys = p_it.num_keys;
+			index = p_it.index;
+		}
+
+	private:
+		const TKey *keys = nullptr;
+		uint32_t num_keys = 0;
+		int32_t index = -1;
+	};
+
+	_FORCE_INLINE_ Iterator begin() const {
+		return num_elements ? Iterator(keys, num_elements, 0) : Iterator();
+	}
+	_FORCE_INLINE_ Iterator end() const {
+		return Iterator();
+	}
+	_FORCE_INLINE_ Iterator last() const {
+		if (num_elements == 0) {
+			return Iterator();
+		}
+		return Iterator(keys, num_elements, num_elements - 1);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(keys, num_elements, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(*p_iter);
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key) {
+		uint32_t pos = _insert(p_key);
+		return Iterator(keys, num_elements, pos);
+	}
+
+	/* Constructors */
+
+	GroupHashSet(const GroupHashSet &p_other) {
+		_init_from(p_other);
+	}
+
+	void operator=(const GroupHashSet &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+
+		clear();
+		_free();
+		_init_from(p_other);
+	}
+
+	GroupHashSet(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	GroupHashSet() {}
+
+	void reset() {
+		clear();
+		_free();
+		capacity = MIN_CAPACITY;
+	}
+
+	~GroupHashSet() {
+		clear();
+		_free();
+	}
+};
+
+#endif // GROUP_HASH_SET_H
@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*  hash_group.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef HASH_GROUP_H
+#define HASH_GROUP_H
+
+#include "core/typedefs.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_GROUP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define HASH_GROUP_NEON
+#include <arm_neon.h>
+#endif
+
+#include <string.h>
+
+/**
+ * Control-byte group matching for the Swiss-table style containers
+ * (GroupHashMap, GroupHashSet).
+ *
+ * Every slot of the table has a control byte: either CTRL_EMPTY, CTRL_DELETED,
+ * or the lowest 7 bits of the hash of the element stored there (its top bit is
+ * always 0 in that case). Probing loads a whole group of control bytes at once
+ * and compares all of them in parallel, with SSE2 or NEON when available (groups
+ * of 16) or with plain 64-bit arithmetic otherwise (groups of 8).
+ */
+
+_FORCE_INLINE_ uint32_t hash_group_count_trailing_zeros(uint64_t p_value) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(p_value);
+#else
+	uint32_t count = 0;
+	while (!(p_value & 1)) {
+		p_value >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+class HashGroup {
+public:
+	static constexpr uint8_t CTRL_EMPTY = 0x80;
+	static constexpr uint8_t CTRL_DELETED = 0xFE;
+	static constexpr uint32_t H2_MASK = 0x7F;
+	static constexpr uint32_t H1_SHIFT = 7;
+
+#if defined(HASH_GROUP_SSE2) || defined(HASH_GROUP_NEON)
+	static constexpr uint32_t WIDTH = 16;
+#else
+	static constexpr uint32_t WIDTH = 8;
+#endif
+
+	// Set of slots in a group, iterated from the lowest one.
+	class Mask {
+#if defined(HASH_GROUP_SSE2)
+		static constexpr uint32_t SHIFT = 0; // One bit per slot.
+#elif defined(HASH_GROUP_NEON)
+		static constexpr uint32_t SHIFT = 2; // One bit per 4-bit lane.
+#else
+		static constexpr uint32_t SHIFT = 3; // One bit per byte.
+#endif
+		uint64_t mask = 0;
+
+	public:
+		_FORCE_INLINE_ explicit operator bool() const { return mask != 0; }
+		_FORCE_INLINE_ uint32_t lowest() const { return hash_group_count_trailing_zeros(mask) >> SHIFT; }
+		_FORCE_INLINE_ void clear_lowest() { mask &= mask - 1; }
+
+		_FORCE_INLINE_ explicit Mask(uint64_t p_mask) { mask = p_mask; }
+	};
+
+private:
+#if defined(HASH_GROUP_SSE2)
+	__m128i ctrl;
+
+	_FORCE_INLINE_ Mask _match_byte(uint8_t p_value) const {
+		return Mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)p_value), ctrl)));
+	}
+
+public:
+	_FORCE_INLINE_ explicit HashGroup(const uint8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128((const __m128i *)p_ctrl);
+	}
+
+	_FORCE_INLINE_ Mask match(uint8_t p_h2) const { return _match_byte(p_h2); }
+	_FORCE_INLINE_ Mask match_empty() const { return _match_byte(CTRL_EMPTY); }
+	// Both special values have the top bit set, so the sign bits are enough.
+	_FORCE_INLINE_ Mask match_empty_or_deleted() const { return Mask((uint32_t)_mm_movemask_epi8(ctrl)); }
+
+#elif defined(HASH_GROUP_NEON)
+	uint8x16_t ctrl;
+
+	// NEON has no movemask; narrowing gives 4 bits per lane, keep just one of them.
+	static _FORCE_INLINE_ Mask _to_mask(uint8x16_t p_cmp) {
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(p_cmp), 4)), 0);
+		return Mask(mask & 0x8888888888888888ull);
+	}
+
+public:
+	_FORCE_INLINE_ explicit HashGroup(const uint8_t *p_ctrl) {
+		ctrl = vld1q_u8(p_ctrl);
+	}
+
+	_FORCE_INLINE_ Mask match(uint8_t p_h2) const { return _to_mask(vceqq_u8(ctrl, vdupq_n_u8(p_h2))); }
+	_FORCE_INLINE_ Mask match_empty() const { return _to_mask(vceqq_u8(ctrl, vdupq_n_u8(CTRL_EMPTY))); }
+	_FORCE_INLINE_ Mask match_empty_or_deleted() const { return _to_mask(vcltq_s8(vreinterpretq_s8_u8(ctrl), vdupq_n_s8(0))); }
+
+#else
+	static constexpr uint64_t LSBS = 0x0101010101010101ull;
+	static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+	uint64_t ctrl;
+
+public:
+	_FORCE_INLINE_ explicit HashGroup(const uint8_t *p_ctrl) {
+		memcpy(&ctrl, p_ctrl, sizeof(ctrl));
+#ifdef BIG_ENDIAN_ENABLED
+		ctrl = BSWAP64(ctrl);
+#endif
+	}
+
+	// May report false positives (only above an actual match), which are then discarded when comparing keys.
+	_FORCE_INLINE_ Mask match(uint8_t p_h2) const {
+		uint64_t x = ctrl ^ (LSBS * p_h2);
+		return Mask((x - LSBS) & ~x & MSBS);
+	}
+	// These two are exact.
+	_FORCE_INLINE_ Mask match_empty() const { return Mask(ctrl & ~(ctrl << 6) & MSBS); }
+	_FORCE_INLINE_ Mask match_empty_or_deleted() const { return Mask(ctrl & ~(ctrl << 7) & MSBS); }
+#endif
+};
+
+#endif // HASH_GROUP_H
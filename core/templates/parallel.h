@@ -0,0 +1,259 @@
+/**************************************************************************/
+/*  parallel.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/sort_array.h"
+
+/**
+ * Data-parallel helpers built on WorkerThreadPool.
+ *
+ * Work is split in chunks (of p_grain_size elements, or sized automatically to
+ * about four chunks per thread when 0), which the pool threads and the calling
+ * thread claim until none are left. The calling thread blocks until everything
+ * is done.
+ *
+ * When called from a WorkerThreadPool thread, or when there are no pool threads,
+ * everything runs serially on the calling thread: nested waits on the pool
+ * could otherwise block all of its threads.
+ */
+
+class ParallelChunksBase {
+public:
+	static bool can_run_in_parallel() {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		return pool && pool->get_thread_count() > 0 && WorkerThreadPool::get_thread_index() == -1;
+	}
+
+	static int64_t get_grain_size(int64_t p_count, int64_t p_grain_size) {
+		if (p_grain_size > 0) {
+			return p_grain_size;
+		}
+		if (!can_run_in_parallel()) {
+			return MAX<int64_t>(p_count, 1);
+		}
+		const int64_t chunks = (WorkerThreadPool::get_singleton()->get_thread_count() + 1) * 4;
+		return MAX<int64_t>((p_count + chunks - 1) / chunks, 1);
+	}
+};
+
+template <class F>
+class ParallelChunks : public ParallelChunksBase {
+	const F &function;
+	int64_t begin = 0;
+	int64_t end = 0;
+	int64_t grain_size = 1;
+	int64_t chunk_count = 0;
+	SafeNumeric<int64_t> next_chunk;
+
+	void _run() {
+		while (true) {
+			const int64_t chunk = next_chunk.postincrement();
+			if (chunk >= chunk_count) {
+				break;
+			}
+			const int64_t from = begin + chunk * grain_size;
+			function(chunk, from, MIN(from + grain_size, end));
+		}
+	}
+
+	static void _thread_func(void *p_userdata, uint32_t p_index) {
+		static_cast<ParallelChunks *>(p_userdata)->_run();
+	}
+
+public:
+	// Calls p_function(chunk_index, from, to) for every chunk.
+	void run() {
+		if (chunk_count <= 0) {
+			return;
+		}
+		if (chunk_count == 1 || !can_run_in_parallel()) {
+			_run();
+			return;
+		}
+
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		const int helpers = (int)MIN<int64_t>(pool->get_thread_count(), chunk_count - 1);
+		WorkerThreadPool::GroupID group = pool->add_native_group_task(&_thread_func, this, helpers, helpers, true, "Parallel chunks");
+		_run();
+		pool->wait_for_group_task_completion(group);
+	}
+
+	_FORCE_INLINE_ int64_t get_chunk_count() const { return chunk_count; }
+
+	ParallelChunks(int64_t p_begin, int64_t p_end, int64_t p_grain_size, const F &p_function) :
+			function(p_function) {
+		begin = p_begin;
+		end = p_end;
+		if (end > begin) {
+			grain_size = get_grain_size(end - begin, p_grain_size);
+			chunk_count = (end - begin + grain_size - 1) / grain_size;
+		}
+	}
+};
+
+// Calls p_function(i) for every i in [p_begin, p_end), in no particular order.
+template <class F>
+void parallel_for(int64_t p_begin, int64_t p_end, const F &p_function, int64_t p_grain_size = 0) {
+	auto chunk_function = [&p_function](int64_t p_chunk, int64_t p_from, int64_t p_to) {
+		for (int64_t i = p_from; i < p_to; i++) {
+			p_function(i);
+		}
+	};
+	ParallelChunks<decltype(chunk_function)>(p_begin, p_end, p_grain_size, chunk_function).run();
+}
+
+// Returns p_reduce(...p_reduce(p_reduce(p_identity, p_map(p_begin)), p_map(p_begin + 1))..., p_map(p_end - 1)),
+// with p_reduce assumed to be associative. Chunk results are combined in order, so p_reduce doesn't need to be commutative.
+template <class T, class M, class R>
+T parallel_reduce(int64_t p_begin, int64_t p_end, const T &p_identity, const M &p_map, const R &p_reduce, int64_t p_grain_size = 0) {
+	LocalVector<T> partials;
+	auto chunk_function = [&](int64_t p_chunk, int64_t p_from, int64_t p_to) {
+		T accum = p_identity;
+		for (int64_t i = p_from; i < p_to; i++) {
+			accum = p_reduce(accum, p_map(i));
+		}
+		partials[p_chunk] = accum;
+	};
+
+	ParallelChunks<decltype(chunk_function)> chunks(p_begin, p_end, p_grain_size, chunk_function);
+	partials.resize(chunks.get_chunk_count());
+	chunks.run();
+
+	T result = p_identity;
+	for (const T &partial : partials) {
+		result = p_reduce(result, partial);
+	}
+	return result;
+}
+
+// Sorts with SortArray in parallel chunks, then merges them in parallel, pairwise.
+// Needs a temporary copy of the array, and like SortArray, it's not stable.
+template <class T, class Comparator = _DefaultComparator<T>>
+class ParallelSortArray {
+	enum {
+		MIN_PARALLEL_SIZE = 4096, // Smaller arrays are sorted serially.
+	};
+
+	// Number of elements of p_a that go in the first p_count elements of the merge of p_a and p_b.
+	int64_t _merge_split(const T *p_a, int64_t p_a_len, const T *p_b, int64_t p_b_len, int64_t p_count) const {
+		int64_t lo = MAX<int64_t>(0, p_count - p_b_len);
+		int64_t hi = MIN(p_count, p_a_len);
+		while (lo < hi) {
+			const int64_t i = (lo + hi) / 2;
+			const int64_t j = p_count - i;
+			if (j > 0 && !compare(p_b[j - 1], p_a[i])) {
+				lo = i + 1; // p_a[i] goes before p_b[j - 1].
+			} else {
+				hi = i;
+			}
+		}
+		return lo;
+	}
+
+	void _merge(const T *p_a, int64_t p_a_len, const T *p_b, int64_t p_b_len, T *p_dst, int64_t p_count) const {
+		int64_t i = 0;
+		int64_t j = 0;
+		for (int64_t k = 0; k < p_count; k++) {
+			if (j >= p_b_len || (i < p_a_len && !compare(p_b[j], p_a[i]))) {
+				p_dst[k] = p_a[i++];
+			} else {
+				p_dst[k] = p_b[j++];
+			}
+		}
+	}
+
+public:
+	Comparator compare;
+
+	void sort(T *p_array, int64_t p_len) const {
+		if (p_len < MIN_PARALLEL_SIZE || !ParallelChunksBase::can_run_in_parallel()) {
+			SortArray<T, Comparator> sorter;
+			sorter.compare = compare;
+			sorter.sort(p_array, p_len);
+			return;
+		}
+
+		const int64_t run_size = ParallelChunksBase::get_grain_size(p_len, 0);
+
+		parallel_for(0, (p_len + run_size - 1) / run_size, [&](int64_t p_run) {
+			SortArray<T, Comparator> sorter;
+			sorter.compare = compare;
+			sorter.sort(p_array + p_run * run_size, (int)(MIN(p_len, (p_run + 1) * run_size) - p_run * run_size));
+		});
+
+		LocalVector<T> temp;
+		temp.resize(p_len);
+		T *src = p_array;
+		T *dst = temp.ptr();
+
+		for (int64_t width = run_size; width < p_len; width *= 2) {
+			// Each pair of sorted runs is merged into one, split in segments so all threads get work even for the last pairs.
+			const int64_t pairs = (p_len + 2 * width - 1) / (2 * width);
+			const int64_t segment_size = ParallelChunksBase::get_grain_size(p_len, 0);
+			const int64_t segments_per_pair = (2 * width + segment_size - 1) / segment_size;
+
+			auto merge_segment = [&](int64_t p_task) {
+				const int64_t pair_begin = (p_task / segments_per_pair) * 2 * width;
+				const int64_t a_len = MIN(width, p_len - pair_begin);
+				const int64_t b_len = MIN(width, p_len - pair_begin - a_len);
+				const int64_t from = MIN((p_task % segments_per_pair) * segment_size, a_len + b_len);
+				const int64_t to = MIN(from + segment_size, a_len + b_len);
+				if (from == to) {
+					return;
+				}
+
+				const T *a = src + pair_begin;
+				const T *b = a + a_len;
+				const int64_t a_from = _merge_split(a, a_len, b, b_len, from);
+				_merge(a + a_from, a_len - a_from, b + (from - a_from), b_len - (from - a_from), dst + pair_begin + from, to - from);
+			};
+			parallel_for(0, pairs * segments_per_pair, merge_segment, 1);
+
+			SWAP(src, dst);
+		}
+
+		if (src != p_array) {
+			parallel_for(0, p_len, [&](int64_t i) { p_array[i] = src[i]; });
+		}
+	}
+};
+
+template <class T, class Comparator = _DefaultComparator<T>>
+void parallel_sort(T *p_array, int64_t p_len) {
+	ParallelSortArray<T, Comparator> sorter;
+	sorter.sort(p_array, p_len);
+}
+
+#endif // PARALLEL_H
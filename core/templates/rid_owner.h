@@ -36,6 +36,7 @@
 #include "core/string/print_string.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
@@ -69,46 +70,70 @@ public:
 
 template <class T, bool THREAD_SAFE = false>
 class RID_Alloc : public RID_AllocBase {
-	T **chunks = nullptr;
+	// The lists of chunks are only ever replaced by bigger copies, and chunks never move,
+	// so lookups can run without locking: only allocation and freeing take the spin lock.
+	// Replaced lists are kept until destruction, since lookups may still be reading them.
+	// Allocation and freeing don't have per-thread caches: indices come from a single dense
+	// free list (which get_rid_count() and the owned list iteration rely on), and the spin
+	// lock is only held for a few instructions, unlike lookups which are far more frequent.
+	SafeNumeric<T **> chunks;
+	SafeNumeric<SafeNumeric<uint32_t> **> validator_chunks;
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
+	uint32_t chunk_list_capacity = 0;
+	LocalVector<void *> retired_chunk_lists;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
+	SafeNumeric<uint32_t> max_alloc;
 	uint32_t alloc_count = 0;
 
 	const char *description = nullptr;
 
 	mutable SpinLock spin_lock;
 
+	template <class P>
+	P *_grow_chunk_list(P *p_list, uint32_t p_chunk_count) {
+		P *list = (P *)memalloc(sizeof(P) * chunk_list_capacity);
+		if (p_list) {
+			memcpy(list, p_list, sizeof(P) * p_chunk_count);
+			retired_chunk_lists.push_back(p_list);
+		}
+		return list;
+	}
+
 	_FORCE_INLINE_ RID _allocate_rid() {
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
 
-		if (alloc_count == max_alloc) {
+		if (alloc_count == max_alloc.get()) {
 			//allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
-
-			//grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
-			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc.get() / elements_in_chunk);
+
+			//grow chunk lists
+			if (chunk_count == chunk_list_capacity) {
+				chunk_list_capacity = chunk_list_capacity == 0 ? 4 : chunk_list_capacity * 2;
+				chunks.set(_grow_chunk_list(chunks.get(), chunk_count));
+				validator_chunks.set(_grow_chunk_list(validator_chunks.get(), chunk_count));
+				free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * chunk_list_capacity); // Only used with the lock held.
+			}
 
-			//grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			//grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
+			T *chunk = (T *)memalloc(sizeof(T) * elements_in_chunk); //but don't initialize
+			SafeNumeric<uint32_t> *validator_chunk = (SafeNumeric<uint32_t> *)memalloc(sizeof(SafeNumeric<uint32_t>) * elements_in_chunk);
+			uint32_t *free_list_chunk = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
 			for (uint32_t i = 0; i < elements_in_chunk; i++) {
 				// Don't initialize chunk.
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
-				free_list_chunks[chunk_count][i] = alloc_count + i;
+				memnew_placement(&validator_chunk[i], SafeNumeric<uint32_t>(0xFFFFFFFF));
+				free_list_chunk[i] = alloc_count + i;
 			}
 
-			max_alloc += elements_in_chunk;
+			chunks.get()[chunk_count] = chunk;
+			validator_chunks.get()[chunk_count] = validator_chunk;
+			free_list_chunks[chunk_count] = free_list_chunk;
+
+			// Publish the new chunk to lookups.
+			max_alloc.set(max_alloc.get() + elements_in_chunk);
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -122,9 +147,7 @@ class RID_Alloc : public RID_AllocBase {
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-
-		validator_chunks[free_chunk][free_element] |= 0x80000000; //mark uninitialized bit
+		validator_chunks.get()[free_chunk][free_element].set(validator | 0x80000000); //mark uninitialized bit
 
 		alloc_count++;
 
@@ -156,16 +179,10 @@ public:
 		if (p_rid == RID()) {
 			return nullptr;
 		}
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.get())) {
 			return nullptr;
 		}
 
@@ -174,40 +191,28 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
+		SafeNumeric<uint32_t> &current = validator_chunks.get()[idx_chunk][idx_element];
+		uint32_t current_validator = current.get();
+
 		if (unlikely(p_initialize)) {
-			if (unlikely(!(validator_chunks[idx_chunk][idx_element] & 0x80000000))) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
+			if (unlikely(!(current_validator & 0x80000000))) {
 				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
 			}
 
-			if (unlikely((validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) != validator)) {
-				if (THREAD_SAFE) {
-					spin_lock.unlock();
-				}
+			if (unlikely((current_validator & 0x7FFFFFFF) != validator)) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
 			}
 
-			validator_chunks[idx_chunk][idx_element] &= 0x7FFFFFFF; //initialized
+			current.bit_and(0x7FFFFFFF); //initialized
 
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
-			if ((validator_chunks[idx_chunk][idx_element] & 0x80000000) && validator_chunks[idx_chunk][idx_element] != 0xFFFFFFFF) {
+		} else if (unlikely(current_validator != validator)) {
+			if ((current_validator & 0x80000000) && current_validator != 0xFFFFFFFF) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
 			}
 			return nullptr;
 		}
 
-		T *ptr = &chunks[idx_chunk][idx_element];
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return ptr;
+		return &chunks.get()[idx_chunk][idx_element];
 	}
 	void initialize_rid(RID p_rid) {
 		T *mem = get_or_null(p_rid, true);
@@ -221,16 +226,9 @@ public:
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.get())) {
 			return false;
 		}
 
@@ -239,13 +237,7 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = (validator != 0x7FFFFFFF) && (validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return (validator != 0x7FFFFFFF) && (validator_chunks.get()[idx_chunk][idx_element].get() & 0x7FFFFFFF) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
@@ -255,7 +247,7 @@ public:
 
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
+		if (unlikely(idx >= max_alloc.get())) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
@@ -266,20 +258,21 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
+		SafeNumeric<uint32_t> &current = validator_chunks.get()[idx_chunk][idx_element];
+		if (unlikely(current.get() & 0x80000000)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+		} else if (unlikely(current.get() != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL();
 		}
 
-		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
+		current.set(0xFFFFFFFF); // go invalid, before destroying so lookups stop returning it
+		chunks.get()[idx_chunk][idx_element].~T();
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
@@ -296,8 +289,8 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		for (size_t i = 0; i < max_alloc.get(); i++) {
+			uint64_t validator = validator_chunks.get()[i / elements_in_chunk][i % elements_in_chunk].get();
 			if (validator != 0xFFFFFFFF) {
 				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
@@ -313,8 +306,8 @@ public:
 			spin_lock.lock();
 		}
 		uint32_t idx = 0;
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		for (size_t i = 0; i < max_alloc.get(); i++) {
+			uint64_t validator = validator_chunks.get()[i / elements_in_chunk][i % elements_in_chunk].get();
 			if (validator != 0xFFFFFFFF) {
 				p_rid_buffer[idx] = _make_from_id((validator << 32) | i);
 				idx++;
@@ -338,28 +331,32 @@ public:
 			print_error(vformat("ERROR: %d RID allocations of type '%s' were leaked at exit.",
 					alloc_count, description ? description : typeid(T).name()));
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < max_alloc.get(); i++) {
+				uint64_t validator = validator_chunks.get()[i / elements_in_chunk][i % elements_in_chunk].get();
 				if (validator & 0x80000000) {
 					continue; //uninitialized
 				}
 				if (validator != 0xFFFFFFFF) {
-					chunks[i / elements_in_chunk][i % elements_in_chunk].~T();
+					chunks.get()[i / elements_in_chunk][i % elements_in_chunk].~T();
 				}
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = max_alloc.get() / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
-			memfree(chunks[i]);
-			memfree(validator_chunks[i]);
+			memfree(chunks.get()[i]);
+			memfree(validator_chunks.get()[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
+		if (chunks.get()) {
+			memfree(chunks.get());
 			memfree(free_list_chunks);
-			memfree(validator_chunks);
+			memfree(validator_chunks.get());
+		}
+
+		for (void *list : retired_chunk_lists) {
+			memfree(list);
 		}
 	}
 };
@@ -0,0 +1,167 @@
+/**************************************************************************/
+/*  packed_variant_array.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "packed_variant_array.h"
+
+#include "core/math/aabb.h"
+#include "core/math/basis.h"
+#include "core/math/projection.h"
+#include "core/math/transform_2d.h"
+#include "core/math/transform_3d.h"
+
+#define PACKED_VARIANT_ARRAY_TYPES(m_macro) \
+	m_macro(TRANSFORM2D, Transform2D);      \
+	m_macro(AABB, AABB);                    \
+	m_macro(BASIS, Basis);                  \
+	m_macro(TRANSFORM3D, Transform3D);      \
+	m_macro(PROJECTION, Projection);
+
+static uint32_t _get_type_size(Variant::Type p_type) {
+#define TYPE_SIZE(m_type, m_class) \
+	case Variant::m_type:          \
+		return sizeof(m_class)
+
+	switch (p_type) {
+		PACKED_VARIANT_ARRAY_TYPES(TYPE_SIZE)
+		default:
+			return 0;
+	}
+
+#undef TYPE_SIZE
+}
+
+bool PackedVariantArray::is_type_supported(Variant::Type p_type) {
+	return _get_type_size(p_type) != 0;
+}
+
+Error PackedVariantArray::resize(int p_size) {
+	ERR_FAIL_COND_V_MSG(element_size == 0, ERR_UNCONFIGURED, "The array has no element type.");
+	ERR_FAIL_COND_V(p_size < 0, ERR_INVALID_PARAMETER);
+
+	const int old_size = size();
+	Error err = data.resize(p_size * element_size);
+	if (err != OK || p_size <= old_size) {
+		return err;
+	}
+
+#define TYPE_INITIALIZE(m_type, m_class)           \
+	case Variant::m_type: {                        \
+		m_class *values = ptrw<m_class>();         \
+		for (int i = old_size; i < p_size; i++) {  \
+			memnew_placement(&values[i], m_class); \
+		}                                          \
+	} break
+
+	switch (type) {
+		PACKED_VARIANT_ARRAY_TYPES(TYPE_INITIALIZE)
+		default:
+			break;
+	}
+
+#undef TYPE_INITIALIZE
+	return OK;
+}
+
+Variant PackedVariantArray::get(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, size(), Variant());
+
+#define TYPE_GET(m_type, m_class) \
+	case Variant::m_type:         \
+		return ptr<m_class>()[p_index]
+
+	switch (type) {
+		PACKED_VARIANT_ARRAY_TYPES(TYPE_GET)
+		default:
+			return Variant();
+	}
+
+#undef TYPE_GET
+}
+
+void PackedVariantArray::set(int p_index, const Variant &p_value) {
+	ERR_FAIL_INDEX(p_index, size());
+	ERR_FAIL_COND_MSG(p_value.get_type() != type, vformat("Attempted to set a value of type \"%s\" in an array of type \"%s\".", Variant::get_type_name(p_value.get_type()), Variant::get_type_name(type)));
+
+#define TYPE_SET(m_type, m_class)                    \
+	case Variant::m_type:                            \
+		ptrw<m_class>()[p_index] = m_class(p_value); \
+		break
+
+	switch (type) {
+		PACKED_VARIANT_ARRAY_TYPES(TYPE_SET)
+		default:
+			break;
+	}
+
+#undef TYPE_SET
+}
+
+void PackedVariantArray::push_back(const Variant &p_value) {
+	ERR_FAIL_COND_MSG(p_value.get_type() != type, vformat("Attempted to push a value of type \"%s\" in an array of type \"%s\".", Variant::get_type_name(p_value.get_type()), Variant::get_type_name(type)));
+	const int index = size();
+	if (resize(index + 1) == OK) {
+		set(index, p_value);
+	}
+}
+
+Array PackedVariantArray::to_array() const {
+	Array array;
+	array.set_typed(type, StringName(), Variant());
+	const int count = size();
+	array.resize(count);
+	for (int i = 0; i < count; i++) {
+		array[i] = get(i);
+	}
+	return array;
+}
+
+Error PackedVariantArray::from_array(const Array &p_array) {
+	ERR_FAIL_COND_V_MSG(element_size == 0, ERR_UNCONFIGURED, "The array has no element type.");
+	const int count = p_array.size();
+	for (int i = 0; i < count; i++) {
+		ERR_FAIL_COND_V_MSG(p_array[i].get_type() != type, ERR_INVALID_PARAMETER, vformat("Element %d is of type \"%s\", not \"%s\".", i, Variant::get_type_name(p_array[i].get_type()), Variant::get_type_name(type)));
+	}
+
+	data.clear();
+	Error err = resize(count);
+	if (err != OK) {
+		return err;
+	}
+	for (int i = 0; i < count; i++) {
+		set(i, p_array[i]);
+	}
+	return OK;
+}
+
+PackedVariantArray::PackedVariantArray(Variant::Type p_type) {
+	ERR_FAIL_COND_MSG(!is_type_supported(p_type), vformat("Type \"%s\" isn't stored in the Variant pools.", Variant::get_type_name(p_type)));
+	type = p_type;
+	element_size = _get_type_size(p_type);
+}
@@ -0,0 +1,83 @@
+/**************************************************************************/
+/*  packed_variant_array.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef PACKED_VARIANT_ARRAY_H
+#define PACKED_VARIANT_ARRAY_H
+
+#include "core/object/object.h"
+#include "core/variant/array.h"
+#include "core/variant/type_info.h"
+#include "core/variant/variant.h"
+
+// Contiguous storage for values of one of the types that `Variant` allocates from `Variant::Pools`
+// (Transform2D, AABB, Basis, Transform3D and Projection). An `Array` of these needs one pool
+// allocation per element, while this keeps the values unboxed in a single buffer, and only makes
+// a `Variant` of them when read with `get()` or converted with `to_array()`.
+// Copies share the buffer until one of them is written, like packed arrays.
+class PackedVariantArray {
+	Variant::Type type = Variant::NIL;
+	uint32_t element_size = 0;
+	Vector<uint8_t> data;
+
+public:
+	static bool is_type_supported(Variant::Type p_type);
+
+	Variant::Type get_type() const { return type; }
+	int size() const { return element_size ? data.size() / element_size : 0; }
+	bool is_empty() const { return data.is_empty(); }
+	// New elements are default constructed, like in a typed `Array`.
+	Error resize(int p_size);
+	void clear() { data.clear(); }
+
+	Variant get(int p_index) const;
+	void set(int p_index, const Variant &p_value);
+	void push_back(const Variant &p_value);
+
+	template <typename T>
+	const T *ptr() const {
+		ERR_FAIL_COND_V_MSG(GetTypeInfo<T>::VARIANT_TYPE != type, nullptr, "The requested type doesn't match the stored type.");
+		return reinterpret_cast<const T *>(data.ptr());
+	}
+	template <typename T>
+	T *ptrw() {
+		ERR_FAIL_COND_V_MSG(GetTypeInfo<T>::VARIANT_TYPE != type, nullptr, "The requested type doesn't match the stored type.");
+		return reinterpret_cast<T *>(data.ptrw());
+	}
+
+	// Typed `Array` with the same values.
+	Array to_array() const;
+	// Replaces the contents with the elements of `p_array`, which must all be of the stored type.
+	Error from_array(const Array &p_array);
+
+	PackedVariantArray() {}
+	PackedVariantArray(Variant::Type p_type);
+};
+
+#endif // PACKED_VARIANT_ARRAY_H
@@ -47,6 +47,7 @@
 #include "core/io/ip.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/register_core_types.h"
@@ -476,6 +477,10 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  -d, --debug                       Debug (local stdout debugger).\n");
 	OS::get_singleton()->print("  -b, --breakpoints                 Breakpoint list as source::line comma-separated pairs, no spaces (use %%20 instead).\n");
 	OS::get_singleton()->print("  --profiling                       Enable profiling in the script debugger.\n");
+#ifdef MODULE_GDSCRIPT_ENABLED
+	OS::get_singleton()->print("  --gdscript-sampling-profile <path>\n");
+	OS::get_singleton()->print("                                    Sample the GDScript call stack of the main thread and save it to <path> on exit, in speedscope's format for '.json' files and as folded stacks otherwise.\n");
+#endif
 	OS::get_singleton()->print("  --gpu-profile                     Show a GPU profile of the tasks that took the most time during frame rendering.\n");
 	OS::get_singleton()->print("  --gpu-validation                  Enable graphics API validation layers for debugging.\n");
 #ifdef DEBUG_ENABLED
@@ -491,6 +496,9 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  --debug-avoidance                 Show navigation avoidance debug visuals when running the scene.\n");
 	OS::get_singleton()->print("  --debug-stringnames               Print all StringName allocations to stdout when the engine quits.\n");
 	OS::get_singleton()->print("  --debug-canvas-item-redraw        Display a rectangle each time a canvas item requests a redraw (useful to troubleshoot low processor mode).\n");
+#endif
+#ifdef COWDATA_AUDIT_ENABLED
+	OS::get_singleton()->print("  --debug-cow-copies                Print all copy-on-write copies of Vector and String data to stdout when the engine quits.\n");
 #endif
 	OS::get_singleton()->print("  --max-fps <fps>                   Set a maximum number of frames per second rendered (can be used to limit power usage). A value of 0 results in unlimited framerate.\n");
 	OS::get_singleton()->print("  --frame-delay <ms>                Simulate high CPU load (delay each frame by <ms> milliseconds). Do not use as a FPS limiter; use --max-fps instead.\n");
@@ -1475,6 +1483,10 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			debug_canvas_item_redraw = true;
 		} else if (I->get() == "--debug-stringnames") {
 			StringName::set_debug_stringnames(true);
+#endif
+#ifdef COWDATA_AUDIT_ENABLED
+		} else if (I->get() == "--debug-cow-copies") {
+			CowDataAudit::set_print_report_at_exit(true);
 #endif
 		} else if (I->get() == "--remote-debug") {
 			if (I->next()) {
@@ -3877,6 +3889,9 @@ bool Main::iteration() {
 
 	iterating--;
 
+	// Frame arena allocations don't outlive the frame.
+	FrameArena::end_frame();
+
 	// Needed for OSs using input buffering regardless accumulation (like Android)
 	if (Input::get_singleton()->is_using_input_buffering() && !agile_input_event_flushing) {
 		Input::get_singleton()->flush_buffered_events();
@@ -3940,6 +3955,10 @@ void Main::cleanup(bool p_force) {
 		movie_writer->end();
 	}
 
+	if (CowDataAudit::is_print_report_at_exit_enabled()) {
+		CowDataAudit::print_report();
+	}
+
 	ResourceLoader::clear_thread_load_tasks();
 
 	ResourceLoader::remove_custom_loaders();
@@ -4068,6 +4087,9 @@ void Main::cleanup(bool p_force) {
 	uninitialize_modules(MODULE_INITIALIZATION_LEVEL_CORE);
 	unregister_core_types();
 
+	FrameArena::cleanup();
+	CowDataAudit::cleanup();
+
 	OS::get_singleton()->benchmark_end_measure("Shutdown", "Total");
 	OS::get_singleton()->benchmark_dump();
 
@@ -84,6 +84,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_COW_COPY_COUNT);
+	BIND_ENUM_CONSTANT(MEMORY_COW_COPIED_BYTES);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -132,6 +134,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"memory/cow_copies",
+		"memory/cow_copied",
 
 	};
 
@@ -206,6 +210,10 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case MEMORY_COW_COPY_COUNT:
+			return CowDataAudit::get_copy_count();
+		case MEMORY_COW_COPIED_BYTES:
+			return CowDataAudit::get_copied_bytes();
 
 		default: {
 		}
@@ -251,6 +259,8 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
@@ -100,6 +100,8 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		MEMORY_COW_COPY_COUNT,
+		MEMORY_COW_COPIED_BYTES,
 		MONITOR_MAX
 	};
 
@@ -0,0 +1,299 @@
+/**************************************************************************/
+/*  gdscript_native_exporter.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_native_exporter.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
+static String _reg(int p_index, const char *p_field) {
+	return vformat("r[%d].%s", p_index, p_field);
+}
+
+static const char *_variant_type_constant(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL:
+			return "Variant::BOOL";
+		case Variant::INT:
+			return "Variant::INT";
+		default:
+			return "Variant::FLOAT";
+	}
+}
+
+struct BinaryOperation {
+	GDScriptNumericTier::Operation op;
+	const char *result;
+	const char *operand;
+	const char *symbol;
+};
+
+static const BinaryOperation binary_operations[] = {
+	{ GDScriptNumericTier::OP_ADD_INT, "i", "i", "+" },
+	{ GDScriptNumericTier::OP_SUBTRACT_INT, "i", "i", "-" },
+	{ GDScriptNumericTier::OP_MULTIPLY_INT, "i", "i", "*" },
+	{ GDScriptNumericTier::OP_ADD_FLOAT, "f", "f", "+" },
+	{ GDScriptNumericTier::OP_SUBTRACT_FLOAT, "f", "f", "-" },
+	{ GDScriptNumericTier::OP_MULTIPLY_FLOAT, "f", "f", "*" },
+	{ GDScriptNumericTier::OP_DIVIDE_FLOAT, "f", "f", "/" },
+	{ GDScriptNumericTier::OP_EQUAL_INT, "i", "i", "==" },
+	{ GDScriptNumericTier::OP_NOT_EQUAL_INT, "i", "i", "!=" },
+	{ GDScriptNumericTier::OP_LESS_INT, "i", "i", "<" },
+	{ GDScriptNumericTier::OP_LESS_EQUAL_INT, "i", "i", "<=" },
+	{ GDScriptNumericTier::OP_GREATER_INT, "i", "i", ">" },
+	{ GDScriptNumericTier::OP_GREATER_EQUAL_INT, "i", "i", ">=" },
+	{ GDScriptNumericTier::OP_EQUAL_FLOAT, "i", "f", "==" },
+	{ GDScriptNumericTier::OP_NOT_EQUAL_FLOAT, "i", "f", "!=" },
+	{ GDScriptNumericTier::OP_LESS_FLOAT, "i", "f", "<" },
+	{ GDScriptNumericTier::OP_LESS_EQUAL_FLOAT, "i", "f", "<=" },
+	{ GDScriptNumericTier::OP_GREATER_FLOAT, "i", "f", ">" },
+	{ GDScriptNumericTier::OP_GREATER_EQUAL_FLOAT, "i", "f", ">=" },
+};
+
+static String _emit_instruction(const GDScriptNumericTier::Instruction &p_instruction) {
+	typedef GDScriptNumericTier T;
+	const int a = p_instruction.a;
+	const int b = p_instruction.b;
+	const int c = p_instruction.c;
+	const String target = vformat("goto L%d;", p_instruction.d);
+
+	for (const BinaryOperation &binary : binary_operations) {
+		if (binary.op == p_instruction.op) {
+			return vformat("%s = %s %s %s;", _reg(c, binary.result), _reg(a, binary.operand), binary.symbol, _reg(b, binary.operand));
+		}
+	}
+
+	switch (p_instruction.op) {
+		case T::OP_MOVE:
+			return vformat("r[%d] = r[%d];", a, b);
+		case T::OP_LOAD_IMMEDIATE:
+			return vformat("%s = %d;", _reg(a, "i"), b);
+		case T::OP_INT_TO_FLOAT:
+			return vformat("%s = (double)%s;", _reg(a, "f"), _reg(b, "i"));
+		case T::OP_FLOAT_TO_INT:
+			return vformat("%s = (int64_t)%s;", _reg(a, "i"), _reg(b, "f"));
+		case T::OP_NEGATE_INT:
+			return vformat("%s = -%s;", _reg(c, "i"), _reg(a, "i"));
+		case T::OP_NEGATE_FLOAT:
+			return vformat("%s = -%s;", _reg(c, "f"), _reg(a, "f"));
+		case T::OP_NOT:
+			return vformat("%s = !%s;", _reg(c, "i"), _reg(a, "i"));
+		case T::OP_JUMP:
+			return target;
+		case T::OP_JUMP_IF:
+			return vformat("if (%s) %s", _reg(a, "i"), target);
+		case T::OP_JUMP_IF_NOT:
+			return vformat("if (!%s) %s", _reg(a, "i"), target);
+		case T::OP_JUMP_IF_NOT_LESS_INT:
+			return vformat("if (!(%s < %s)) %s", _reg(a, "i"), _reg(b, "i"), target);
+		case T::OP_ITERATE_BEGIN_INT:
+			return vformat("%s = 0; if (%s <= 0) %s %s = 0;", _reg(a, "i"), _reg(b, "i"), target, _reg(c, "i"));
+		case T::OP_ITERATE_INT:
+			return vformat("if (++%s >= %s) %s %s = %s;", _reg(a, "i"), _reg(b, "i"), target, _reg(c, "i"), _reg(a, "i"));
+		case T::OP_ITERATE_BEGIN_FLOAT:
+			return vformat("%s = 0.0; if (!(%s > 0)) %s %s = 0.0;", _reg(a, "f"), _reg(b, "f"), target, _reg(c, "f"));
+		case T::OP_ITERATE_FLOAT:
+			return vformat("if (++%s >= %s) %s %s = %s;", _reg(a, "f"), _reg(b, "f"), target, _reg(c, "f"), _reg(a, "f"));
+		case T::OP_RETURN: {
+			switch (Variant::Type(b)) {
+				case Variant::BOOL:
+					return vformat("r_ret = bool(%s); return true;", _reg(a, "i"));
+				case Variant::INT:
+					return vformat("r_ret = %s; return true;", _reg(a, "i"));
+				default:
+					return vformat("r_ret = %s; return true;", _reg(a, "f"));
+			}
+		}
+		case T::OP_RETURN_NIL:
+			return "r_ret = Variant(); return true;";
+		default:
+			break;
+	}
+
+	ERR_FAIL_V_MSG("", "Unknown numeric tier operation.");
+}
+
+String GDScriptNativeExporter::emit_function(const GDScriptNumericTier::Program *p_program, const String &p_symbol) {
+	ERR_FAIL_NULL_V(p_program, String());
+
+	HashSet<int> jump_targets;
+	for (const GDScriptNumericTier::Instruction &instruction : p_program->code) {
+		switch (instruction.op) {
+			case GDScriptNumericTier::OP_JUMP:
+			case GDScriptNumericTier::OP_JUMP_IF:
+			case GDScriptNumericTier::OP_JUMP_IF_NOT:
+			case GDScriptNumericTier::OP_JUMP_IF_NOT_LESS_INT:
+			case GDScriptNumericTier::OP_ITERATE_BEGIN_INT:
+			case GDScriptNumericTier::OP_ITERATE_INT:
+			case GDScriptNumericTier::OP_ITERATE_BEGIN_FLOAT:
+			case GDScriptNumericTier::OP_ITERATE_FLOAT:
+				jump_targets.insert(instruction.d);
+				break;
+			default:
+				break;
+		}
+	}
+
+	const int argcount = p_program->argument_types.size();
+
+	String code = vformat("static bool %s(const Variant **p_args, int p_argcount, Variant &r_ret) {\n", p_symbol);
+	String guard = vformat("p_argcount != %d", argcount);
+	for (int i = 0; i < argcount; i++) {
+		guard += vformat(" || p_args[%d]->get_type() != %s", i, _variant_type_constant(p_program->argument_types[i]));
+	}
+	code += vformat("\tif (%s) {\n\t\treturn false;\n\t}\n\n", guard);
+
+	code += vformat("\tGDScriptNumericTier::Register r[%d] = {};\n", (int)p_program->registers.size());
+	for (uint32_t i = 0; i < p_program->registers.size(); i++) {
+		// Stored as bits, so float constants are exact.
+		uint64_t bits = uint64_t(p_program->registers[i].i);
+		if (bits != 0) {
+			code += vformat("\tr[%d].i = int64_t(UINT64_C(0x%s));\n", i, String::num_uint64(bits, 16));
+		}
+	}
+	for (int i = 0; i < argcount; i++) {
+		const int reg = GDScriptFunction::FIXED_ADDRESSES_MAX + i;
+		switch (p_program->argument_types[i]) {
+			case Variant::BOOL:
+				code += vformat("\tr[%d].i = *VariantInternal::get_bool(p_args[%d]) ? 1 : 0;\n", reg, i);
+				break;
+			case Variant::INT:
+				code += vformat("\tr[%d].i = *VariantInternal::get_int(p_args[%d]);\n", reg, i);
+				break;
+			default:
+				code += vformat("\tr[%d].f = *VariantInternal::get_float(p_args[%d]);\n", reg, i);
+				break;
+		}
+	}
+	code += "\n";
+
+	for (uint32_t i = 0; i < p_program->code.size(); i++) {
+		if (jump_targets.has(i)) {
+			code += vformat("L%d:\n", i);
+		}
+		code += "\t" + _emit_instruction(p_program->code[i]) + "\n";
+	}
+	code += "}\n";
+	return code;
+}
+
+void GDScriptNativeExporter::_add_script(const GDScript *p_script) {
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->get_member_functions()) {
+		GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(E.value);
+		if (!program) {
+			continue;
+		}
+
+		Function function;
+		function.key = GDScriptNumericTier::get_native_key(E.value, program);
+		function.symbol = vformat("_gdscript_native_%d", functions.size());
+		function.code = vformat("// %s::%s\n", p_script->get_fully_qualified_name(), E.key) + emit_function(program, function.symbol);
+		functions.push_back(function);
+
+		memdelete(program);
+	}
+
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->get_subclasses()) {
+		_add_script(E.value.ptr());
+	}
+}
+
+void GDScriptNativeExporter::add_script(const Ref<GDScript> &p_script) {
+	ERR_FAIL_COND(p_script.is_null() || !p_script->is_valid());
+	_add_script(p_script.ptr());
+}
+
+Error GDScriptNativeExporter::save_module(const String &p_dir) const {
+	const String module_dir = p_dir.path_join(MODULE_NAME);
+	Error err = DirAccess::make_dir_recursive_absolute(module_dir);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Can't create the GDScript native module directory: \"%s\".", module_dir));
+
+	HashMap<String, String> files;
+
+	files["config.py"] = R"(def can_build(env, platform):
+    env.module_add_dependencies("gdscript_native", ["gdscript"])
+    return True
+
+
+def configure(env):
+    pass
+)";
+
+	files["SCsub"] = R"(#!/usr/bin/env python
+
+Import("env")
+Import("env_modules")
+
+env_gdscript_native = env_modules.Clone()
+
+env_gdscript_native.add_source_files(env.modules_sources, "*.cpp")
+)";
+
+	files["register_types.h"] = R"(/* THIS FILE IS GENERATED DO NOT EDIT */
+#ifndef GDSCRIPT_NATIVE_REGISTER_TYPES_H
+#define GDSCRIPT_NATIVE_REGISTER_TYPES_H
+
+#include "modules/register_module_types.h"
+
+void initialize_gdscript_native_module(ModuleInitializationLevel p_level);
+void uninitialize_gdscript_native_module(ModuleInitializationLevel p_level);
+
+#endif // GDSCRIPT_NATIVE_REGISTER_TYPES_H
+)";
+
+	String source = R"(/* THIS FILE IS GENERATED DO NOT EDIT */
+#include "register_types.h"
+
+#include "modules/gdscript/gdscript_numeric_tier.h"
+
+#include "core/variant/variant_internal.h"
+
+)";
+	String registration;
+	for (const Function &function : functions) {
+		source += function.code + "\n";
+		registration += vformat("\tGDScriptNumericTier::register_native_function(\"%s\", %s);\n", function.key.c_escape(), function.symbol);
+	}
+	source += "void initialize_gdscript_native_module(ModuleInitializationLevel p_level) {\n";
+	source += "\tif (p_level != MODULE_INITIALIZATION_LEVEL_SERVERS) {\n\t\treturn;\n\t}\n\n";
+	source += registration;
+	source += "}\n\n";
+	source += "void uninitialize_gdscript_native_module(ModuleInitializationLevel p_level) {\n}\n";
+	files["register_types.cpp"] = source;
+
+	for (const KeyValue<String, String> &E : files) {
+		const String path = module_dir.path_join(E.key);
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE, &err);
+		ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Can't write \"%s\".", path));
+		file->store_string(E.value);
+	}
+
+	return OK;
+}
@@ -0,0 +1,67 @@
+/**************************************************************************/
+/*  gdscript_native_exporter.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_NATIVE_EXPORTER_H
+#define GDSCRIPT_NATIVE_EXPORTER_H
+
+#include "../gdscript.h"
+#include "../gdscript_numeric_tier.h"
+
+#include "core/templates/local_vector.h"
+
+// Writes the functions of exported scripts that run in the numeric tier as C++, in a Godot module
+// that registers them with `GDScriptNumericTier`. Building export templates with
+// `custom_modules=<dir>` compiles them into the binary; functions that can't be translated, and
+// any function whose code no longer matches, keep running as bytecode.
+class GDScriptNativeExporter {
+	struct Function {
+		String key;
+		String symbol;
+		String code;
+	};
+
+	LocalVector<Function> functions;
+
+	void _add_script(const GDScript *p_script);
+
+public:
+	static constexpr const char *MODULE_NAME = "gdscript_native";
+
+	static String emit_function(const GDScriptNumericTier::Program *p_program, const String &p_symbol);
+
+	void add_script(const Ref<GDScript> &p_script);
+	int get_function_count() const { return functions.size(); }
+	void clear() { functions.clear(); }
+
+	// Writes the module to `<p_dir>/gdscript_native`.
+	Error save_module(const String &p_dir) const;
+};
+
+#endif // GDSCRIPT_NATIVE_EXPORTER_H
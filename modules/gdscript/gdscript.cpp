@@ -31,10 +31,12 @@
 #include "gdscript.h"
 
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampler.h"
 #include "gdscript_warning.h"
 
 #ifdef TOOLS_ENABLED
@@ -51,6 +53,7 @@
 #include "core/core_string_names.h"
 #include "core/io/file_access.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/resource_uid.h"
 #include "core/os/os.h"
 
 #ifdef TOOLS_ENABLED
@@ -738,6 +741,15 @@ Error GDScript::reload(bool p_keep_state) {
 #endif
 
 	valid = false;
+
+	// Exported projects may ship the compiled bytecode of the script.
+	if (GDScriptBytecodeCache::can_load(path) && GDScriptBytecodeCache::load(this) == OK) {
+		can_run = ScriptServer::is_scripting_enabled() || is_tool();
+		Error err = can_run ? _static_init() : OK;
+		reloading = false;
+		return err;
+	}
+
 	GDScriptParser parser;
 	Error err = parser.parse(source, path, false);
 	if (err) {
@@ -1457,6 +1469,7 @@ void GDScript::clear(ClearData *p_clear_data) {
 		return;
 	}
 	clearing = true;
+	GDScriptInlineCache::invalidate();
 
 	ClearData data;
 	ClearData *clear_data = p_clear_data;
@@ -1545,6 +1558,9 @@ GDScript::~GDScript() {
 	}
 	destructing = true;
 
+	// Call sites may still reference this script, and another one could be allocated at the same address.
+	GDScriptInlineCache::invalidate();
+
 	if (is_print_verbose_enabled()) {
 		MutexLock lock(func_ptrs_to_update_mutex);
 		if (!func_ptrs_to_update.is_empty()) {
@@ -2132,11 +2148,62 @@ void GDScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+	if (!Engine::get_singleton()->is_editor_hint() && GLOBAL_GET("threading/gdscript/parallel_parsing")) {
+		_parse_startup_scripts();
+	}
+
+	sampler = memnew(GDScriptSampler);
+	sampler->register_profiler();
+
+	List<String> cmdline_args = OS::get_singleton()->get_cmdline_args();
+	for (const List<String>::Element *E = cmdline_args.front(); E; E = E->next()) {
+		if (E->get() == "--gdscript-sampling-profile" && E->next()) {
+			// Saved on exit, in speedscope's format for `.json` files and as folded stacks otherwise.
+			sampling_profile_path = E->next()->get();
+			sampler->start();
+		}
+	}
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
 }
 
+void GDScriptLanguage::_parse_startup_scripts() {
+	// Scripts loaded before the first frame. The ones they depend on are found while parsing.
+	Vector<String> scripts;
+	Vector<String> scenes;
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		if (E.value.path.get_extension() == get_extension()) {
+			scripts.push_back(E.value.path);
+		} else {
+			scenes.push_back(E.value.path);
+		}
+	}
+	String main_scene = GLOBAL_GET("application/run/main_scene");
+	if (!main_scene.is_empty()) {
+		scenes.push_back(main_scene);
+	}
+
+	for (const String &scene : scenes) {
+		List<String> dependencies;
+		ResourceLoader::get_dependencies(scene, &dependencies);
+		for (const String &E : dependencies) {
+			String path = E.get_slice("::", 0);
+			if (path.begins_with("uid://")) {
+				path = ResourceUID::get_singleton()->get_id_path(ResourceUID::get_singleton()->text_to_id(path));
+			}
+			if (path.get_extension() == get_extension()) {
+				scripts.push_back(path);
+			}
+		}
+	}
+
+	if (!scripts.is_empty()) {
+		GDScriptCache::parse_scripts(scripts);
+	}
+}
+
 String GDScriptLanguage::get_type() const {
 	return "GDScript";
 }
@@ -2146,6 +2213,16 @@ String GDScriptLanguage::get_extension() const {
 }
 
 void GDScriptLanguage::finish() {
+	if (sampler) {
+		sampler->unregister_profiler();
+		sampler->stop();
+		if (!sampling_profile_path.is_empty()) {
+			sampler->save(sampling_profile_path);
+		}
+		memdelete(sampler);
+		sampler = nullptr;
+	}
+
 	_call_stack.free();
 
 	// Clear the cache before parsing the script_list
@@ -2181,6 +2258,8 @@ void GDScriptLanguage::finish() {
 	}
 	script_list.clear();
 	function_list.clear();
+
+	GDScriptFramePool::clear();
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2517,6 +2596,9 @@ void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_so
 void GDScriptLanguage::frame() {
 	calls = 0;
 
+	// Whatever was parsed ahead for the startup scripts and wasn't used by now won't be.
+	GDScriptCache::release_parsed_scripts();
+
 #ifdef DEBUG_ENABLED
 	if (profiling) {
 		MutexLock lock(this->mutex);
@@ -2741,14 +2823,12 @@ GDScriptLanguage::GDScriptLanguage() {
 	script_frame_time = 0;
 
 	int dmcs = GLOBAL_DEF(PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "512," + itos(GDScriptFunction::MAX_CALL_DEPTH - 1) + ",1"), 1024);
+	GLOBAL_DEF("threading/gdscript/parallel_parsing", true);
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "gdscript/compiler/optimization_level", PROPERTY_HINT_ENUM, "None,Constant Branches,Build Constants"), 1);
 
-	if (EngineDebugger::is_active()) {
-		//debugging enabled!
-
-		_debug_max_call_stack = dmcs;
-	} else {
-		_debug_max_call_stack = 0;
-	}
+	// Also needed without the debugger, when the sampling profiler is started.
+	_debug_max_call_stack = dmcs;
+	tracking_call_stack = EngineDebugger::is_active();
 
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
@@ -63,6 +63,7 @@ class GDScript : public Script {
 	bool tool = false;
 	bool valid = false;
 	bool reloading = false;
+	bool debug_code = false; // Whether the code was compiled as for a debug build, see GDScriptCompiler::set_debug_code().
 
 	struct MemberInfo {
 		int index = 0;
@@ -85,7 +86,9 @@ class GDScript : public Script {
 	friend class GDScriptFunction;
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
+	friend class GDScriptBytecodeCache;
 	friend class GDScriptDocGen;
+	friend class GDScriptInlineCache;
 	friend class GDScriptLambdaCallable;
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptLanguage;
@@ -342,6 +345,7 @@ class GDScriptInstance : public ScriptInstance {
 	friend class GDScriptLambdaSelfCallable;
 	friend class GDScriptCompiler;
 	friend class GDScriptCache;
+	friend class GDScriptInlineCache;
 	friend struct GDScriptUtilityFunctionsDefinitions;
 
 	ObjectID owner_id;
@@ -390,6 +394,8 @@ public:
 	~GDScriptInstance();
 };
 
+class GDScriptSampler;
+
 class GDScriptLanguage : public ScriptLanguage {
 	friend class GDScriptFunctionState;
 
@@ -430,6 +436,7 @@ class GDScriptLanguage : public ScriptLanguage {
 	int _debug_max_call_stack = 0;
 
 	void _add_global(const StringName &p_name, const Variant &p_value);
+	void _parse_startup_scripts();
 
 	friend class GDScriptInstance;
 
@@ -439,9 +446,14 @@ class GDScriptLanguage : public ScriptLanguage {
 
 	SelfList<GDScript>::List script_list;
 	friend class GDScriptFunction;
+	friend class GDScriptNumericTier;
+	friend class GDScriptSampler;
 
 	SelfList<GDScriptFunction>::List function_list;
 	bool profiling;
+	bool tracking_call_stack = false;
+	GDScriptSampler *sampler = nullptr;
+	String sampling_profile_path;
 	bool profile_native_calls;
 	uint64_t script_frame_time;
 
@@ -453,19 +465,26 @@ public:
 	bool debug_break(const String &p_error, bool p_allow_continue = true);
 	bool debug_break_parse(const String &p_file, int p_line, const String &p_error);
 
+	// Whether the VM keeps the call stack up to date, for the debugger or the sampling profiler.
+	// Never reset once set, so functions already running keep unwinding it.
+	_FORCE_INLINE_ bool is_tracking_call_stack() const { return tracking_call_stack; }
+
 	_FORCE_INLINE_ void enter_function(GDScriptInstance *p_instance, GDScriptFunction *p_function, Variant *p_stack, int *p_ip, int *p_line) {
 		if (unlikely(_call_stack.levels == nullptr)) {
 			_call_stack.levels = memnew_arr(CallLevel, _debug_max_call_stack + 1);
 		}
 
-		if (EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
-			EngineDebugger::get_script_debugger()->set_depth(EngineDebugger::get_script_debugger()->get_depth() + 1);
+		ScriptDebugger *script_debugger = EngineDebugger::get_script_debugger();
+		if (script_debugger && script_debugger->get_lines_left() > 0 && script_debugger->get_depth() >= 0) {
+			script_debugger->set_depth(script_debugger->get_depth() + 1);
 		}
 
 		if (_call_stack.stack_pos >= _debug_max_call_stack) {
 			//stack overflow
 			_debug_error = vformat("Stack overflow (stack size: %s). Check for infinite recursion in your script.", _debug_max_call_stack);
-			EngineDebugger::get_script_debugger()->debug(this);
+			if (script_debugger) {
+				script_debugger->debug(this);
+			}
 			return;
 		}
 
@@ -478,13 +497,17 @@ public:
 	}
 
 	_FORCE_INLINE_ void exit_function() {
-		if (EngineDebugger::get_script_debugger()->get_lines_left() > 0 && EngineDebugger::get_script_debugger()->get_depth() >= 0) {
-			EngineDebugger::get_script_debugger()->set_depth(EngineDebugger::get_script_debugger()->get_depth() - 1);
+		ScriptDebugger *script_debugger = EngineDebugger::get_script_debugger();
+		if (script_debugger && script_debugger->get_lines_left() > 0 && script_debugger->get_depth() >= 0) {
+			script_debugger->set_depth(script_debugger->get_depth() - 1);
 		}
 
 		if (_call_stack.stack_pos == 0) {
-			_debug_error = "Stack Underflow (Engine Bug)";
-			EngineDebugger::get_script_debugger()->debug(this);
+			// Expected when tracking started while this function was running, see `is_tracking_call_stack()`.
+			if (script_debugger) {
+				_debug_error = "Stack Underflow (Engine Bug)";
+				script_debugger->debug(this);
+			}
 			return;
 		}
 
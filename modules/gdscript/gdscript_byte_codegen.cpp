@@ -395,6 +395,15 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	if (inline_cache_count) {
+		function->inline_caches.resize(inline_cache_count);
+		function->_inline_caches_ptr = function->inline_caches.ptrw();
+		function->_inline_caches_count = inline_cache_count;
+	} else {
+		function->_inline_caches_ptr = nullptr;
+		function->_inline_caches_count = 0;
+	}
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
@@ -581,6 +590,37 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 	}
 }
 
+static GDScriptFunction::Opcode _get_typed_operator_opcode(Variant::Operator p_operator, Variant::Type p_left_type, Variant::Type p_right_type) {
+	if (p_left_type == Variant::INT && p_right_type == Variant::INT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_INT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT;
+			case Variant::OP_LESS:
+				return GDScriptFunction::OPCODE_OPERATOR_LESS_INT;
+			default:
+				break;
+		}
+	} else if (p_left_type == Variant::FLOAT && p_right_type == Variant::FLOAT) {
+		switch (p_operator) {
+			case Variant::OP_ADD:
+				return GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT;
+			default:
+				break;
+		}
+	}
+	return GDScriptFunction::OPCODE_OPERATOR_VALIDATED;
+}
+
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
 	// Avoid validated evaluator for modulo and division when operands are int, since there's no check for division by zero.
 	if (HAS_BUILTIN_TYPE(p_left_operand) && HAS_BUILTIN_TYPE(p_right_operand) && ((p_operator != Variant::OP_DIVIDE && p_operator != Variant::OP_MODULE) || p_left_operand.type.builtin_type != Variant::INT || p_right_operand.type.builtin_type != Variant::INT)) {
@@ -592,6 +632,24 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 			}
 		}
 
+		last_operator = LastOperator();
+		if (p_target.mode == Address::TEMPORARY) {
+			last_operator.position = opcodes.size();
+			last_operator.temporary = p_target.address;
+			last_operator.result_type = Variant::get_operator_return_type(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		}
+
+		// Common int and float arithmetic has dedicated opcodes that skip the evaluator call.
+		GDScriptFunction::Opcode typed_opcode = _get_typed_operator_opcode(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
+		if (typed_opcode != GDScriptFunction::OPCODE_OPERATOR_VALIDATED) {
+			append_opcode(typed_opcode);
+			append(p_left_operand);
+			append(p_right_operand);
+			append(p_target);
+			last_operator.size = 4;
+			return;
+		}
+
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
@@ -603,6 +661,7 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 #ifdef DEBUG_ENABLED
 		add_debug_name(operator_names, get_operation_pos(op_func), Variant::get_operator_name(p_operator));
 #endif
+		last_operator.size = 5;
 		return;
 	}
 
@@ -756,10 +815,23 @@ void GDScriptByteCodeGenerator::write_end_ternary() {
 	ternary_result.pop_back();
 }
 
+// Packed arrays have `OPCODE_GET_INDEXED_PACKED_*` and `OPCODE_SET_INDEXED_PACKED_*` opcodes, in the order of their types.
+static bool _is_packed_array_type(Variant::Type p_type) {
+	return p_type >= Variant::PACKED_BYTE_ARRAY && p_type <= Variant::PACKED_COLOR_ARRAY;
+}
+
 void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
 	if (HAS_BUILTIN_TYPE(p_target)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_setter(p_target.type.builtin_type) &&
 				IS_BUILTIN_TYPE(p_source, Variant::get_indexed_element_type(p_target.type.builtin_type))) {
+			if (_is_packed_array_type(p_target.type.builtin_type)) {
+				// Write the packed storage directly.
+				append_opcode(GDScriptFunction::Opcode(GDScriptFunction::OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY + (p_target.type.builtin_type - Variant::PACKED_BYTE_ARRAY)));
+				append(p_target);
+				append(p_index);
+				append(p_source);
+				return;
+			}
 			// Use indexed setter instead.
 			Variant::ValidatedIndexedSetter setter = Variant::get_member_validated_indexed_setter(p_target.type.builtin_type);
 			append_opcode(GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED);
@@ -788,6 +860,14 @@ void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address
 void GDScriptByteCodeGenerator::write_get(const Address &p_target, const Address &p_index, const Address &p_source) {
 	if (HAS_BUILTIN_TYPE(p_source)) {
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_getter(p_source.type.builtin_type)) {
+			if (_is_packed_array_type(p_source.type.builtin_type)) {
+				// Read the packed storage directly.
+				append_opcode(GDScriptFunction::Opcode(GDScriptFunction::OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY + (p_source.type.builtin_type - Variant::PACKED_BYTE_ARRAY)));
+				append(p_source);
+				append(p_index);
+				append(p_target);
+				return;
+			}
 			// Use indexed getter instead.
 			Variant::ValidatedIndexedGetter getter = Variant::get_member_validated_indexed_getter(p_source.type.builtin_type);
 			append_opcode(GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED);
@@ -847,6 +927,7 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append_inline_cache();
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
@@ -921,9 +1002,63 @@ void GDScriptByteCodeGenerator::write_assign_with_conversion(const Address &p_ta
 			append(p_source);
 		}
 	}
+
+	mark_local_written(p_target);
+}
+
+bool GDScriptByteCodeGenerator::fold_operator_into_assign(const Address &p_target, const Address &p_source) {
+	// Only typed locals that already hold a value of the result type can be written in place
+	// by the operator, since the typed and validated operators don't change the target type.
+	if (!is_last_operator_result(p_source) || p_target.mode != Address::LOCAL_VARIABLE || !locals[p_target.address - RESERVED_STACK].written) {
+		return false;
+	}
+	if (!p_target.type.has_type || p_target.type.kind != GDScriptDataType::BUILTIN || p_target.type.builtin_type != last_operator.result_type) {
+		return false;
+	}
+	switch (last_operator.result_type) {
+		case Variant::NIL:
+		case Variant::OBJECT:
+		case Variant::DICTIONARY:
+		case Variant::ARRAY:
+			return false;
+		default:
+			break;
+	}
+
+	// Evaluators may write the result before they're done reading the operands, e.g. appending
+	// packed arrays copies the left one into the result first. `x = y + x` must keep the temporary.
+	const int target_address = address_of(p_target);
+	if (opcodes[last_operator.position + 1] == target_address || opcodes[last_operator.position + 2] == target_address) {
+		return false;
+	}
+
+	int target_pos = last_operator.position + 3;
+	temporaries.write[last_operator.temporary].bytecode_indices.erase(target_pos);
+	opcodes.write[target_pos] = target_address;
+	last_operator = LastOperator();
+	return true;
+}
+
+bool GDScriptByteCodeGenerator::fold_operator_into_jump(const Address &p_condition, List<int> &r_jump_addrs) {
+	if (!is_last_operator_result(p_condition) || opcodes[last_operator.position] != GDScriptFunction::OPCODE_OPERATOR_LESS_INT) {
+		return false;
+	}
+
+	// Reuse the result operand as the jump destination.
+	int jump_pos = last_operator.position + 3;
+	temporaries.write[last_operator.temporary].bytecode_indices.erase(jump_pos);
+	opcodes.write[last_operator.position] = GDScriptFunction::OPCODE_JUMP_IF_NOT_LESS_INT;
+	opcodes.write[jump_pos] = 0; // Jump destination, will be patched.
+	r_jump_addrs.push_back(jump_pos);
+	last_operator = LastOperator();
+	return true;
 }
 
 void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Address &p_source) {
+	if (fold_operator_into_assign(p_target, p_source)) {
+		return;
+	}
+
 	if (p_target.type.kind == GDScriptDataType::BUILTIN && p_target.type.builtin_type == Variant::ARRAY && p_target.type.has_container_element_type(0)) {
 		const GDScriptDataType &element_type = p_target.type.get_container_element_type(0);
 		append_opcode(GDScriptFunction::OPCODE_ASSIGN_TYPED_ARRAY);
@@ -943,6 +1078,8 @@ void GDScriptByteCodeGenerator::write_assign(const Address &p_target, const Addr
 		append(p_target);
 		append(p_source);
 	}
+
+	mark_local_written(p_target);
 }
 
 void GDScriptByteCodeGenerator::write_assign_true(const Address &p_target) {
@@ -962,11 +1099,13 @@ void GDScriptByteCodeGenerator::write_assign_default_parameter(const Address &p_
 		write_assign(p_dst, p_src);
 	}
 	function->default_arguments.push_back(opcodes.size());
+	last_operator = LastOperator(); // Entry point when the argument is passed.
 }
 
 void GDScriptByteCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
 	append_opcode(GDScriptFunction::OPCODE_STORE_GLOBAL);
 	append(p_dst);
+	function->global_index_positions.push_back(opcodes.size());
 	append(p_global_index);
 }
 
@@ -1032,6 +1171,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1057,6 +1197,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1265,6 +1406,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1278,6 +1420,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1291,6 +1434,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(ct.target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append_inline_cache();
 	ct.cleanup();
 }
 
@@ -1349,6 +1493,7 @@ void GDScriptByteCodeGenerator::write_construct(const Address &p_target, Variant
 #ifdef DEBUG_ENABLED
 			add_debug_name(constructors_names, get_constructor_pos(Variant::get_validated_constructor(p_type, valid_constructor)), Variant::get_type_name(p_type));
 #endif
+			mark_local_written(p_target);
 			return;
 		}
 	}
@@ -1362,6 +1507,7 @@ void GDScriptByteCodeGenerator::write_construct(const Address &p_target, Variant
 	append(p_arguments.size());
 	append(p_type);
 	ct.cleanup();
+	mark_local_written(p_target);
 }
 
 void GDScriptByteCodeGenerator::write_construct_array(const Address &p_target, const Vector<Address> &p_arguments) {
@@ -1408,6 +1554,10 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
+	if (fold_operator_into_jump(p_condition, if_jmp_addrs)) {
+		return;
+	}
+
 	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
 	append(p_condition);
 	if_jmp_addrs.push_back(opcodes.size());
@@ -1612,10 +1762,15 @@ void GDScriptByteCodeGenerator::write_endfor() {
 void GDScriptByteCodeGenerator::start_while_condition() {
 	current_breaks_to_patch.push_back(List<int>());
 	continue_addrs.push_back(opcodes.size());
+	last_operator = LastOperator(); // The condition is a jump target.
 }
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
+	if (fold_operator_into_jump(p_condition, while_jmp_addrs)) {
+		return;
+	}
+
 	append_opcode(GDScriptFunction::OPCODE_JUMP_IF_NOT);
 	append(p_condition);
 	while_jmp_addrs.push_back(opcodes.size());
@@ -39,6 +39,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	struct StackSlot {
 		Variant::Type type = Variant::NIL;
 		Vector<int> bytecode_indices;
+		bool written = false; // Locals only: the declaration has stored a value of the slot type.
 
 		StackSlot() = default;
 		StackSlot(Variant::Type p_type) :
@@ -97,6 +98,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int max_locals = 0;
 	int current_line = 0;
 	int instr_args_max = 0;
+	int inline_cache_count = 0;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -157,6 +159,26 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	List<List<int>> current_breaks_to_patch;
 
+	// Last operator written into a temporary, so an assign or jump directly consuming its result
+	// can be folded into it instead of being emitted as a separate instruction.
+	struct LastOperator {
+		int position = -1;
+		int size = 0;
+		int temporary = -1;
+		Variant::Type result_type = Variant::NIL;
+	} last_operator;
+
+	bool is_last_operator_result(const Address &p_address) const {
+		return last_operator.position >= 0 && last_operator.position + last_operator.size == opcodes.size() && p_address.mode == Address::TEMPORARY && int(p_address.address) == last_operator.temporary;
+	}
+	bool fold_operator_into_assign(const Address &p_target, const Address &p_source);
+	bool fold_operator_into_jump(const Address &p_condition, List<int> &r_jump_addrs);
+	void mark_local_written(const Address &p_target) {
+		if (p_target.mode == Address::LOCAL_VARIABLE) {
+			locals.write[p_target.address - RESERVED_STACK].written = true;
+		}
+	}
+
 	void add_stack_identifier(const StringName &p_id, int p_stackpos) {
 		if (locals.size() > max_locals) {
 			max_locals = locals.size();
@@ -443,8 +465,14 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		opcodes.push_back(get_lambda_function_pos(p_lambda_function));
 	}
 
+	// Gives the instruction its own `GDScriptInlineCache`.
+	void append_inline_cache() {
+		opcodes.push_back(inline_cache_count++);
+	}
+
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		last_operator = LastOperator(); // The next instruction is a jump target.
 	}
 
 public:
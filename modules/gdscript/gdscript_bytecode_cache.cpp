@@ -0,0 +1,1896 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_bytecode_cache.h"
+
+#include "gdscript_analyzer.h"
+#include "gdscript_cache.h"
+#include "gdscript_compiler.h"
+#include "gdscript_parser.h"
+
+#include "core/config/engine.h"
+#include "core/config/project_settings.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/templates/rb_map.h"
+#include "core/version.h"
+
+class GDScriptBytecodeCache::Writer {
+	HashMap<String, uint32_t> string_map;
+	LocalVector<String> strings;
+	LocalVector<uint8_t> data;
+
+public:
+	_FORCE_INLINE_ void put_u8(uint8_t p_value) {
+		data.push_back(p_value);
+	}
+
+	void put_u32(uint32_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 4);
+		encode_uint32(p_value, &data[pos]);
+	}
+
+	void put_u64(uint64_t p_value) {
+		uint32_t pos = data.size();
+		data.resize(pos + 8);
+		encode_uint64(p_value, &data[pos]);
+	}
+
+	void put_raw_string(const String &p_string) {
+		CharString utf8 = p_string.utf8();
+		put_u32(utf8.length());
+		uint32_t pos = data.size();
+		data.resize(pos + utf8.length());
+		memcpy(data.ptr() + pos, utf8.get_data(), utf8.length());
+	}
+
+	// Strings in the body of the image are stored once, in a table written before it.
+	void put_string(const String &p_string) {
+		HashMap<String, uint32_t>::Iterator E = string_map.find(p_string);
+		if (E) {
+			put_u32(E->value);
+			return;
+		}
+		uint32_t index = strings.size();
+		strings.push_back(p_string);
+		string_map.insert(p_string, index);
+		put_u32(index);
+	}
+
+	Error put_value(const Variant &p_value) {
+		int len = 0;
+		Error err = encode_variant(p_value, nullptr, len, false);
+		ERR_FAIL_COND_V(err != OK, err);
+		put_u32(len);
+		uint32_t pos = data.size();
+		data.resize(pos + len);
+		return encode_variant(p_value, &data[pos], len, false);
+	}
+
+	void put_string_table(const Writer &p_body) {
+		put_u32(p_body.strings.size());
+		for (const String &string : p_body.strings) {
+			put_raw_string(string);
+		}
+	}
+
+	void append_to(Vector<uint8_t> &r_buffer) const {
+		int pos = r_buffer.size();
+		r_buffer.resize(pos + data.size());
+		memcpy(r_buffer.ptrw() + pos, data.ptr(), data.size());
+	}
+};
+
+class GDScriptBytecodeCache::Reader {
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t pos = 0;
+	bool failed = false;
+
+	LocalVector<String> strings;
+	LocalVector<StringName> names;
+
+	_FORCE_INLINE_ bool _has_space(uint32_t p_bytes) {
+		if (unlikely(failed || p_bytes > size - pos)) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	_FORCE_INLINE_ bool has_failed() const { return failed; }
+	_FORCE_INLINE_ void fail() { failed = true; }
+
+	void rewind(uint32_t p_bytes) {
+		ERR_FAIL_COND(p_bytes > pos);
+		pos -= p_bytes;
+	}
+
+	uint8_t get_u8() {
+		if (!_has_space(1)) {
+			return 0;
+		}
+		return data[pos++];
+	}
+
+	uint32_t get_u32() {
+		if (!_has_space(4)) {
+			return 0;
+		}
+		uint32_t value = decode_uint32(data + pos);
+		pos += 4;
+		return value;
+	}
+
+	uint64_t get_u64() {
+		if (!_has_space(8)) {
+			return 0;
+		}
+		uint64_t value = decode_uint64(data + pos);
+		pos += 8;
+		return value;
+	}
+
+	// Guards element counts against the remaining data, so a corrupted count can't trigger a huge allocation.
+	uint32_t get_count(uint32_t p_min_element_size = 1) {
+		uint32_t count = get_u32();
+		if (failed || count > (size - pos) / p_min_element_size) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_raw_string() {
+		uint32_t len = get_u32();
+		if (!_has_space(len)) {
+			return String();
+		}
+		String string;
+		if (string.parse_utf8((const char *)data + pos, len) != OK) {
+			failed = true;
+		}
+		pos += len;
+		return string;
+	}
+
+	bool read_string_table() {
+		uint32_t count = get_count(4);
+		strings.resize(count);
+		names.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			strings[i] = get_raw_string();
+		}
+		return !failed;
+	}
+
+	const String &get_string() {
+		static const String empty;
+		uint32_t index = get_u32();
+		if (failed || index >= strings.size()) {
+			failed = true;
+			return empty;
+		}
+		return strings[index];
+	}
+
+	StringName get_name() {
+		uint32_t index = get_u32();
+		if (failed || index >= strings.size()) {
+			failed = true;
+			return StringName();
+		}
+		StringName &name = names[index];
+		if (name == StringName() && !strings[index].is_empty()) {
+			name = strings[index];
+		}
+		return name;
+	}
+
+	bool get_value(Variant &r_value) {
+		uint32_t len = get_u32();
+		if (!_has_space(len)) {
+			return false;
+		}
+		int read = 0;
+		if (decode_variant(r_value, data + pos, len, &read, false) != OK || uint32_t(read) != len) {
+			failed = true;
+			return false;
+		}
+		pos += len;
+		return true;
+	}
+
+	Reader(const uint8_t *p_data, uint32_t p_size) :
+			data(p_data), size(p_size) {}
+};
+
+// Maps the native pointers stored in compiled functions back to the names they were resolved from.
+struct GDScriptBytecodeCache::Symbols {
+	struct OperatorKey {
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type left = Variant::NIL;
+		Variant::Type right = Variant::NIL;
+	};
+
+	struct MemberKey {
+		Variant::Type type = Variant::NIL;
+		StringName name;
+	};
+
+	struct ConstructorKey {
+		Variant::Type type = Variant::NIL;
+		int index = 0;
+	};
+
+	RBMap<Variant::ValidatedOperatorEvaluator, OperatorKey> operators;
+	RBMap<Variant::ValidatedSetter, MemberKey> setters;
+	RBMap<Variant::ValidatedGetter, MemberKey> getters;
+	RBMap<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setters;
+	RBMap<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getters;
+	RBMap<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setters;
+	RBMap<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getters;
+	RBMap<Variant::ValidatedBuiltInMethod, MemberKey> builtin_methods;
+	RBMap<Variant::ValidatedConstructor, ConstructorKey> constructors;
+	RBMap<Variant::ValidatedUtilityFunction, StringName> utilities;
+	RBMap<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utilities;
+
+	Symbols() {
+		// Different keys may share a pointer (e.g. identical evaluators folded by the linker). Any of them
+		// resolves to equivalent code, so keeping the first one is fine.
+		for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+			Variant::Type type = Variant::Type(i);
+
+			for (int op = 0; op < Variant::OP_MAX; op++) {
+				for (int j = 0; j < Variant::VARIANT_MAX; j++) {
+					Variant::ValidatedOperatorEvaluator evaluator = Variant::get_validated_operator_evaluator(Variant::Operator(op), type, Variant::Type(j));
+					if (evaluator && !operators.has(evaluator)) {
+						operators.insert(evaluator, { Variant::Operator(op), type, Variant::Type(j) });
+					}
+				}
+			}
+
+			List<StringName> members;
+			Variant::get_member_list(type, &members);
+			for (const StringName &E : members) {
+				Variant::ValidatedSetter setter = Variant::get_member_validated_setter(type, E);
+				if (setter && !setters.has(setter)) {
+					setters.insert(setter, { type, E });
+				}
+				Variant::ValidatedGetter getter = Variant::get_member_validated_getter(type, E);
+				if (getter && !getters.has(getter)) {
+					getters.insert(getter, { type, E });
+				}
+			}
+
+			Variant::ValidatedKeyedSetter keyed_setter = Variant::get_member_validated_keyed_setter(type);
+			if (keyed_setter && !keyed_setters.has(keyed_setter)) {
+				keyed_setters.insert(keyed_setter, type);
+			}
+			Variant::ValidatedKeyedGetter keyed_getter = Variant::get_member_validated_keyed_getter(type);
+			if (keyed_getter && !keyed_getters.has(keyed_getter)) {
+				keyed_getters.insert(keyed_getter, type);
+			}
+			Variant::ValidatedIndexedSetter indexed_setter = Variant::get_member_validated_indexed_setter(type);
+			if (indexed_setter && !indexed_setters.has(indexed_setter)) {
+				indexed_setters.insert(indexed_setter, type);
+			}
+			Variant::ValidatedIndexedGetter indexed_getter = Variant::get_member_validated_indexed_getter(type);
+			if (indexed_getter && !indexed_getters.has(indexed_getter)) {
+				indexed_getters.insert(indexed_getter, type);
+			}
+
+			List<StringName> methods;
+			Variant::get_builtin_method_list(type, &methods);
+			for (const StringName &E : methods) {
+				Variant::ValidatedBuiltInMethod method = Variant::get_validated_builtin_method(type, E);
+				if (method && !builtin_methods.has(method)) {
+					builtin_methods.insert(method, { type, E });
+				}
+			}
+
+			for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+				Variant::ValidatedConstructor constructor = Variant::get_validated_constructor(type, j);
+				if (constructor && !constructors.has(constructor)) {
+					constructors.insert(constructor, { type, j });
+				}
+			}
+		}
+
+		List<StringName> functions;
+		Variant::get_utility_function_list(&functions);
+		for (const StringName &E : functions) {
+			Variant::ValidatedUtilityFunction utility = Variant::get_validated_utility_function(E);
+			if (utility && !utilities.has(utility)) {
+				utilities.insert(utility, E);
+			}
+		}
+
+		functions.clear();
+		GDScriptUtilityFunctions::get_function_list(&functions);
+		for (const StringName &E : functions) {
+			GDScriptUtilityFunctions::FunctionPtr function = GDScriptUtilityFunctions::get_function(E);
+			if (function && !gds_utilities.has(function)) {
+				gds_utilities.insert(function, E);
+			}
+		}
+	}
+};
+
+template <typename K, typename V>
+static const V *_find_symbol(const RBMap<K, V> &p_map, const K &p_key) {
+	const typename RBMap<K, V>::Element *E = p_map.find(p_key);
+	return E ? &E->value() : nullptr;
+}
+
+struct GDScriptBytecodeCache::SaveContext {
+	GDScript *root = nullptr;
+	const Symbols *symbols = nullptr;
+	HashSet<String> dependencies;
+
+	HashMap<int, StringName> global_names;
+	HashMap<const Object *, StringName> global_objects;
+
+	SaveContext(GDScript *p_root, const Symbols *p_symbols) :
+			root(p_root), symbols(p_symbols) {
+		const Variant *global_array = GDScriptLanguage::get_singleton()->get_global_array();
+		for (const KeyValue<StringName, int> &E : GDScriptLanguage::get_singleton()->get_global_map()) {
+			global_names.insert(E.value, E.key);
+			if (global_array[E.value].get_type() == Variant::OBJECT) {
+				const Object *object = global_array[E.value].get_validated_object();
+				if (object && !global_objects.has(object)) {
+					global_objects.insert(object, E.key);
+				}
+			}
+		}
+	}
+};
+
+struct GDScriptBytecodeCache::LoadContext {
+	GDScript *root = nullptr;
+	String image_path;
+};
+
+struct GDScriptBytecodeCache::ClassData {
+	GDScript *script = nullptr;
+
+	bool tool = false;
+	Ref<GDScriptNativeClass> native;
+	Ref<GDScript> base;
+	HashMap<StringName, GDScript::MemberInfo> member_indices;
+	HashSet<StringName> members;
+	HashMap<StringName, GDScript::MemberInfo> static_variables_indices;
+	HashMap<StringName, Variant> constants;
+	HashMap<StringName, MethodInfo> signals;
+	Dictionary rpc_config;
+	HashMap<GDScriptFunction *, GDScript::LambdaInfo> lambda_info;
+
+	HashMap<StringName, GDScriptFunction *> member_functions;
+	GDScriptFunction *implicit_initializer = nullptr;
+	GDScriptFunction *implicit_ready = nullptr;
+	GDScriptFunction *static_initializer = nullptr;
+};
+
+Mutex GDScriptBytecodeCache::mutex;
+GDScriptBytecodeCache::Symbols *GDScriptBytecodeCache::symbols = nullptr;
+HashMap<String, uint64_t> GDScriptBytecodeCache::source_hashes;
+uint64_t GDScriptBytecodeCache::environment_hash = 0;
+bool GDScriptBytecodeCache::environment_hash_valid = false;
+
+String GDScriptBytecodeCache::_get_build_string() {
+	return String(VERSION_FULL_BUILD) + "." + String(VERSION_HASH);
+}
+
+const GDScriptBytecodeCache::Symbols &GDScriptBytecodeCache::_get_symbols() {
+	MutexLock lock(mutex);
+	if (!symbols) {
+		symbols = memnew(Symbols);
+	}
+	return *symbols;
+}
+
+// Autoloads and global class names change what identifiers compile to.
+uint64_t GDScriptBytecodeCache::_compute_environment_hash() {
+	List<String> entries;
+
+	for (const KeyValue<StringName, ProjectSettings::AutoloadInfo> &E : ProjectSettings::get_singleton()->get_autoload_list()) {
+		entries.push_back(vformat("autoload:%s:%s:%d", E.key, E.value.path, E.value.is_singleton));
+	}
+
+	List<StringName> global_classes;
+	ScriptServer::get_global_class_list(&global_classes);
+	for (const StringName &E : global_classes) {
+		entries.push_back(vformat("class:%s:%s", E, ScriptServer::get_global_class_path(E)));
+	}
+
+	entries.sort();
+
+	String environment;
+	for (const String &E : entries) {
+		environment += E + "\n";
+	}
+	return environment.hash64();
+}
+
+uint64_t GDScriptBytecodeCache::_get_environment_hash() {
+	MutexLock lock(mutex);
+	if (!environment_hash_valid) {
+		environment_hash = _compute_environment_hash();
+		environment_hash_valid = true;
+	}
+	return environment_hash;
+}
+
+bool GDScriptBytecodeCache::_get_source_hash(const String &p_path, bool p_use_cache, uint64_t &r_hash) {
+	if (p_use_cache) {
+		MutexLock lock(mutex);
+		HashMap<String, uint64_t>::Iterator E = source_hashes.find(p_path);
+		if (E) {
+			r_hash = E->value;
+			return true;
+		}
+	}
+
+	bool error = false;
+	String source = GDScript::get_raw_source_code(p_path, &error);
+	if (error) {
+		return false;
+	}
+	r_hash = source.hash64();
+
+	if (p_use_cache) {
+		MutexLock lock(mutex);
+		source_hashes[p_path] = r_hash;
+	}
+	return true;
+}
+
+void GDScriptBytecodeCache::_collect_dependencies(GDScriptAnalyzer *p_analyzer, HashSet<String> &r_dependencies) {
+	for (const KeyValue<String, Ref<GDScriptParserRef>> &E : p_analyzer->get_depended_parsers()) {
+		if (r_dependencies.has(E.key)) {
+			continue;
+		}
+		r_dependencies.insert(E.key);
+
+		// Dependencies only matter as far as the analyzer went into them.
+		if (E.value.is_valid() && E.value->get_status() >= GDScriptParserRef::INHERITANCE_SOLVED) {
+			_collect_dependencies(E.value->get_analyzer(), r_dependencies);
+		}
+	}
+}
+
+/* Saving */
+
+Error GDScriptBytecodeCache::_write_object(SaveContext &p_context, Writer &p_writer, const Variant &p_object) {
+	const Object *object = p_object.get_validated_object();
+	if (!object) {
+		p_writer.put_u8(VARIANT_TAG_NULL_OBJECT);
+		return OK;
+	}
+
+	HashMap<const Object *, StringName>::Iterator G = p_context.global_objects.find(object);
+	if (G) {
+		p_writer.put_u8(VARIANT_TAG_GLOBAL);
+		p_writer.put_string(G->value);
+		return OK;
+	}
+
+	GDScript *script = const_cast<GDScript *>(Object::cast_to<GDScript>(object));
+	if (script) {
+		GDScript *root = script->get_root_script();
+		if (root != p_context.root) {
+			if (root->path.is_empty() || root->path.contains("::")) {
+				return ERR_UNAVAILABLE; // Built-in script.
+			}
+			p_context.dependencies.insert(root->path);
+		}
+		p_writer.put_u8(VARIANT_TAG_SCRIPT);
+		p_writer.put_string(root->path);
+		p_writer.put_string(script->fully_qualified_name);
+		return OK;
+	}
+
+	const Resource *resource = Object::cast_to<Resource>(object);
+	if (resource && !resource->get_path().is_empty() && !resource->is_built_in()) {
+		p_writer.put_u8(VARIANT_TAG_RESOURCE);
+		p_writer.put_string(resource->get_path());
+		return OK;
+	}
+
+	return ERR_UNAVAILABLE;
+}
+
+Error GDScriptBytecodeCache::_write_variant(SaveContext &p_context, Writer &p_writer, const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			return _write_object(p_context, p_writer, p_value);
+		}
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			p_writer.put_u8(VARIANT_TAG_ARRAY);
+			p_writer.put_u8(array.get_typed_builtin());
+			p_writer.put_string(array.get_typed_class_name());
+			Error err = _write_object(p_context, p_writer, array.get_typed_script());
+			if (err) {
+				return err;
+			}
+			p_writer.put_u8(array.is_read_only());
+			p_writer.put_u32(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				err = _write_variant(p_context, p_writer, array[i]);
+				if (err) {
+					return err;
+				}
+			}
+			return OK;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dictionary = p_value;
+			p_writer.put_u8(VARIANT_TAG_DICTIONARY);
+			p_writer.put_u8(dictionary.is_read_only());
+			p_writer.put_u32(dictionary.size());
+			List<Variant> keys;
+			dictionary.get_key_list(&keys);
+			for (const Variant &E : keys) {
+				Error err = _write_variant(p_context, p_writer, E);
+				if (err) {
+					return err;
+				}
+				err = _write_variant(p_context, p_writer, dictionary[E]);
+				if (err) {
+					return err;
+				}
+			}
+			return OK;
+		}
+		case Variant::RID:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL: {
+			return ERR_UNAVAILABLE; // Only meaningful in the running instance.
+		}
+		default: {
+			p_writer.put_u8(VARIANT_TAG_VALUE);
+			return p_writer.put_value(p_value);
+		}
+	}
+}
+
+Error GDScriptBytecodeCache::_write_data_type(SaveContext &p_context, Writer &p_writer, const GDScriptDataType &p_type) {
+	p_writer.put_u8(p_type.has_type);
+	p_writer.put_u8(p_type.kind);
+	p_writer.put_u8(p_type.builtin_type);
+	p_writer.put_string(p_type.native_type);
+	if (p_type.kind == GDScriptDataType::SCRIPT || p_type.kind == GDScriptDataType::GDSCRIPT) {
+		Error err = _write_object(p_context, p_writer, Variant(p_type.script_type));
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_type.container_element_types.size());
+	for (int i = 0; i < p_type.container_element_types.size(); i++) {
+		Error err = _write_data_type(p_context, p_writer, p_type.container_element_types[i]);
+		if (err) {
+			return err;
+		}
+	}
+	return OK;
+}
+
+void GDScriptBytecodeCache::_write_property_info(Writer &p_writer, const PropertyInfo &p_info) {
+	p_writer.put_u8(p_info.type);
+	p_writer.put_string(p_info.name);
+	p_writer.put_string(p_info.class_name);
+	p_writer.put_u32(p_info.hint);
+	p_writer.put_string(p_info.hint_string);
+	p_writer.put_u32(p_info.usage);
+}
+
+Error GDScriptBytecodeCache::_write_method_info(SaveContext &p_context, Writer &p_writer, const MethodInfo &p_info) {
+	p_writer.put_string(p_info.name);
+	_write_property_info(p_writer, p_info.return_val);
+	p_writer.put_u32(p_info.flags);
+	p_writer.put_u32(p_info.id);
+	p_writer.put_u32(p_info.arguments.size());
+	for (const PropertyInfo &E : p_info.arguments) {
+		_write_property_info(p_writer, E);
+	}
+	p_writer.put_u32(p_info.default_arguments.size());
+	for (int i = 0; i < p_info.default_arguments.size(); i++) {
+		Error err = _write_variant(p_context, p_writer, p_info.default_arguments[i]);
+		if (err) {
+			return err;
+		}
+	}
+	return OK;
+}
+
+Error GDScriptBytecodeCache::_write_member_info(SaveContext &p_context, Writer &p_writer, const GDScript::MemberInfo &p_info) {
+	p_writer.put_u32(p_info.index);
+	p_writer.put_string(p_info.setter);
+	p_writer.put_string(p_info.getter);
+	_write_property_info(p_writer, p_info.property_info);
+	return _write_data_type(p_context, p_writer, p_info.data_type);
+}
+
+Error GDScriptBytecodeCache::_write_function(SaveContext &p_context, Writer &p_writer, const GDScriptFunction *p_function) {
+	const Symbols &syms = *p_context.symbols;
+	Error err = OK;
+
+	p_writer.put_string(p_function->name);
+	p_writer.put_string(p_function->source);
+	p_writer.put_u8(p_function->_static);
+
+	p_writer.put_u32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		err = _write_data_type(p_context, p_writer, p_function->argument_types[i]);
+		if (err) {
+			return err;
+		}
+	}
+	err = _write_data_type(p_context, p_writer, p_function->return_type);
+	if (err) {
+		return err;
+	}
+	err = _write_method_info(p_context, p_writer, p_function->method_info);
+	if (err) {
+		return err;
+	}
+	err = _write_variant(p_context, p_writer, p_function->rpc_config);
+	if (err) {
+		return err;
+	}
+
+	p_writer.put_u32(p_function->_initial_line);
+	p_writer.put_u32(p_function->_argument_count);
+	p_writer.put_u32(p_function->_stack_size);
+	p_writer.put_u32(p_function->_instruction_args_size);
+
+	p_writer.put_u32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		p_writer.put_u32(E.key);
+		p_writer.put_u8(E.value);
+	}
+
+	p_writer.put_u32(p_function->code.size());
+	for (int i = 0; i < p_function->code.size(); i++) {
+		p_writer.put_u32(p_function->code[i]);
+	}
+
+	// Indices into the global array depend on registration order, so they are relocated by name.
+	p_writer.put_u32(p_function->global_index_positions.size());
+	for (int i = 0; i < p_function->global_index_positions.size(); i++) {
+		int position = p_function->global_index_positions[i];
+		ERR_FAIL_INDEX_V(position, p_function->code.size(), ERR_BUG);
+		HashMap<int, StringName>::Iterator E = p_context.global_names.find(p_function->code[position]);
+		if (!E) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u32(position);
+		p_writer.put_string(E->value);
+	}
+
+	p_writer.put_u32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		p_writer.put_u32(p_function->default_arguments[i]);
+	}
+
+	p_writer.put_u32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		err = _write_variant(p_context, p_writer, p_function->constants[i]);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		p_writer.put_string(p_function->global_names[i]);
+	}
+
+	p_writer.put_u32(p_function->operator_funcs.size());
+	for (int i = 0; i < p_function->operator_funcs.size(); i++) {
+		const Symbols::OperatorKey *key = _find_symbol(syms.operators, p_function->operator_funcs[i]);
+		if (!key) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(key->op);
+		p_writer.put_u8(key->left);
+		p_writer.put_u8(key->right);
+	}
+
+	p_writer.put_u32(p_function->setters.size());
+	for (int i = 0; i < p_function->setters.size(); i++) {
+		const Symbols::MemberKey *key = _find_symbol(syms.setters, p_function->setters[i]);
+		if (!key) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(key->type);
+		p_writer.put_string(key->name);
+	}
+
+	p_writer.put_u32(p_function->getters.size());
+	for (int i = 0; i < p_function->getters.size(); i++) {
+		const Symbols::MemberKey *key = _find_symbol(syms.getters, p_function->getters[i]);
+		if (!key) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(key->type);
+		p_writer.put_string(key->name);
+	}
+
+	p_writer.put_u32(p_function->keyed_setters.size());
+	for (int i = 0; i < p_function->keyed_setters.size(); i++) {
+		const Variant::Type *type = _find_symbol(syms.keyed_setters, p_function->keyed_setters[i]);
+		if (!type) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(*type);
+	}
+
+	p_writer.put_u32(p_function->keyed_getters.size());
+	for (int i = 0; i < p_function->keyed_getters.size(); i++) {
+		const Variant::Type *type = _find_symbol(syms.keyed_getters, p_function->keyed_getters[i]);
+		if (!type) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(*type);
+	}
+
+	p_writer.put_u32(p_function->indexed_setters.size());
+	for (int i = 0; i < p_function->indexed_setters.size(); i++) {
+		const Variant::Type *type = _find_symbol(syms.indexed_setters, p_function->indexed_setters[i]);
+		if (!type) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(*type);
+	}
+
+	p_writer.put_u32(p_function->indexed_getters.size());
+	for (int i = 0; i < p_function->indexed_getters.size(); i++) {
+		const Variant::Type *type = _find_symbol(syms.indexed_getters, p_function->indexed_getters[i]);
+		if (!type) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(*type);
+	}
+
+	p_writer.put_u32(p_function->builtin_methods.size());
+	for (int i = 0; i < p_function->builtin_methods.size(); i++) {
+		const Symbols::MemberKey *key = _find_symbol(syms.builtin_methods, p_function->builtin_methods[i]);
+		if (!key) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(key->type);
+		p_writer.put_string(key->name);
+	}
+
+	p_writer.put_u32(p_function->constructors.size());
+	for (int i = 0; i < p_function->constructors.size(); i++) {
+		const Symbols::ConstructorKey *key = _find_symbol(syms.constructors, p_function->constructors[i]);
+		if (!key) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_u8(key->type);
+		p_writer.put_u32(key->index);
+	}
+
+	p_writer.put_u32(p_function->utilities.size());
+	for (int i = 0; i < p_function->utilities.size(); i++) {
+		const StringName *name = _find_symbol(syms.utilities, p_function->utilities[i]);
+		if (!name) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_string(*name);
+	}
+
+	p_writer.put_u32(p_function->gds_utilities.size());
+	for (int i = 0; i < p_function->gds_utilities.size(); i++) {
+		const StringName *name = _find_symbol(syms.gds_utilities, p_function->gds_utilities[i]);
+		if (!name) {
+			return ERR_UNAVAILABLE;
+		}
+		p_writer.put_string(*name);
+	}
+
+	p_writer.put_u32(p_function->methods.size());
+	for (int i = 0; i < p_function->methods.size(); i++) {
+		const MethodBind *method = p_function->methods[i];
+		p_writer.put_string(method->get_instance_class());
+		p_writer.put_string(method->get_name());
+	}
+
+	p_writer.put_u32(p_function->inline_caches.size());
+
+	p_writer.put_u32(p_function->lambdas.size());
+	for (int i = 0; i < p_function->lambdas.size(); i++) {
+		const GDScriptFunction *lambda = p_function->lambdas[i];
+		const GDScript::LambdaInfo *info = lambda->_script->lambda_info.getptr(const_cast<GDScriptFunction *>(lambda));
+		ERR_FAIL_NULL_V(info, ERR_BUG);
+		p_writer.put_u32(info->capture_count);
+		p_writer.put_u8(info->use_self);
+		err = _write_function(p_context, p_writer, lambda);
+		if (err) {
+			return err;
+		}
+	}
+
+	return OK;
+}
+
+void GDScriptBytecodeCache::_write_class_tree(Writer &p_writer, GDScript *p_script, LocalVector<GDScript *> &r_classes) {
+	r_classes.push_back(p_script);
+
+	p_writer.put_string(p_script->local_name);
+	p_writer.put_string(p_script->global_name);
+	p_writer.put_string(p_script->simplified_icon_path);
+
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		p_writer.put_string(E.value->fully_qualified_name);
+		_write_class_tree(p_writer, E.value.ptr(), r_classes);
+	}
+}
+
+Error GDScriptBytecodeCache::_write_class(SaveContext &p_context, Writer &p_writer, GDScript *p_script) {
+	Error err = OK;
+
+	p_writer.put_u8(p_script->tool);
+
+	err = _write_object(p_context, p_writer, p_script->native);
+	if (err) {
+		return err;
+	}
+	err = _write_object(p_context, p_writer, p_script->base);
+	if (err) {
+		return err;
+	}
+	// The base is looked at when compiling, even if nothing in the class refers to it explicitly.
+	for (GDScript *base = p_script->_base; base; base = base->_base) {
+		GDScript *root = base->get_root_script();
+		if (root != p_context.root) {
+			p_context.dependencies.insert(root->path);
+		}
+	}
+
+	p_writer.put_u32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		p_writer.put_string(E.key);
+		err = _write_member_info(p_context, p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->members.size());
+	for (const StringName &E : p_script->members) {
+		p_writer.put_string(E);
+	}
+
+	p_writer.put_u32(p_script->static_variables_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->static_variables_indices) {
+		p_writer.put_string(E.key);
+		err = _write_member_info(p_context, p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		p_writer.put_string(E.key);
+		err = _write_variant(p_context, p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->_signals.size());
+	for (const KeyValue<StringName, MethodInfo> &E : p_script->_signals) {
+		p_writer.put_string(E.key);
+		err = _write_method_info(p_context, p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	err = _write_variant(p_context, p_writer, p_script->rpc_config);
+	if (err) {
+		return err;
+	}
+
+	p_writer.put_u32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		p_writer.put_string(E.key);
+		err = _write_function(p_context, p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	GDScriptFunction *special_functions[] = { p_script->implicit_initializer, p_script->implicit_ready, p_script->static_initializer };
+	for (const GDScriptFunction *function : special_functions) {
+		p_writer.put_u8(function != nullptr);
+		if (function) {
+			err = _write_function(p_context, p_writer, function);
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	return OK;
+}
+
+Error GDScriptBytecodeCache::save(const Ref<GDScript> &p_script, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_COND_V(p_script.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(!p_script->is_valid(), ERR_INVALID_PARAMETER, "Cannot save the bytecode of a script that failed to compile.");
+	ERR_FAIL_COND_V_MSG(p_script->_owner != nullptr, ERR_INVALID_PARAMETER, "Only the root class of a script can be saved.");
+
+	GDScript *root = const_cast<GDScript *>(p_script.ptr());
+
+	// Analyze the script again to find everything the compiled code depends on, including the
+	// scripts whose interfaces were only used to infer types.
+	GDScriptParser parser;
+	Error err = parser.parse(root->source, root->path, false);
+	if (err) {
+		return err;
+	}
+	GDScriptAnalyzer analyzer(&parser);
+	err = analyzer.analyze();
+	if (err) {
+		return err;
+	}
+
+	SaveContext context(root, &_get_symbols());
+	_collect_dependencies(&analyzer, context.dependencies);
+
+	Writer body;
+	body.put_string(root->path);
+	body.put_string(root->fully_qualified_name);
+
+	LocalVector<GDScript *> classes;
+	_write_class_tree(body, root, classes);
+
+	bool has_static_data = false;
+	for (GDScript *E : classes) {
+		err = _write_class(context, body, E);
+		if (err) {
+			return err;
+		}
+		has_static_data = has_static_data || E->static_initializer != nullptr;
+	}
+
+	context.dependencies.erase(root->path);
+
+	uint32_t flags = 0;
+	if (root->debug_code) {
+		flags |= FLAG_DEBUG;
+	}
+	if (has_static_data && !parser.get_tree()->annotated_static_unload) {
+		flags |= FLAG_REGISTER_STATIC;
+	}
+
+	Writer header;
+	header.put_u8('G');
+	header.put_u8('D');
+	header.put_u8('B');
+	header.put_u8('C');
+	header.put_u32(FORMAT_VERSION);
+	header.put_raw_string(_get_build_string());
+	header.put_u32(flags);
+	header.put_u64(root->source.hash64());
+	header.put_u64(_compute_environment_hash());
+
+	header.put_u32(context.dependencies.size());
+	for (const String &E : context.dependencies) {
+		uint64_t hash = 0;
+		if (!_get_source_hash(E, false, hash)) {
+			return ERR_FILE_MISSING_DEPENDENCIES;
+		}
+		header.put_raw_string(E);
+		header.put_u64(hash);
+	}
+
+	header.put_string_table(body);
+
+	r_buffer.clear();
+	header.append_to(r_buffer);
+	body.append_to(r_buffer);
+	return OK;
+}
+
+Error GDScriptBytecodeCache::save_as(const String &p_path, bool p_debug, int p_optimization_level, Vector<uint8_t> &r_buffer) {
+	Ref<GDScript> script;
+	script.instantiate();
+	Error err = script->load_source_code(p_path);
+	if (err) {
+		return err;
+	}
+
+	GDScriptParser parser;
+	err = parser.parse(script->source, p_path, false);
+	if (err) {
+		return err;
+	}
+	GDScriptAnalyzer analyzer(&parser);
+	err = analyzer.analyze();
+	if (err) {
+		return err;
+	}
+
+	// A separate copy, so the script already loaded for this path keeps its code.
+	GDScriptCompiler compiler;
+	compiler.set_debug_code(p_debug);
+	compiler.set_optimization_level(GDScriptCompiler::OptimizationLevel(p_optimization_level));
+	compiler.set_detached(true);
+	err = compiler.compile(&parser, script.ptr());
+	if (err) {
+		return err;
+	}
+
+	return save(script, r_buffer);
+}
+
+Error GDScriptBytecodeCache::save_for_export(const Ref<GDScript> &p_script, const Vector<String> &p_features, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_COND_V(p_script.is_null(), ERR_INVALID_PARAMETER);
+
+	const bool debug = p_features.has("debug");
+	const GDScriptCompiler::OptimizationLevel optimization_level = GDScriptCompiler::get_optimization_level_for_features(p_features);
+	// Scripts are compiled here with the level set for this build's features.
+	if (debug == DEBUG_BUILD && optimization_level == GDScriptCompiler().get_optimization_level()) {
+		return save(p_script, r_buffer);
+	}
+	return save_as(p_script->get_path(), debug, optimization_level, r_buffer);
+}
+
+/* Loading */
+
+bool GDScriptBytecodeCache::_read_header(Reader &p_reader, const GDScript *p_script, bool p_debug, uint32_t &r_flags) {
+	if (p_reader.get_u8() != 'G' || p_reader.get_u8() != 'D' || p_reader.get_u8() != 'B' || p_reader.get_u8() != 'C') {
+		return false;
+	}
+	if (p_reader.get_u32() != FORMAT_VERSION) {
+		return false;
+	}
+	if (p_reader.get_raw_string() != _get_build_string()) {
+		return false;
+	}
+
+	r_flags = p_reader.get_u32();
+	if (bool(r_flags & FLAG_DEBUG) != p_debug) {
+		return false; // Debug and release builds generate different code.
+	}
+
+	if (p_reader.get_u64() != p_script->source.hash64()) {
+		return false;
+	}
+	if (p_reader.get_u64() != _get_environment_hash()) {
+		return false;
+	}
+	return !p_reader.has_failed();
+}
+
+bool GDScriptBytecodeCache::_check_dependencies(Reader &p_reader) {
+	uint32_t count = p_reader.get_count(12);
+	for (uint32_t i = 0; i < count; i++) {
+		String path = p_reader.get_raw_string();
+		uint64_t hash = p_reader.get_u64();
+		if (p_reader.has_failed()) {
+			return false;
+		}
+
+		uint64_t current_hash = 0;
+		if (!_get_source_hash(path, true, current_hash) || current_hash != hash) {
+			return false;
+		}
+	}
+	return !p_reader.has_failed();
+}
+
+bool GDScriptBytecodeCache::_read_object(LoadContext &p_context, Reader &p_reader, Variant &r_object) {
+	switch (p_reader.get_u8()) {
+		case VARIANT_TAG_NULL_OBJECT: {
+			r_object = Variant((Object *)nullptr);
+			return true;
+		}
+		case VARIANT_TAG_GLOBAL: {
+			StringName name = p_reader.get_name();
+			const HashMap<StringName, int>::ConstIterator E = GDScriptLanguage::get_singleton()->get_global_map().find(name);
+			if (!E) {
+				return false;
+			}
+			r_object = GDScriptLanguage::get_singleton()->get_global_array()[E->value];
+			return r_object.get_type() == Variant::OBJECT;
+		}
+		case VARIANT_TAG_SCRIPT: {
+			String path = p_reader.get_string();
+			String fqcn = p_reader.get_string();
+			if (p_reader.has_failed()) {
+				return false;
+			}
+
+			GDScript *script = nullptr;
+			if (path == p_context.image_path) {
+				script = p_context.root->find_class(fqcn);
+			} else {
+				Error err = OK;
+				Ref<GDScript> dependency = GDScriptCache::get_shallow_script(path, err, p_context.root->path);
+				if (dependency.is_valid()) {
+					script = dependency->find_class(fqcn);
+				}
+			}
+			if (!script) {
+				return false;
+			}
+			r_object = script;
+			return true;
+		}
+		case VARIANT_TAG_RESOURCE: {
+			String path = p_reader.get_string();
+			if (p_reader.has_failed()) {
+				return false;
+			}
+			Ref<Resource> resource = ResourceLoader::load(path);
+			if (resource.is_null()) {
+				return false;
+			}
+			r_object = resource;
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptBytecodeCache::_read_variant(LoadContext &p_context, Reader &p_reader, Variant &r_value) {
+	uint8_t tag = p_reader.get_u8();
+	switch (tag) {
+		case VARIANT_TAG_VALUE: {
+			return p_reader.get_value(r_value);
+		}
+		case VARIANT_TAG_ARRAY: {
+			uint32_t typed_builtin = p_reader.get_u8();
+			StringName typed_class_name = p_reader.get_name();
+			Variant typed_script;
+			if (!_read_object(p_context, p_reader, typed_script)) {
+				return false;
+			}
+			bool read_only = p_reader.get_u8();
+			uint32_t size = p_reader.get_count();
+
+			Array array;
+			if (typed_builtin != Variant::NIL) {
+				array.set_typed(typed_builtin, typed_class_name, typed_script);
+			}
+			array.resize(size);
+			for (uint32_t i = 0; i < size; i++) {
+				Variant element;
+				if (!_read_variant(p_context, p_reader, element)) {
+					return false;
+				}
+				array[i] = element;
+			}
+			if (read_only) {
+				array.make_read_only();
+			}
+			r_value = array;
+			return !p_reader.has_failed();
+		}
+		case VARIANT_TAG_DICTIONARY: {
+			bool read_only = p_reader.get_u8();
+			uint32_t size = p_reader.get_count(2);
+
+			Dictionary dictionary;
+			for (uint32_t i = 0; i < size; i++) {
+				Variant key;
+				Variant value;
+				if (!_read_variant(p_context, p_reader, key) || !_read_variant(p_context, p_reader, value)) {
+					return false;
+				}
+				dictionary[key] = value;
+			}
+			if (read_only) {
+				dictionary.make_read_only();
+			}
+			r_value = dictionary;
+			return !p_reader.has_failed();
+		}
+		case VARIANT_TAG_NULL_OBJECT:
+		case VARIANT_TAG_GLOBAL:
+		case VARIANT_TAG_SCRIPT:
+		case VARIANT_TAG_RESOURCE: {
+			p_reader.rewind(1);
+			return _read_object(p_context, p_reader, r_value);
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptBytecodeCache::_read_data_type(LoadContext &p_context, Reader &p_reader, GDScriptDataType &r_type) {
+	r_type.has_type = p_reader.get_u8();
+	uint8_t kind = p_reader.get_u8();
+	uint8_t builtin_type = p_reader.get_u8();
+	r_type.native_type = p_reader.get_name();
+	if (kind > GDScriptDataType::GDSCRIPT || builtin_type >= Variant::VARIANT_MAX) {
+		return false;
+	}
+	r_type.kind = GDScriptDataType::Kind(kind);
+	r_type.builtin_type = Variant::Type(builtin_type);
+
+	if (r_type.kind == GDScriptDataType::SCRIPT || r_type.kind == GDScriptDataType::GDSCRIPT) {
+		Variant script_type;
+		if (!_read_object(p_context, p_reader, script_type)) {
+			return false;
+		}
+		Script *script = Object::cast_to<Script>(script_type.get_validated_object());
+		r_type.script_type = script;
+
+		// Same as the compiler: classes of the script itself are only weakly referenced, to avoid cycles.
+		GDScript *gdscript = Object::cast_to<GDScript>(script);
+		if (r_type.kind == GDScriptDataType::SCRIPT || (gdscript && gdscript->get_root_script() != p_context.root)) {
+			r_type.script_type_ref = Ref<Script>(script);
+		}
+	}
+
+	uint32_t element_count = p_reader.get_count(4);
+	r_type.container_element_types.resize(element_count);
+	for (uint32_t i = 0; i < element_count; i++) {
+		if (!_read_data_type(p_context, p_reader, r_type.container_element_types.write[i])) {
+			return false;
+		}
+	}
+	return !p_reader.has_failed();
+}
+
+void GDScriptBytecodeCache::_read_property_info(Reader &p_reader, PropertyInfo &r_info) {
+	uint8_t type = p_reader.get_u8();
+	if (type >= Variant::VARIANT_MAX) {
+		p_reader.fail();
+		return;
+	}
+	r_info.type = Variant::Type(type);
+	r_info.name = p_reader.get_string();
+	r_info.class_name = p_reader.get_name();
+	r_info.hint = PropertyHint(p_reader.get_u32());
+	r_info.hint_string = p_reader.get_string();
+	r_info.usage = p_reader.get_u32();
+}
+
+bool GDScriptBytecodeCache::_read_method_info(LoadContext &p_context, Reader &p_reader, MethodInfo &r_info) {
+	r_info.name = p_reader.get_string();
+	_read_property_info(p_reader, r_info.return_val);
+	r_info.flags = p_reader.get_u32();
+	r_info.id = p_reader.get_u32();
+
+	uint32_t argument_count = p_reader.get_count();
+	for (uint32_t i = 0; i < argument_count; i++) {
+		PropertyInfo argument;
+		_read_property_info(p_reader, argument);
+		r_info.arguments.push_back(argument);
+	}
+
+	uint32_t default_count = p_reader.get_count();
+	r_info.default_arguments.resize(default_count);
+	for (uint32_t i = 0; i < default_count; i++) {
+		if (!_read_variant(p_context, p_reader, r_info.default_arguments.write[i])) {
+			return false;
+		}
+	}
+	return !p_reader.has_failed();
+}
+
+bool GDScriptBytecodeCache::_read_member_info(LoadContext &p_context, Reader &p_reader, GDScript::MemberInfo &r_info) {
+	r_info.index = p_reader.get_u32();
+	r_info.setter = p_reader.get_name();
+	r_info.getter = p_reader.get_name();
+	_read_property_info(p_reader, r_info.property_info);
+	return _read_data_type(p_context, p_reader, r_info.data_type);
+}
+
+// Reads a table of `count` entries, each turned into a pointer by `m_resolve`, and sets the pointer
+// and count fields the VM uses the same way `GDScriptByteCodeGenerator::write_end()` does.
+#define READ_FUNCTION_TABLE(m_table, m_resolve)                                  \
+	{                                                                            \
+		uint32_t count = p_reader.get_count();                                   \
+		function->m_table.resize(count);                                         \
+		for (uint32_t i = 0; i < count; i++) {                                   \
+			function->m_table.write[i] = m_resolve;                              \
+			if (p_reader.has_failed() || !function->m_table[i]) {                \
+				FAIL_FUNCTION;                                                   \
+			}                                                                    \
+		}                                                                        \
+		function->_##m_table##_count = count;                                    \
+		function->_##m_table##_ptr = count ? function->m_table.ptrw() : nullptr; \
+	}
+
+GDScriptFunction *GDScriptBytecodeCache::_read_function(LoadContext &p_context, Reader &p_reader, GDScript *p_script, ClassData &r_class) {
+#define FAIL_FUNCTION        \
+	{                        \
+		memdelete(function); \
+		return nullptr;      \
+	}
+
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	function->_script = p_script;
+
+	function->name = p_reader.get_name();
+	function->source = p_reader.get_name();
+	function->_static = p_reader.get_u8();
+
+	uint32_t argument_type_count = p_reader.get_count();
+	function->argument_types.resize(argument_type_count);
+	for (uint32_t i = 0; i < argument_type_count; i++) {
+		if (!_read_data_type(p_context, p_reader, function->argument_types.write[i])) {
+			FAIL_FUNCTION;
+		}
+	}
+	if (!_read_data_type(p_context, p_reader, function->return_type)) {
+		FAIL_FUNCTION;
+	}
+	if (!_read_method_info(p_context, p_reader, function->method_info)) {
+		FAIL_FUNCTION;
+	}
+	if (!_read_variant(p_context, p_reader, function->rpc_config)) {
+		FAIL_FUNCTION;
+	}
+
+	function->_initial_line = p_reader.get_u32();
+	function->_argument_count = p_reader.get_u32();
+	function->_stack_size = p_reader.get_u32();
+	function->_instruction_args_size = p_reader.get_u32();
+
+	uint32_t temporary_count = p_reader.get_count(5);
+	for (uint32_t i = 0; i < temporary_count; i++) {
+		int slot = p_reader.get_u32();
+		uint8_t type = p_reader.get_u8();
+		if (type >= Variant::VARIANT_MAX) {
+			FAIL_FUNCTION;
+		}
+		function->temporary_slots[slot] = Variant::Type(type);
+	}
+
+	uint32_t code_size = p_reader.get_count(4);
+	function->code.resize(code_size);
+	int *code = function->code.ptrw();
+	for (uint32_t i = 0; i < code_size; i++) {
+		code[i] = p_reader.get_u32();
+	}
+
+	uint32_t reloc_count = p_reader.get_count(8);
+	for (uint32_t i = 0; i < reloc_count; i++) {
+		uint32_t position = p_reader.get_u32();
+		StringName global = p_reader.get_name();
+		const HashMap<StringName, int>::ConstIterator E = GDScriptLanguage::get_singleton()->get_global_map().find(global);
+		if (p_reader.has_failed() || position >= code_size || !E) {
+			FAIL_FUNCTION;
+		}
+		code[position] = E->value;
+		function->global_index_positions.push_back(position);
+	}
+
+	uint32_t default_count = p_reader.get_count(4);
+	function->default_arguments.resize(default_count);
+	for (uint32_t i = 0; i < default_count; i++) {
+		uint32_t address = p_reader.get_u32();
+		if (address >= code_size) {
+			FAIL_FUNCTION;
+		}
+		function->default_arguments.write[i] = address;
+	}
+
+	uint32_t constant_count = p_reader.get_count();
+	function->constants.resize(constant_count);
+	for (uint32_t i = 0; i < constant_count; i++) {
+		if (!_read_variant(p_context, p_reader, function->constants.write[i])) {
+			FAIL_FUNCTION;
+		}
+	}
+
+	uint32_t global_name_count = p_reader.get_count(4);
+	function->global_names.resize(global_name_count);
+	for (uint32_t i = 0; i < global_name_count; i++) {
+		function->global_names.write[i] = p_reader.get_name();
+	}
+
+	if (p_reader.has_failed()) {
+		FAIL_FUNCTION;
+	}
+
+#ifdef DEBUG_ENABLED
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+#endif
+
+	function->_code_size = code_size;
+	function->_code_ptr = code_size ? code : nullptr;
+	function->_default_arg_count = default_count ? default_count - 1 : 0;
+	function->_default_arg_ptr = default_count ? function->default_arguments.ptr() : nullptr;
+	function->_constant_count = constant_count;
+	function->_constants_ptr = constant_count ? function->constants.ptrw() : nullptr;
+	function->_global_names_count = global_name_count;
+	function->_global_names_ptr = global_name_count ? function->global_names.ptr() : nullptr;
+
+	READ_FUNCTION_TABLE(operator_funcs, _read_operator(p_reader));
+	READ_FUNCTION_TABLE(setters, _read_setter(p_reader));
+	READ_FUNCTION_TABLE(getters, _read_getter(p_reader));
+	READ_FUNCTION_TABLE(keyed_setters, Variant::get_member_validated_keyed_setter(_read_type(p_reader)));
+	READ_FUNCTION_TABLE(keyed_getters, Variant::get_member_validated_keyed_getter(_read_type(p_reader)));
+	READ_FUNCTION_TABLE(indexed_setters, Variant::get_member_validated_indexed_setter(_read_type(p_reader)));
+	READ_FUNCTION_TABLE(indexed_getters, Variant::get_member_validated_indexed_getter(_read_type(p_reader)));
+	READ_FUNCTION_TABLE(builtin_methods, _read_builtin_method(p_reader));
+	READ_FUNCTION_TABLE(constructors, _read_constructor(p_reader));
+	READ_FUNCTION_TABLE(utilities, _read_utility(p_reader));
+	READ_FUNCTION_TABLE(gds_utilities, GDScriptUtilityFunctions::get_function(p_reader.get_name()));
+	READ_FUNCTION_TABLE(methods, _read_method_bind(p_reader));
+
+#ifdef DEBUG_ENABLED
+	// Names the disassembler and the VM's error messages use.
+	{
+		const Symbols &syms = _get_symbols();
+		for (int i = 0; i < function->operator_funcs.size(); i++) {
+			function->operator_names.push_back(Variant::get_operator_name(syms.operators[function->operator_funcs[i]].op));
+		}
+		for (int i = 0; i < function->setters.size(); i++) {
+			function->setter_names.push_back(syms.setters[function->setters[i]].name);
+		}
+		for (int i = 0; i < function->builtin_methods.size(); i++) {
+			function->builtin_methods_names.push_back(syms.builtin_methods[function->builtin_methods[i]].name);
+		}
+		for (int i = 0; i < function->constructors.size(); i++) {
+			function->constructors_names.push_back(Variant::get_type_name(syms.constructors[function->constructors[i]].type));
+		}
+		for (int i = 0; i < function->utilities.size(); i++) {
+			function->utilities_names.push_back(syms.utilities[function->utilities[i]]);
+		}
+		for (int i = 0; i < function->gds_utilities.size(); i++) {
+			function->gds_utilities_names.push_back(syms.gds_utilities[function->gds_utilities[i]]);
+		}
+	}
+#endif
+
+	// Caches start empty, only their number is stored. Each one belongs to an instruction.
+	uint32_t inline_cache_count = p_reader.get_u32();
+	if (p_reader.has_failed() || inline_cache_count > code_size) {
+		FAIL_FUNCTION;
+	}
+	function->inline_caches.resize(inline_cache_count);
+	function->_inline_caches_count = inline_cache_count;
+	function->_inline_caches_ptr = inline_cache_count ? function->inline_caches.ptrw() : nullptr;
+
+	uint32_t lambda_count = p_reader.get_count();
+	function->lambdas.resize(lambda_count);
+	function->lambdas.fill(nullptr);
+	for (uint32_t i = 0; i < lambda_count; i++) {
+		GDScript::LambdaInfo info;
+		info.capture_count = p_reader.get_u32();
+		info.use_self = p_reader.get_u8();
+		GDScriptFunction *lambda = _read_function(p_context, p_reader, p_script, r_class);
+		if (!lambda) {
+			function->lambdas.resize(i); // Only delete the lambdas read so far.
+			FAIL_FUNCTION;
+		}
+		function->lambdas.write[i] = lambda;
+		r_class.lambda_info.insert(lambda, info);
+	}
+	function->_lambdas_count = lambda_count;
+	function->_lambdas_ptr = lambda_count ? function->lambdas.ptrw() : nullptr;
+
+	return function;
+
+#undef FAIL_FUNCTION
+}
+
+#undef READ_FUNCTION_TABLE
+
+Variant::Type GDScriptBytecodeCache::_read_type(Reader &p_reader) {
+	uint8_t type = p_reader.get_u8();
+	if (type >= Variant::VARIANT_MAX) {
+		p_reader.fail();
+		return Variant::NIL;
+	}
+	return Variant::Type(type);
+}
+
+Variant::ValidatedOperatorEvaluator GDScriptBytecodeCache::_read_operator(Reader &p_reader) {
+	uint8_t op = p_reader.get_u8();
+	Variant::Type left = _read_type(p_reader);
+	Variant::Type right = _read_type(p_reader);
+	if (op >= Variant::OP_MAX || p_reader.has_failed()) {
+		return nullptr;
+	}
+	return Variant::get_validated_operator_evaluator(Variant::Operator(op), left, right);
+}
+
+Variant::ValidatedSetter GDScriptBytecodeCache::_read_setter(Reader &p_reader) {
+	Variant::Type type = _read_type(p_reader);
+	StringName name = p_reader.get_name();
+	if (p_reader.has_failed() || !Variant::has_member(type, name)) {
+		return nullptr;
+	}
+	return Variant::get_member_validated_setter(type, name);
+}
+
+Variant::ValidatedGetter GDScriptBytecodeCache::_read_getter(Reader &p_reader) {
+	Variant::Type type = _read_type(p_reader);
+	StringName name = p_reader.get_name();
+	if (p_reader.has_failed() || !Variant::has_member(type, name)) {
+		return nullptr;
+	}
+	return Variant::get_member_validated_getter(type, name);
+}
+
+Variant::ValidatedBuiltInMethod GDScriptBytecodeCache::_read_builtin_method(Reader &p_reader) {
+	Variant::Type type = _read_type(p_reader);
+	StringName name = p_reader.get_name();
+	if (p_reader.has_failed() || !Variant::has_builtin_method(type, name)) {
+		return nullptr;
+	}
+	return Variant::get_validated_builtin_method(type, name);
+}
+
+Variant::ValidatedConstructor GDScriptBytecodeCache::_read_constructor(Reader &p_reader) {
+	Variant::Type type = _read_type(p_reader);
+	uint32_t index = p_reader.get_u32();
+	if (p_reader.has_failed() || index >= uint32_t(Variant::get_constructor_count(type))) {
+		return nullptr;
+	}
+	return Variant::get_validated_constructor(type, index);
+}
+
+Variant::ValidatedUtilityFunction GDScriptBytecodeCache::_read_utility(Reader &p_reader) {
+	StringName name = p_reader.get_name();
+	if (p_reader.has_failed() || !Variant::has_utility_function(name)) {
+		return nullptr;
+	}
+	return Variant::get_validated_utility_function(name);
+}
+
+MethodBind *GDScriptBytecodeCache::_read_method_bind(Reader &p_reader) {
+	StringName class_name = p_reader.get_name();
+	StringName method_name = p_reader.get_name();
+	if (p_reader.has_failed()) {
+		return nullptr;
+	}
+	return ClassDB::get_method(class_name, method_name);
+}
+
+bool GDScriptBytecodeCache::_read_class(LoadContext &p_context, Reader &p_reader, ClassData &r_class) {
+	r_class.tool = p_reader.get_u8();
+
+	Variant native;
+	if (!_read_object(p_context, p_reader, native)) {
+		return false;
+	}
+	r_class.native = Ref<GDScriptNativeClass>(Object::cast_to<GDScriptNativeClass>(native.get_validated_object()));
+	if (r_class.native.is_null()) {
+		return false;
+	}
+
+	Variant base;
+	if (!_read_object(p_context, p_reader, base)) {
+		return false;
+	}
+	r_class.base = Ref<GDScript>(Object::cast_to<GDScript>(base.get_validated_object()));
+
+	uint32_t member_count = p_reader.get_count();
+	for (uint32_t i = 0; i < member_count; i++) {
+		StringName name = p_reader.get_name();
+		GDScript::MemberInfo info;
+		if (!_read_member_info(p_context, p_reader, info)) {
+			return false;
+		}
+		r_class.member_indices.insert(name, info);
+	}
+
+	uint32_t own_member_count = p_reader.get_count(4);
+	for (uint32_t i = 0; i < own_member_count; i++) {
+		r_class.members.insert(p_reader.get_name());
+	}
+
+	uint32_t static_variable_count = p_reader.get_count();
+	for (uint32_t i = 0; i < static_variable_count; i++) {
+		StringName name = p_reader.get_name();
+		GDScript::MemberInfo info;
+		if (!_read_member_info(p_context, p_reader, info)) {
+			return false;
+		}
+		r_class.static_variables_indices.insert(name, info);
+	}
+
+	uint32_t constant_count = p_reader.get_count();
+	for (uint32_t i = 0; i < constant_count; i++) {
+		StringName name = p_reader.get_name();
+		Variant value;
+		if (!_read_variant(p_context, p_reader, value)) {
+			return false;
+		}
+		r_class.constants.insert(name, value);
+	}
+
+	uint32_t signal_count = p_reader.get_count();
+	for (uint32_t i = 0; i < signal_count; i++) {
+		StringName name = p_reader.get_name();
+		MethodInfo info;
+		if (!_read_method_info(p_context, p_reader, info)) {
+			return false;
+		}
+		r_class.signals.insert(name, info);
+	}
+
+	Variant rpc_config;
+	if (!_read_variant(p_context, p_reader, rpc_config) || rpc_config.get_type() != Variant::DICTIONARY) {
+		return false;
+	}
+	r_class.rpc_config = rpc_config;
+
+	uint32_t function_count = p_reader.get_count();
+	for (uint32_t i = 0; i < function_count; i++) {
+		StringName name = p_reader.get_name();
+		GDScriptFunction *function = _read_function(p_context, p_reader, r_class.script, r_class);
+		if (!function) {
+			return false;
+		}
+		r_class.member_functions.insert(name, function);
+	}
+
+	GDScriptFunction **special_functions[] = { &r_class.implicit_initializer, &r_class.implicit_ready, &r_class.static_initializer };
+	for (GDScriptFunction **function : special_functions) {
+		if (p_reader.get_u8()) {
+			*function = _read_function(p_context, p_reader, r_class.script, r_class);
+			if (!*function) {
+				return false;
+			}
+		}
+	}
+
+	return !p_reader.has_failed();
+}
+
+void GDScriptBytecodeCache::_free_class_data(ClassData &p_class) {
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_class.member_functions) {
+		memdelete(E.value);
+	}
+	p_class.member_functions.clear();
+
+	GDScriptFunction **special_functions[] = { &p_class.implicit_initializer, &p_class.implicit_ready, &p_class.static_initializer };
+	for (GDScriptFunction **function : special_functions) {
+		if (*function) {
+			memdelete(*function);
+			*function = nullptr;
+		}
+	}
+	p_class.lambda_info.clear();
+}
+
+void GDScriptBytecodeCache::_apply_class_data(ClassData &p_class) {
+	GDScript *script = p_class.script;
+
+	script->tool = p_class.tool;
+	script->native = p_class.native;
+	script->base = p_class.base;
+	script->_base = p_class.base.ptr();
+	script->member_indices = p_class.member_indices;
+	script->members = p_class.members;
+	script->static_variables_indices = p_class.static_variables_indices;
+	script->static_variables.clear();
+	script->static_variables.resize(script->static_variables_indices.size());
+	script->constants = p_class.constants;
+	script->_signals = p_class.signals;
+	script->rpc_config = p_class.rpc_config;
+	script->lambda_info = p_class.lambda_info;
+
+	script->member_functions = p_class.member_functions;
+	script->implicit_initializer = p_class.implicit_initializer;
+	script->implicit_ready = p_class.implicit_ready;
+	script->static_initializer = p_class.static_initializer;
+
+	GDScriptFunction **initializer = script->member_functions.getptr(GDScriptLanguage::get_singleton()->strings._init);
+	script->initializer = initializer ? *initializer : nullptr;
+
+	script->valid = true;
+}
+
+// Mirrors `GDScriptCompiler::make_scripts()`, keeping the inner class scripts that already exist.
+void GDScriptBytecodeCache::_make_class_tree(Reader &p_reader, GDScript *p_script, LocalVector<GDScript *> &r_classes) {
+	r_classes.push_back(p_script);
+
+	p_script->local_name = p_reader.get_name();
+	p_script->global_name = p_reader.get_name();
+	p_script->simplified_icon_path = p_reader.get_string();
+
+	HashMap<StringName, Ref<GDScript>> old_subclasses = p_script->subclasses;
+	p_script->subclasses.clear();
+
+	uint32_t subclass_count = p_reader.get_count();
+	for (uint32_t i = 0; i < subclass_count && !p_reader.has_failed(); i++) {
+		StringName name = p_reader.get_name();
+		String fqcn = p_reader.get_string();
+		if (p_reader.has_failed()) {
+			return;
+		}
+
+		Ref<GDScript> subclass;
+		if (old_subclasses.has(name)) {
+			subclass = old_subclasses[name];
+		} else {
+			subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fqcn);
+		}
+
+		if (subclass.is_null()) {
+			subclass.instantiate();
+		}
+
+		subclass->_owner = p_script;
+		subclass->path = p_script->path;
+		subclass->fully_qualified_name = fqcn;
+		p_script->subclasses.insert(name, subclass);
+
+		_make_class_tree(p_reader, subclass.ptr(), r_classes);
+	}
+}
+
+bool GDScriptBytecodeCache::_open(Reader &p_reader, GDScript *p_script, bool p_debug, uint32_t &r_flags, LocalVector<GDScript *> &r_classes) {
+	if (!_read_header(p_reader, p_script, p_debug, r_flags) || !_check_dependencies(p_reader) || !p_reader.read_string_table()) {
+		return false;
+	}
+
+	const String &path = p_reader.get_string();
+	const String &fqcn = p_reader.get_string();
+	if (p_reader.has_failed() || path != p_script->path) {
+		return false;
+	}
+
+	p_script->fully_qualified_name = fqcn;
+	_make_class_tree(p_reader, p_script, r_classes);
+	return !p_reader.has_failed();
+}
+
+String GDScriptBytecodeCache::get_cache_path(const String &p_script_path) {
+	return p_script_path.get_basename() + ".gdbc";
+}
+
+bool GDScriptBytecodeCache::can_load(const String &p_script_path) {
+#ifdef TOOLS_ENABLED
+	if (Engine::get_singleton()->is_editor_hint()) {
+		return false; // Scripts are edited, always compile them.
+	}
+#endif
+	if (EngineDebugger::is_active()) {
+		return false; // The debugger needs stack and profiling information, which images don't have.
+	}
+	if (p_script_path.contains("::") || p_script_path.get_extension() != "gd") {
+		return false;
+	}
+	return FileAccess::exists(get_cache_path(p_script_path));
+}
+
+Error GDScriptBytecodeCache::make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer, bool p_debug) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Reader reader(p_buffer.ptr(), p_buffer.size());
+	uint32_t flags = 0;
+	LocalVector<GDScript *> classes;
+	return _open(reader, p_script, p_debug, flags, classes) ? OK : ERR_INVALID_DATA;
+}
+
+Error GDScriptBytecodeCache::make_scripts(GDScript *p_script) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Error err = OK;
+	Vector<uint8_t> buffer = FileAccess::get_file_as_bytes(get_cache_path(p_script->path), &err);
+	if (err) {
+		return err;
+	}
+	return make_scripts(p_script, buffer);
+}
+
+Error GDScriptBytecodeCache::load(GDScript *p_script, const Vector<uint8_t> &p_buffer, bool p_debug) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_script->_owner != nullptr, ERR_INVALID_PARAMETER);
+	if (p_script->valid || !p_script->member_functions.is_empty() || p_script->implicit_initializer) {
+		return ERR_ALREADY_IN_USE;
+	}
+
+	Reader reader(p_buffer.ptr(), p_buffer.size());
+	uint32_t flags = 0;
+	LocalVector<GDScript *> classes;
+	if (!_open(reader, p_script, p_debug, flags, classes)) {
+		return ERR_INVALID_DATA;
+	}
+
+	// Only fresh scripts are loaded, there is no state to keep when doing so.
+	for (const GDScript *E : classes) {
+		if (E->valid || !E->member_functions.is_empty() || E->implicit_initializer || E->static_initializer) {
+			return ERR_ALREADY_IN_USE;
+		}
+	}
+
+	LoadContext context;
+	context.root = p_script;
+	context.image_path = p_script->path;
+
+	// Decode everything before touching the scripts, so a bad image leaves them as they were.
+	LocalVector<ClassData> class_data;
+	class_data.resize(classes.size());
+	for (uint32_t i = 0; i < classes.size(); i++) {
+		class_data[i].script = classes[i];
+		if (!_read_class(context, reader, class_data[i])) {
+			for (uint32_t j = 0; j <= i; j++) {
+				_free_class_data(class_data[j]);
+			}
+			return ERR_INVALID_DATA;
+		}
+	}
+
+	for (ClassData &E : class_data) {
+		_apply_class_data(E);
+	}
+	p_script->debug_code = flags & FLAG_DEBUG;
+
+	if (flags & FLAG_REGISTER_STATIC) {
+		GDScriptCache::add_static_script(p_script);
+	}
+
+	if (p_script->path.is_empty()) {
+		return OK;
+	}
+	return GDScriptCache::finish_compiling(p_script->path);
+}
+
+Error GDScriptBytecodeCache::load(GDScript *p_script) {
+	ERR_FAIL_NULL_V(p_script, ERR_INVALID_PARAMETER);
+
+	Error err = OK;
+	Vector<uint8_t> buffer = FileAccess::get_file_as_bytes(get_cache_path(p_script->path), &err);
+	if (err) {
+		return err;
+	}
+	return load(p_script, buffer);
+}
+
+void GDScriptBytecodeCache::clear() {
+	MutexLock lock(mutex);
+	if (symbols) {
+		memdelete(symbols);
+		symbols = nullptr;
+	}
+	source_hashes.clear();
+	environment_hash = 0;
+	environment_hash_valid = false;
+}
@@ -0,0 +1,153 @@
+/**************************************************************************/
+/*  gdscript_bytecode_cache.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_CACHE_H
+#define GDSCRIPT_BYTECODE_CACHE_H
+
+#include "gdscript.h"
+#include "gdscript_function.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+
+class GDScriptAnalyzer;
+
+// Stores the compiled bytecode of a script next to its source (`res://foo.gd` -> `res://foo.gdbc`),
+// so exported projects can skip parsing, analyzing and compiling scripts when loading them.
+// Everything the compiler resolved to a native pointer (operator evaluators, method binds,
+// utility functions, global indices, ...) is stored by name and resolved again on load.
+// An image is only used if the engine build, the debug flavor and the sources of the script and
+// of every script its compilation depended on are the same as when it was saved; otherwise the
+// script is compiled from source as usual.
+class GDScriptBytecodeCache {
+	class Writer;
+	class Reader;
+	struct SaveContext;
+	struct LoadContext;
+	struct ClassData;
+	struct Symbols;
+
+	static constexpr uint32_t FORMAT_VERSION = 4;
+
+	enum Flags {
+		FLAG_DEBUG = 1,
+		FLAG_REGISTER_STATIC = 2,
+	};
+
+	enum VariantTag {
+		VARIANT_TAG_VALUE,
+		VARIANT_TAG_ARRAY,
+		VARIANT_TAG_DICTIONARY,
+		VARIANT_TAG_NULL_OBJECT,
+		VARIANT_TAG_GLOBAL,
+		VARIANT_TAG_SCRIPT,
+		VARIANT_TAG_RESOURCE,
+	};
+
+	static Mutex mutex;
+	static Symbols *symbols;
+	static HashMap<String, uint64_t> source_hashes;
+	static uint64_t environment_hash;
+	static bool environment_hash_valid;
+
+	static String _get_build_string();
+	static const Symbols &_get_symbols();
+	static uint64_t _compute_environment_hash();
+	static uint64_t _get_environment_hash();
+	static bool _get_source_hash(const String &p_path, bool p_use_cache, uint64_t &r_hash);
+	static void _collect_dependencies(GDScriptAnalyzer *p_analyzer, HashSet<String> &r_dependencies);
+
+	static Error _write_object(SaveContext &p_context, Writer &p_writer, const Variant &p_object);
+	static Error _write_variant(SaveContext &p_context, Writer &p_writer, const Variant &p_value);
+	static Error _write_data_type(SaveContext &p_context, Writer &p_writer, const GDScriptDataType &p_type);
+	static void _write_property_info(Writer &p_writer, const PropertyInfo &p_info);
+	static Error _write_method_info(SaveContext &p_context, Writer &p_writer, const MethodInfo &p_info);
+	static Error _write_member_info(SaveContext &p_context, Writer &p_writer, const GDScript::MemberInfo &p_info);
+	static Error _write_function(SaveContext &p_context, Writer &p_writer, const GDScriptFunction *p_function);
+	static void _write_class_tree(Writer &p_writer, GDScript *p_script, LocalVector<GDScript *> &r_classes);
+	static Error _write_class(SaveContext &p_context, Writer &p_writer, GDScript *p_script);
+
+	static bool _read_header(Reader &p_reader, const GDScript *p_script, bool p_debug, uint32_t &r_flags);
+	static bool _check_dependencies(Reader &p_reader);
+	static bool _read_object(LoadContext &p_context, Reader &p_reader, Variant &r_object);
+	static bool _read_variant(LoadContext &p_context, Reader &p_reader, Variant &r_value);
+	static bool _read_data_type(LoadContext &p_context, Reader &p_reader, GDScriptDataType &r_type);
+	static void _read_property_info(Reader &p_reader, PropertyInfo &r_info);
+	static bool _read_method_info(LoadContext &p_context, Reader &p_reader, MethodInfo &r_info);
+	static bool _read_member_info(LoadContext &p_context, Reader &p_reader, GDScript::MemberInfo &r_info);
+	static Variant::Type _read_type(Reader &p_reader);
+	static Variant::ValidatedOperatorEvaluator _read_operator(Reader &p_reader);
+	static Variant::ValidatedSetter _read_setter(Reader &p_reader);
+	static Variant::ValidatedGetter _read_getter(Reader &p_reader);
+	static Variant::ValidatedBuiltInMethod _read_builtin_method(Reader &p_reader);
+	static Variant::ValidatedConstructor _read_constructor(Reader &p_reader);
+	static Variant::ValidatedUtilityFunction _read_utility(Reader &p_reader);
+	static MethodBind *_read_method_bind(Reader &p_reader);
+	static GDScriptFunction *_read_function(LoadContext &p_context, Reader &p_reader, GDScript *p_script, ClassData &r_class);
+	static bool _read_class(LoadContext &p_context, Reader &p_reader, ClassData &r_class);
+	static void _free_class_data(ClassData &p_class);
+	static void _apply_class_data(ClassData &p_class);
+	static void _make_class_tree(Reader &p_reader, GDScript *p_script, LocalVector<GDScript *> &r_classes);
+	static bool _open(Reader &p_reader, GDScript *p_script, bool p_debug, uint32_t &r_flags, LocalVector<GDScript *> &r_classes);
+
+public:
+#ifdef DEBUG_ENABLED
+	static constexpr bool DEBUG_BUILD = true;
+#else
+	static constexpr bool DEBUG_BUILD = false;
+#endif
+
+	static String get_cache_path(const String &p_script_path);
+	static bool can_load(const String &p_script_path);
+
+	// Serializes a compiled script, including its inner classes. Fails with `ERR_UNAVAILABLE` when
+	// something in the script can't be referenced by name (e.g. a constant holding a built-in resource).
+	static Error save(const Ref<GDScript> &p_script, Vector<uint8_t> &r_buffer);
+	// Compiles the script at p_path again with the code of a debug or release build and the given
+	// optimization level (a `GDScriptCompiler::OptimizationLevel`), and serializes that.
+	static Error save_as(const String &p_path, bool p_debug, int p_optimization_level, Vector<uint8_t> &r_buffer);
+	// Serializes a script the way it's compiled for a target with these features: images are only
+	// loaded by builds of their own type, and the optimization level may be overridden per feature.
+	// The script is compiled again unless it was compiled the same way in this build.
+	static Error save_for_export(const Ref<GDScript> &p_script, const Vector<String> &p_features, Vector<uint8_t> &r_buffer);
+
+	// Creates the inner class scripts of a shallow script from its image, instead of parsing the source.
+	static Error make_scripts(GDScript *p_script);
+	static Error make_scripts(GDScript *p_script, const Vector<uint8_t> &p_buffer, bool p_debug = DEBUG_BUILD);
+	// Replaces compilation of a script that wasn't compiled yet with the contents of its image.
+	static Error load(GDScript *p_script);
+	static Error load(GDScript *p_script, const Vector<uint8_t> &p_buffer, bool p_debug = DEBUG_BUILD);
+
+	static void clear();
+};
+
+#endif // GDSCRIPT_BYTECODE_CACHE_H
@@ -32,12 +32,16 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_compiler.h"
 #include "gdscript_parser.h"
 
 #include "core/io/file_access.h"
+#include "core/io/resource_uid.h"
+#include "core/templates/parallel.h"
 #include "core/templates/vector.h"
 #include "scene/resources/packed_scene.h"
+#include "servers/text_server.h"
 
 bool GDScriptParserRef::is_valid() const {
 	return parser != nullptr;
@@ -260,9 +264,11 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, Error &r_e
 		return Ref<GDScript>(); // Returns null and does not cache when the script fails to load.
 	}
 
-	Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
-	if (r_error == OK) {
-		GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+	if (!GDScriptBytecodeCache::can_load(p_path) || GDScriptBytecodeCache::make_scripts(script.ptr()) != OK) {
+		Ref<GDScriptParserRef> parser_ref = get_parser(p_path, GDScriptParserRef::PARSED, r_error);
+		if (r_error == OK) {
+			GDScriptCompiler::make_scripts(script.ptr(), parser_ref->get_parser()->get_tree(), true);
+		}
 	}
 
 	singleton->shallow_gdscript_cache[p_path] = script;
@@ -307,6 +313,7 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 
 	singleton->full_gdscript_cache[p_path] = script;
 	singleton->shallow_gdscript_cache.erase(p_path);
+	singleton->parsed_scripts.erase(p_path); // Scripts that still depend on it hold their own reference.
 
 	return script;
 }
@@ -417,6 +424,95 @@ void GDScriptCache::clear_unreferenced_packed_scenes() {
 	}
 }
 
+void GDScriptCache::parse_scripts(const Vector<String> &p_paths) {
+	// Held throughout, so nothing else can use the parsers being filled. Parsing doesn't use the cache.
+	MutexLock lock(singleton->mutex);
+
+	if (singleton->cleared) {
+		return;
+	}
+
+#ifdef DEBUG_ENABLED
+	// The parser checks identifiers for spoofing, and text servers set up their checker on the first
+	// call without locking. Do it here, before parsing on other threads.
+	if (TextServerManager::get_singleton() && TS.is_valid() && TS->has_feature(TextServer::FEATURE_UNICODE_SECURITY)) {
+		TS->spoof_check("a");
+	}
+#endif
+
+	const String extension = GDScriptLanguage::get_singleton()->get_extension();
+	HashSet<String> visited;
+	Vector<String> pending = p_paths;
+
+	// Each round parses everything found by the previous one. Paths are sorted, and the references
+	// they contain are followed in that order, so the result doesn't depend on thread scheduling.
+	while (!pending.is_empty()) {
+		pending.sort();
+
+		LocalVector<Ref<GDScriptParserRef>> refs;
+		for (const String &path : pending) {
+			if (visited.has(path)) {
+				continue;
+			}
+			visited.insert(path);
+
+			if (path.get_extension() != extension || singleton->parser_map.has(path) || singleton->full_gdscript_cache.has(path) || singleton->shallow_gdscript_cache.has(path)) {
+				continue;
+			}
+			if (GDScriptBytecodeCache::can_load(path) || !FileAccess::exists(path)) {
+				continue;
+			}
+
+			Ref<GDScriptParserRef> ref;
+			ref.instantiate();
+			ref->parser = memnew(GDScriptParser);
+			ref->parser->set_collect_dependencies(true);
+			ref->path = path;
+			singleton->parser_map[path] = ref.ptr();
+			singleton->parsed_scripts[path] = ref;
+			refs.push_back(ref);
+		}
+
+		parallel_for(
+				0, refs.size(), [&refs](int64_t i) {
+					refs[i]->raise_status(GDScriptParserRef::PARSED);
+				},
+				1);
+
+		pending.clear();
+		for (const Ref<GDScriptParserRef> &ref : refs) {
+			const GDScriptParser *parser = ref->get_parser();
+			for (String path : parser->get_dependency_paths()) {
+				if (path.begins_with("uid://")) {
+					path = ResourceUID::get_singleton()->get_id_path(ResourceUID::get_singleton()->text_to_id(path));
+				} else if (path.is_relative_path()) {
+					path = ref->path.get_base_dir().path_join(path);
+				}
+				pending.push_back(path.simplify_path());
+			}
+			for (const StringName &name : parser->get_dependency_names()) {
+				if (ScriptServer::is_global_class(name) && ScriptServer::get_global_class_language(name) == GDScriptLanguage::get_singleton()->get_name()) {
+					pending.push_back(ScriptServer::get_global_class_path(name));
+				}
+			}
+		}
+	}
+
+	if (!singleton->parsed_scripts.is_empty()) {
+		singleton->has_parsed_scripts.set();
+	}
+}
+
+void GDScriptCache::release_parsed_scripts() {
+	if (singleton == nullptr || !singleton->has_parsed_scripts.is_set()) {
+		return;
+	}
+
+	MutexLock lock(singleton->mutex);
+	singleton->parsed_scripts.clear();
+	singleton->has_parsed_scripts.clear();
+}
+
 void GDScriptCache::clear() {
 	if (singleton == nullptr) {
 		return;
@@ -439,6 +535,9 @@ void GDScriptCache::clear() {
 			E->clear();
 	}
 
+	singleton->parsed_scripts.clear();
+	singleton->has_parsed_scripts.clear();
+
 	singleton->packed_scene_dependencies.clear();
 	singleton->packed_scene_cache.clear();
 
@@ -37,6 +37,7 @@
 #include "core/os/mutex.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
+#include "core/templates/safe_refcount.h"
 #include "scene/resources/packed_scene.h"
 
 class GDScriptAnalyzer;
@@ -83,6 +84,8 @@ class GDScriptCache {
 	HashMap<String, HashSet<String>> dependencies;
 	HashMap<String, Ref<PackedScene>> packed_scene_cache;
 	HashMap<String, HashSet<String>> packed_scene_dependencies;
+	HashMap<String, Ref<GDScriptParserRef>> parsed_scripts; // Kept alive until used, see `parse_scripts()`.
+	SafeFlag has_parsed_scripts;
 
 	friend class GDScript;
 	friend class GDScriptParserRef;
@@ -109,6 +112,12 @@ public:
 	static Ref<PackedScene> get_packed_scene(const String &p_path, Error &r_error, const String &p_owner = "");
 	static void clear_unreferenced_packed_scenes();
 
+	// Parses the given scripts, and the ones they reference, in parallel on the WorkerThreadPool.
+	// Their trees are then ready when the scripts are loaded. Scripts are analyzed and compiled
+	// on demand as usual.
+	static void parse_scripts(const Vector<String> &p_paths);
+	static void release_parsed_scripts();
+
 	static void clear();
 
 	GDScriptCache();
@@ -250,11 +250,60 @@ static bool _can_use_validate_call(const MethodBind *p_method, const Vector<GDSc
 	return true;
 }
 
+bool GDScriptCompiler::_is_debug_build_call(const GDScriptParser::ExpressionNode *p_expression) const {
+	if (p_expression->type != GDScriptParser::Node::CALL) {
+		return false;
+	}
+	const GDScriptParser::CallNode *call = static_cast<const GDScriptParser::CallNode *>(p_expression);
+	if (call->function_name != SNAME("is_debug_build") || !call->arguments.is_empty() || call->get_callee_type() != GDScriptParser::Node::SUBSCRIPT) {
+		return false;
+	}
+	const GDScriptParser::SubscriptNode *subscript = static_cast<const GDScriptParser::SubscriptNode *>(call->callee);
+	if (!subscript->is_attribute || subscript->base == nullptr || subscript->base->type != GDScriptParser::Node::IDENTIFIER) {
+		return false;
+	}
+	// The `OS` class itself, not something shadowing it.
+	const GDScriptParser::DataType base_type = subscript->base->get_datatype();
+	return base_type.is_meta_type && base_type.kind == GDScriptParser::DataType::NATIVE && base_type.native_type == SNAME("OS");
+}
+
+// Whether a branch condition is known at compile time, given the optimization level.
+bool GDScriptCompiler::_get_constant_condition(const GDScriptParser::ExpressionNode *p_condition, bool &r_value) const {
+	if (optimization_level < OPTIMIZATION_CONSTANT_BRANCHES) {
+		return false;
+	}
+
+	if (p_condition->is_constant && !(p_condition->get_datatype().is_meta_type && p_condition->get_datatype().kind == GDScriptParser::DataType::CLASS)) {
+		r_value = p_condition->reduced_value.booleanize();
+		return true;
+	}
+
+	if (optimization_level >= OPTIMIZATION_BUILD_CONSTANTS) {
+		if (_is_debug_build_call(p_condition)) {
+			r_value = debug_code;
+			return true;
+		}
+		if (p_condition->type == GDScriptParser::Node::UNARY_OPERATOR) {
+			const GDScriptParser::UnaryOpNode *unary = static_cast<const GDScriptParser::UnaryOpNode *>(p_condition);
+			if (unary->operation == GDScriptParser::UnaryOpNode::OP_LOGIC_NOT && _get_constant_condition(unary->operand, r_value)) {
+				r_value = !r_value;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root, bool p_initializer, const GDScriptCodeGenerator::Address &p_index_addr) {
 	if (p_expression->is_constant && !(p_expression->get_datatype().is_meta_type && p_expression->get_datatype().kind == GDScriptParser::DataType::CLASS)) {
 		return codegen.add_constant(p_expression->reduced_value);
 	}
 
+	if (optimization_level >= OPTIMIZATION_BUILD_CONSTANTS && _is_debug_build_call(p_expression)) {
+		return codegen.add_constant(debug_code);
+	}
+
 	GDScriptCodeGenerator *gen = codegen.generator;
 
 	switch (p_expression->type) {
@@ -1866,10 +1915,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 	for (int i = 0; i < p_block->statements.size(); i++) {
 		const GDScriptParser::Node *s = p_block->statements[i];
 
-#ifdef DEBUG_ENABLED
-		// Add a newline before each statement, since the debugger needs those.
-		gen->write_newline(s->start_line);
-#endif
+		if (debug_code) {
+			// Add a newline before each statement, since the debugger needs those.
+			gen->write_newline(s->start_line);
+		}
 
 		switch (s->type) {
 			case GDScriptParser::Node::MATCH: {
@@ -1918,10 +1967,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 					// Add locals in block before patterns, so temporaries don't use the stack address for binds.
 					List<GDScriptCodeGenerator::Address> branch_locals = _add_locals_in_block(codegen, branch->block);
 
-#ifdef DEBUG_ENABLED
-					// Add a newline before each branch, since the debugger needs those.
-					gen->write_newline(branch->start_line);
-#endif
+					if (debug_code) {
+						// Add a newline before each branch, since the debugger needs those.
+						gen->write_newline(branch->start_line);
+					}
 					// For each pattern in branch.
 					GDScriptCodeGenerator::Address pattern_result = codegen.add_temporary();
 					for (int k = 0; k < branch->patterns.size(); k++) {
@@ -1975,6 +2024,20 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			} break;
 			case GDScriptParser::Node::IF: {
 				const GDScriptParser::IfNode *if_n = static_cast<const GDScriptParser::IfNode *>(s);
+
+				bool constant_condition = false;
+				if (_get_constant_condition(if_n->condition, constant_condition)) {
+					// Only compile the branch that can run.
+					const GDScriptParser::SuiteNode *block = constant_condition ? if_n->true_block : if_n->false_block;
+					if (block) {
+						err = _parse_block(codegen, block);
+						if (err) {
+							return err;
+						}
+					}
+					break;
+				}
+
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, if_n->condition);
 				if (err) {
 					return err;
@@ -2035,6 +2098,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 			case GDScriptParser::Node::WHILE: {
 				const GDScriptParser::WhileNode *while_n = static_cast<const GDScriptParser::WhileNode *>(s);
 
+				bool constant_condition = false;
+				if (_get_constant_condition(while_n->condition, constant_condition) && !constant_condition) {
+					break; // Never runs.
+				}
+
 				gen->start_while_condition();
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, while_n->condition);
@@ -2084,7 +2152,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				}
 			} break;
 			case GDScriptParser::Node::ASSERT: {
-#ifdef DEBUG_ENABLED
+				if (!debug_code) {
+					break;
+				}
 				const GDScriptParser::AssertNode *as = static_cast<const GDScriptParser::AssertNode *>(s);
 
 				GDScriptCodeGenerator::Address condition = _parse_expression(codegen, err, as->condition);
@@ -2108,12 +2178,11 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 				if (message.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
 					codegen.generator->pop_temporary();
 				}
-#endif
 			} break;
 			case GDScriptParser::Node::BREAKPOINT: {
-#ifdef DEBUG_ENABLED
-				gen->write_breakpoint();
-#endif
+				if (debug_code) {
+					gen->write_breakpoint();
+				}
 			} break;
 			case GDScriptParser::Node::VARIABLE: {
 				const GDScriptParser::VariableNode *lv = static_cast<const GDScriptParser::VariableNode *>(s);
@@ -2183,6 +2252,10 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 		}
 
 		gen->clean_temporaries();
+
+		if (optimization_level >= OPTIMIZATION_CONSTANT_BRANCHES && (s->type == GDScriptParser::Node::RETURN || s->type == GDScriptParser::Node::BREAK || s->type == GDScriptParser::Node::CONTINUE)) {
+			break; // The rest of the block can't run.
+		}
 	}
 
 	if (p_add_locals && p_reset_locals) {
@@ -2591,6 +2664,9 @@ Error GDScriptCompiler::_prepare_compilation(GDScript *p_script, const GDScriptP
 
 	parsing_classes.insert(p_script);
 
+	// Members and functions are about to change, so cached lookups are no longer valid.
+	GDScriptInlineCache::invalidate();
+
 	p_script->clearing = true;
 
 	p_script->native = Ref<GDScriptNativeClass>();
@@ -3206,6 +3282,12 @@ Error GDScriptCompiler::compile(const GDScriptParser *p_parser, GDScript *p_scri
 	_get_function_ptr_replacements(func_ptr_replacements, old_lambda_info, &new_lambda_info);
 	main_script->_recurse_replace_function_ptrs(func_ptr_replacements);
 
+	main_script->debug_code = debug_code;
+
+	if (detached) {
+		return OK;
+	}
+
 	if (has_static_data && !root->annotated_static_unload) {
 		GDScriptCache::add_static_script(p_script);
 	}
@@ -3225,5 +3307,14 @@ int GDScriptCompiler::get_error_column() const {
 	return err_column;
 }
 
+GDScriptCompiler::OptimizationLevel GDScriptCompiler::get_optimization_level_for_features(const Vector<String> &p_features) {
+	const int level = ProjectSettings::get_singleton()->get_setting_with_override_and_custom_features("gdscript/compiler/optimization_level", p_features);
+	return OptimizationLevel(CLAMP(level, int(OPTIMIZATION_NONE), int(OPTIMIZATION_BUILD_CONSTANTS)));
+}
+
 GDScriptCompiler::GDScriptCompiler() {
+	// Breakpoints and stepping need every line as written.
+	if (!EngineDebugger::is_active()) {
+		optimization_level = CLAMP(int(GLOBAL_GET("gdscript/compiler/optimization_level")), int(OPTIMIZATION_NONE), int(OPTIMIZATION_BUILD_CONSTANTS));
+	}
 }
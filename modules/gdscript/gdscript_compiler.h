@@ -39,6 +39,15 @@
 #include "core/templates/hash_set.h"
 
 class GDScriptCompiler {
+public:
+	// Set with the `gdscript/compiler/optimization_level` project setting.
+	enum OptimizationLevel {
+		OPTIMIZATION_NONE, // Compile everything as written.
+		OPTIMIZATION_CONSTANT_BRANCHES, // Skip branches whose condition is constant, and statements after `return`, `break` or `continue`.
+		OPTIMIZATION_BUILD_CONSTANTS, // Also treat `OS.is_debug_build()` as a constant.
+	};
+
+private:
 	const GDScriptParser *parser = nullptr;
 	HashSet<GDScript *> parsed_classes;
 	HashSet<GDScript *> parsing_classes;
@@ -172,6 +181,15 @@ class GDScriptCompiler {
 	void _get_function_ptr_replacements(HashMap<GDScriptFunction *, GDScriptFunction *> &r_replacements, const FunctionLambdaInfo &p_old_info, const FunctionLambdaInfo *p_new_info);
 	void _get_function_ptr_replacements(HashMap<GDScriptFunction *, GDScriptFunction *> &r_replacements, const Vector<FunctionLambdaInfo> &p_old_infos, const Vector<FunctionLambdaInfo> *p_new_infos);
 	void _get_function_ptr_replacements(HashMap<GDScriptFunction *, GDScriptFunction *> &r_replacements, const ScriptLambdaInfo &p_old_info, const ScriptLambdaInfo *p_new_info);
+	bool _is_debug_build_call(const GDScriptParser::ExpressionNode *p_expression) const;
+	bool _get_constant_condition(const GDScriptParser::ExpressionNode *p_condition, bool &r_value) const;
+	int optimization_level = OPTIMIZATION_NONE;
+#ifdef DEBUG_ENABLED
+	bool debug_code = true;
+#else
+	bool debug_code = false;
+#endif
+	bool detached = false;
 	int err_line = 0;
 	int err_column = 0;
 	StringName source;
@@ -184,6 +202,19 @@ public:
 	static void make_scripts(GDScript *p_script, const GDScriptParser::ClassNode *p_class, bool p_keep_state);
 	Error compile(const GDScriptParser *p_parser, GDScript *p_script, bool p_keep_state = false);
 
+	void set_optimization_level(OptimizationLevel p_level) { optimization_level = p_level; }
+	OptimizationLevel get_optimization_level() const { return OptimizationLevel(optimization_level); }
+	// The level set for a target with these features, such as an export preset, including feature overrides.
+	static OptimizationLevel get_optimization_level_for_features(const Vector<String> &p_features);
+
+	// Whether to generate the code of a debug build (line markers, asserts, breakpoints, `OS.is_debug_build()`
+	// being true), which is the default in debug builds. Exports use it to compile for the other build type.
+	void set_debug_code(bool p_enable) { debug_code = p_enable; }
+	bool is_debug_code() const { return debug_code; }
+	// Compiles a copy of a script that doesn't take the place of the cached one: its static data isn't
+	// registered and GDScriptCache isn't told it finished compiling.
+	void set_detached(bool p_detached) { detached = p_detached; }
+
 	String get_error() const;
 	int get_error_line() const;
 	int get_error_column() const;
@@ -141,6 +141,64 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+
+#define DISASSEMBLE_SET_INDEXED_PACKED(m_type) \
+	case OPCODE_SET_INDEXED_##m_type: {        \
+		text += "set indexed (typed ";         \
+		text += #m_type;                       \
+		text += ") ";                          \
+		text += DADDR(1);                      \
+		text += "[";                           \
+		text += DADDR(2);                      \
+		text += "] = ";                        \
+		text += DADDR(3);                      \
+		incr += 4;                             \
+	} break
+
+#define DISASSEMBLE_GET_INDEXED_PACKED(m_type) \
+	case OPCODE_GET_INDEXED_##m_type: {        \
+		text += "get indexed (typed ";         \
+		text += #m_type;                       \
+		text += ") ";                          \
+		text += DADDR(3);                      \
+		text += " = ";                         \
+		text += DADDR(1);                      \
+		text += "[";                           \
+		text += DADDR(2);                      \
+		text += "]";                           \
+		incr += 4;                             \
+	} break
+
+#define DISASSEMBLE_PACKED_ARRAY_TYPES(m_macro) \
+	m_macro(PACKED_BYTE_ARRAY);                 \
+	m_macro(PACKED_INT32_ARRAY);                \
+	m_macro(PACKED_INT64_ARRAY);                \
+	m_macro(PACKED_FLOAT32_ARRAY);              \
+	m_macro(PACKED_FLOAT64_ARRAY);              \
+	m_macro(PACKED_STRING_ARRAY);               \
+	m_macro(PACKED_VECTOR2_ARRAY);              \
+	m_macro(PACKED_VECTOR3_ARRAY);              \
+	m_macro(PACKED_COLOR_ARRAY)
+
+#define DISASSEMBLE_OPERATOR_TYPED(m_name, m_operator) \
+	case OPCODE_OPERATOR_##m_name: {                   \
+		text += "typed operator ";                     \
+		text += DADDR(3);                              \
+		text += " = ";                                 \
+		text += DADDR(1);                              \
+		text += " " m_operator " ";                    \
+		text += DADDR(2);                              \
+		incr += 4;                                     \
+	} break
+
+				DISASSEMBLE_OPERATOR_TYPED(ADD_INT, "+");
+				DISASSEMBLE_OPERATOR_TYPED(SUBTRACT_INT, "-");
+				DISASSEMBLE_OPERATOR_TYPED(MULTIPLY_INT, "*");
+				DISASSEMBLE_OPERATOR_TYPED(LESS_INT, "<");
+				DISASSEMBLE_OPERATOR_TYPED(ADD_FLOAT, "+");
+				DISASSEMBLE_OPERATOR_TYPED(SUBTRACT_FLOAT, "-");
+				DISASSEMBLE_OPERATOR_TYPED(MULTIPLY_FLOAT, "*");
+				DISASSEMBLE_OPERATOR_TYPED(DIVIDE_FLOAT, "/");
 			case OPCODE_TYPE_TEST_BUILTIN: {
 				text += "type test ";
 				text += DADDR(1);
@@ -248,6 +306,8 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr += 5;
 			} break;
+			DISASSEMBLE_PACKED_ARRAY_TYPES(DISASSEMBLE_SET_INDEXED_PACKED);
+			DISASSEMBLE_PACKED_ARRAY_TYPES(DISASSEMBLE_GET_INDEXED_PACKED);
 			case OPCODE_GET_INDEXED_VALIDATED: {
 				text += "get indexed validated ";
 				text += DADDR(3);
@@ -288,7 +348,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				text += _global_names_ptr[_code_ptr[ip + 3]];
 				text += "\"]";
 
-				incr += 4;
+				incr += 5;
 			} break;
 			case OPCODE_GET_NAMED_VALIDATED: {
 				text += "get_named validated ";
@@ -590,7 +650,7 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 				}
 				text += ")";
 
-				incr = 5 + argc;
+				incr = 6 + argc;
 			} break;
 			case OPCODE_CALL_METHOD_BIND:
 			case OPCODE_CALL_METHOD_BIND_RET: {
@@ -894,6 +954,16 @@ void GDScriptFunction::disassemble(const Vector<String> &p_code_lines) const {
 
 				incr = 3;
 			} break;
+			case OPCODE_JUMP_IF_NOT_LESS_INT: {
+				text += "jump-if-not ";
+				text += DADDR(1);
+				text += " < ";
+				text += DADDR(2);
+				text += " to ";
+				text += itos(_code_ptr[ip + 3]);
+
+				incr = 4;
+			} break;
 			case OPCODE_JUMP_TO_DEF_ARGUMENT: {
 				text += "jump-to-default-argument ";
 
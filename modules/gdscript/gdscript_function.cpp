@@ -121,6 +121,10 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+	if (numeric_program) {
+		memdelete(numeric_program);
+	}
+
 	for (int i = 0; i < argument_types.size(); i++) {
 		argument_types.write[i].script_type_ref = Ref<Script>();
 	}
@@ -134,6 +138,68 @@ GDScriptFunction::~GDScriptFunction() {
 
 /////////////////////
 
+GDScriptFramePool::SizeClass GDScriptFramePool::size_classes[GDScriptFramePool::SIZE_CLASS_COUNT];
+
+int GDScriptFramePool::_get_size_class(uint32_t p_size) {
+	int size_class = 0;
+	while ((MIN_FRAME_SIZE << size_class) < p_size) {
+		size_class++;
+		if (size_class == SIZE_CLASS_COUNT) {
+			return -1;
+		}
+	}
+	return size_class;
+}
+
+uint8_t *GDScriptFramePool::allocate(uint32_t p_size) {
+	int size_class = _get_size_class(p_size);
+	if (size_class < 0) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	SizeClass &sc = size_classes[size_class];
+	sc.lock.lock();
+	if (!sc.frames.is_empty()) {
+		uint8_t *frame = sc.frames[sc.frames.size() - 1];
+		sc.frames.resize(sc.frames.size() - 1);
+		sc.lock.unlock();
+		return frame;
+	}
+	sc.lock.unlock();
+
+	return (uint8_t *)memalloc(MIN_FRAME_SIZE << size_class);
+}
+
+void GDScriptFramePool::release(uint8_t *p_frame, uint32_t p_size) {
+	int size_class = _get_size_class(p_size);
+	if (size_class >= 0) {
+		SizeClass &sc = size_classes[size_class];
+		sc.lock.lock();
+		if (sc.frames.size() < MAX_POOLED_FRAMES) {
+			sc.frames.push_back(p_frame);
+			p_frame = nullptr;
+		}
+		sc.lock.unlock();
+	}
+
+	if (p_frame) {
+		memfree(p_frame);
+	}
+}
+
+void GDScriptFramePool::clear() {
+	for (SizeClass &sc : size_classes) {
+		sc.lock.lock();
+		for (uint8_t *frame : sc.frames) {
+			memfree(frame);
+		}
+		sc.frames.reset();
+		sc.lock.unlock();
+	}
+}
+
+/////////////////////
+
 Variant GDScriptFunctionState::_signal_callback(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
 	Variant arg;
 	r_error.error = Callable::CallError::CALL_OK;
@@ -237,11 +303,11 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 			emit_signal(SNAME("completed"), ret);
 		}
 
-#ifdef DEBUG_ENABLED
-		if (EngineDebugger::is_active()) {
+		if (GDScriptLanguage::get_singleton()->is_tracking_call_stack()) {
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
 
+#ifdef DEBUG_ENABLED
 		_clear_stack();
 #endif
 	}
@@ -251,7 +317,7 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 
 void GDScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		// The first 3 are special addresses and not copied to the state, so we skip them here.
 		for (int i = 3; i < state.stack_size; i++) {
 			stack[i].~Variant();
@@ -288,4 +354,8 @@ GDScriptFunctionState::~GDScriptFunctionState() {
 		scripts_list.remove_from_list();
 		instances_list.remove_from_list();
 	}
+
+	if (state.stack) {
+		GDScriptFramePool::release(state.stack, state.alloca_size);
+	}
 }
@@ -31,12 +31,16 @@
 #ifndef GDSCRIPT_FUNCTION_H
 #define GDSCRIPT_FUNCTION_H
 
+#include "gdscript_inline_cache.h"
+#include "gdscript_numeric_tier.h"
 #include "gdscript_utility_functions.h"
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/pair.h"
 #include "core/templates/self_list.h"
 #include "core/variant/variant.h"
@@ -194,11 +198,40 @@ public:
 	~GDScriptDataType() {}
 };
 
+// Memory for the stacks of functions suspended by `await`, recycled by size class so that
+// coroutines awaiting in a loop don't go through the allocator every time.
+class GDScriptFramePool {
+	static constexpr uint32_t MIN_FRAME_SIZE = 128;
+	static constexpr int SIZE_CLASS_COUNT = 10; // Up to 64 KiB, bigger frames aren't pooled.
+	static constexpr uint32_t MAX_POOLED_FRAMES = 256; // Per size class.
+
+	struct SizeClass {
+		SpinLock lock;
+		LocalVector<uint8_t *> frames;
+	};
+	static SizeClass size_classes[SIZE_CLASS_COUNT];
+
+	static int _get_size_class(uint32_t p_size);
+
+public:
+	static uint8_t *allocate(uint32_t p_size);
+	static void release(uint8_t *p_frame, uint32_t p_size);
+	static void clear();
+};
+
 class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
 		OPCODE_OPERATOR_VALIDATED,
+		OPCODE_OPERATOR_ADD_INT,
+		OPCODE_OPERATOR_SUBTRACT_INT,
+		OPCODE_OPERATOR_MULTIPLY_INT,
+		OPCODE_OPERATOR_LESS_INT,
+		OPCODE_OPERATOR_ADD_FLOAT,
+		OPCODE_OPERATOR_SUBTRACT_FLOAT,
+		OPCODE_OPERATOR_MULTIPLY_FLOAT,
+		OPCODE_OPERATOR_DIVIDE_FLOAT,
 		OPCODE_TYPE_TEST_BUILTIN,
 		OPCODE_TYPE_TEST_ARRAY,
 		OPCODE_TYPE_TEST_NATIVE,
@@ -206,9 +239,27 @@ public:
 		OPCODE_SET_KEYED,
 		OPCODE_SET_KEYED_VALIDATED,
 		OPCODE_SET_INDEXED_VALIDATED,
+		OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_INT32_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_INT64_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_STRING_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY,
+		OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY,
 		OPCODE_GET_KEYED,
 		OPCODE_GET_KEYED_VALIDATED,
 		OPCODE_GET_INDEXED_VALIDATED,
+		OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_INT32_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_INT64_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_STRING_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY,
+		OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY,
 		OPCODE_SET_NAMED,
 		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
@@ -253,6 +304,7 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_JUMP_IF_NOT_LESS_INT,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_JUMP_IF_SHARED,
 		OPCODE_RETURN,
@@ -377,6 +429,8 @@ private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
 	friend class GDScriptLanguage;
+	friend class GDScriptBytecodeCache;
+	friend class GDScriptNumericTier;
 
 	StringName name;
 	StringName source;
@@ -414,6 +468,13 @@ private:
 	Vector<GDScriptUtilityFunctions::FunctionPtr> gds_utilities;
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
+	Vector<GDScriptInlineCache> inline_caches;
+	Vector<int> global_index_positions; // Code positions holding an index into the global array.
+
+	SafeNumeric<uint32_t> numeric_tier_calls;
+	SafeFlag numeric_tier_tried;
+	GDScriptNumericTier::Program *numeric_program = nullptr; // Only read once `numeric_tier_tried` is set.
+	GDScriptNumericTier::NativeFunction numeric_native = nullptr; // Same, compiled ahead of time from `numeric_program`.
 
 	int _code_size = 0;
 	int _default_arg_count = 0;
@@ -432,6 +493,7 @@ private:
 	int _gds_utilities_count = 0;
 	int _methods_count = 0;
 	int _lambdas_count = 0;
+	int _inline_caches_count = 0;
 
 	int *_code_ptr = nullptr;
 	const int *_default_arg_ptr = nullptr;
@@ -450,6 +512,7 @@ private:
 	const GDScriptUtilityFunctions::FunctionPtr *_gds_utilities_ptr = nullptr;
 	MethodBind **_methods_ptr = nullptr;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	GDScriptInlineCache *_inline_caches_ptr = nullptr;
 
 #ifdef DEBUG_ENABLED
 	CharString func_cname;
@@ -497,7 +560,7 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
+		uint8_t *stack = nullptr; // From `GDScriptFramePool`, `alloca_size` bytes.
 		int stack_size = 0;
 		uint32_t alloca_size = 0;
 		int ip = 0;
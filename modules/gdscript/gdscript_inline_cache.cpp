@@ -0,0 +1,267 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_inline_cache.h"
+
+#include "gdscript.h"
+#include "gdscript_function.h"
+
+#include "core/core_string_names.h"
+#include "core/object/class_db.h"
+#include "core/os/thread.h"
+
+SafeNumeric<uint32_t> GDScriptInlineCache::epoch;
+
+// Returns false for receivers the cache doesn't handle: placeholders and instances of other languages.
+static bool _get_gdscript_instance(Object *p_object, GDScriptInstance *&r_instance) {
+	ScriptInstance *si = p_object->get_script_instance();
+	if (!si) {
+		r_instance = nullptr;
+		return true;
+	}
+	if (si->is_placeholder() || si->get_language() != GDScriptLanguage::get_singleton()) {
+		return false;
+	}
+	r_instance = static_cast<GDScriptInstance *>(si);
+	return true;
+}
+
+// Method binds of these are never unregistered, unlike the ones of extensions.
+static bool _is_permanent_class(const StringName &p_class) {
+	ClassDB::APIType api = ClassDB::get_api_type(p_class);
+	return api == ClassDB::API_CORE || api == ClassDB::API_EDITOR;
+}
+
+const GDScriptInlineCache::Entry *GDScriptInlineCache::_find(const GDScript *p_script, const void *p_native_class) const {
+	for (const Entry &entry : entries) {
+		// Empty entries can be followed by filled ones, when a reused slot didn't resolve.
+		if (entry.kind == KIND_EMPTY) {
+			continue;
+		}
+		if (entry.script == p_script && entry.native_class == p_native_class) {
+			if (p_script && entry.epoch != epoch.get()) {
+				return nullptr;
+			}
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+GDScriptInlineCache::Entry *GDScriptInlineCache::_get_entry_to_fill(const GDScript *p_script, const void *p_native_class) {
+	if (is_megamorphic()) {
+		return nullptr;
+	}
+
+	const uint32_t current_epoch = epoch.get();
+	Entry *to_fill = nullptr;
+	bool refill = false;
+	for (Entry &entry : entries) {
+		if (entry.kind != KIND_EMPTY && entry.script == p_script && entry.native_class == p_native_class) {
+			// Stale entries for the same receiver are refilled in place. That's not a miss, the epoch
+			// changes whenever any script is compiled or freed.
+			to_fill = &entry;
+			refill = true;
+			break;
+		}
+		// Otherwise take the first empty slot, or one left by a script of an older epoch.
+		if (!to_fill && (entry.kind == KIND_EMPTY || (entry.script && entry.epoch != current_epoch))) {
+			to_fill = &entry;
+		}
+	}
+	if (!refill) {
+		misses++;
+	}
+	if (!to_fill) {
+		return nullptr;
+	}
+
+	to_fill->script = p_script;
+	to_fill->native_class = p_native_class;
+	to_fill->epoch = current_epoch;
+	to_fill->kind = KIND_EMPTY;
+	to_fill->index = -1;
+	to_fill->method = nullptr;
+	return to_fill;
+}
+
+bool GDScriptInlineCache::call(Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	GDScriptInstance *instance = nullptr;
+	if (!Thread::is_main_thread() || !_get_gdscript_instance(p_object, instance)) {
+		return false;
+	}
+	const GDScript *script = instance ? instance->script.ptr() : nullptr;
+	const StringName &native_class = p_object->get_class_name();
+
+	const Entry *entry = _find(script, native_class.data_unique_pointer());
+	if (!entry) {
+		// Both are special cased by the regular path.
+		if (p_method == CoreStringNames::get_singleton()->_free || p_method == SNAME("_ready")) {
+			return false;
+		}
+
+		Entry *new_entry = _get_entry_to_fill(script, native_class.data_unique_pointer());
+		if (!new_entry) {
+			return false;
+		}
+
+		// Same resolution order as `Object::callp()`: the script and its bases first, then the native class.
+		for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			HashMap<StringName, GDScriptFunction *>::ConstIterator E = sptr->member_functions.find(p_method);
+			if (E) {
+				new_entry->kind = KIND_SCRIPT_FUNCTION;
+				new_entry->function = E->value;
+				break;
+			}
+		}
+		if (new_entry->kind == KIND_EMPTY && _is_permanent_class(native_class)) {
+			MethodBind *method = ClassDB::get_method(native_class, p_method);
+			if (method) {
+				new_entry->kind = KIND_NATIVE_METHOD;
+				new_entry->method = method;
+			}
+		}
+		entry = new_entry;
+	}
+
+#ifdef DEBUG_ENABLED
+	// Like `Object::callp()`, so the receiver can't be freed while it runs one of its methods.
+	_ObjectDebugLock debug_lock(p_object);
+#endif
+
+	switch (entry->kind) {
+		case KIND_SCRIPT_FUNCTION: {
+			r_error.error = Callable::CallError::CALL_OK;
+			r_ret = entry->function->call(instance, p_args, p_argcount, r_error);
+			return true;
+		}
+		case KIND_NATIVE_METHOD: {
+			r_error.error = Callable::CallError::CALL_OK;
+			r_ret = entry->method->call(p_object, p_args, p_argcount, r_error);
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptInlineCache::get(Object *p_object, const StringName &p_name, Variant &r_ret) {
+	GDScriptInstance *instance = nullptr;
+	if (!Thread::is_main_thread() || !_get_gdscript_instance(p_object, instance)) {
+		return false;
+	}
+	const GDScript *script = instance ? instance->script.ptr() : nullptr;
+	const StringName &native_class = p_object->get_class_name();
+
+	const Entry *entry = _find(script, native_class.data_unique_pointer());
+	if (!entry) {
+		Entry *new_entry = _get_entry_to_fill(script, native_class.data_unique_pointer());
+		if (!new_entry) {
+			return false;
+		}
+
+		if (script) {
+			// Only script members are cached. Anything else goes through `GDScriptInstance::get()`,
+			// which can't be bypassed for native properties either, since scripts may shadow them.
+			HashMap<StringName, GDScript::MemberInfo>::ConstIterator E = script->member_indices.find(p_name);
+			if (E) {
+				new_entry->kind = KIND_SCRIPT_MEMBER;
+				new_entry->index = E->value.index;
+				new_entry->function = nullptr;
+				if (E->value.getter) {
+					for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+						HashMap<StringName, GDScriptFunction *>::ConstIterator F = sptr->member_functions.find(E->value.getter);
+						if (F) {
+							new_entry->function = F->value;
+							break;
+						}
+					}
+				}
+			}
+		} else if (_is_permanent_class(native_class)) {
+			// Same resolution order as `ClassDB::get_property()`, only properties with getters are cached.
+			const ClassDB::ClassInfo *check = ClassDB::classes.getptr(native_class);
+			while (check) {
+				const ClassDB::PropertySetGet *psg = check->property_setget.getptr(p_name);
+				if (psg) {
+					MethodBind *getter = nullptr;
+					if (psg->getter) {
+						getter = (psg->index < 0 && psg->_getptr) ? psg->_getptr : ClassDB::get_method(native_class, psg->getter);
+					}
+					if (getter) {
+						new_entry->kind = KIND_NATIVE_GETTER;
+						new_entry->index = psg->index;
+						new_entry->method = getter;
+					}
+					break;
+				}
+				if (check->constant_map.has(p_name) || check->method_map.has(p_name) || check->signal_map.has(p_name)) {
+					break;
+				}
+				check = check->inherits_ptr;
+			}
+		}
+		entry = new_entry;
+	}
+
+#ifdef DEBUG_ENABLED
+	// Like `Object::callp()`, so the receiver can't be freed while it runs one of its methods.
+	_ObjectDebugLock debug_lock(p_object);
+#endif
+
+	switch (entry->kind) {
+		case KIND_SCRIPT_MEMBER: {
+			if (entry->function) {
+				Callable::CallError err;
+				r_ret = entry->function->call(instance, nullptr, 0, err);
+				if (err.error == Callable::CallError::CALL_OK) {
+					return true;
+				}
+			}
+			r_ret = instance->members[entry->index];
+			return true;
+		}
+		case KIND_NATIVE_GETTER: {
+			Callable::CallError err;
+			if (entry->index >= 0) {
+				Variant index = entry->index;
+				const Variant *args[1] = { &index };
+				r_ret = entry->method->call(p_object, args, 1, err);
+			} else {
+				r_ret = entry->method->call(p_object, nullptr, 0, err);
+			}
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  gdscript_inline_cache.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_INLINE_CACHE_H
+#define GDSCRIPT_INLINE_CACHE_H
+
+#include "core/object/object.h"
+#include "core/templates/safe_refcount.h"
+
+class GDScript;
+class GDScriptFunction;
+class MethodBind;
+
+// Per call site cache for untyped `obj.name` and `obj.name()`, which otherwise look the name up
+// in the script instance and then in `ClassDB`, walking the class chain on every execution.
+// Each site remembers what it resolved to for up to `MAX_ENTRIES` receiver types, keyed by the
+// receiver's script and native class. Sites that keep missing are considered megamorphic, and
+// stop updating.
+// Script entries are only valid for the `epoch` they were filled in, which changes whenever a
+// script is compiled or freed. Refilling a stale entry for the same receiver isn't a miss. Native entries are only created for core and editor classes, whose
+// method binds are never unregistered.
+// Caches are only used on the main thread, other threads always take the regular path.
+class GDScriptInlineCache {
+public:
+	static constexpr int MAX_ENTRIES = 4;
+	static constexpr int MAX_MISSES = 16;
+
+private:
+	enum Kind : uint8_t {
+		KIND_EMPTY,
+		KIND_NATIVE_METHOD, // `method` is called.
+		KIND_NATIVE_GETTER, // `method` is called, with `index` as argument if it isn't -1.
+		KIND_SCRIPT_FUNCTION, // `function` is called.
+		KIND_SCRIPT_MEMBER, // `members[index]` is read, or `function` is called if it's the getter.
+	};
+
+	struct Entry {
+		const GDScript *script = nullptr;
+		const void *native_class = nullptr;
+		uint32_t epoch = 0;
+		Kind kind = KIND_EMPTY;
+		int index = -1;
+		union {
+			MethodBind *method = nullptr;
+			GDScriptFunction *function;
+		};
+	};
+
+	static SafeNumeric<uint32_t> epoch;
+
+	Entry entries[MAX_ENTRIES];
+	uint8_t misses = 0;
+
+	const Entry *_find(const GDScript *p_script, const void *p_native_class) const;
+	Entry *_get_entry_to_fill(const GDScript *p_script, const void *p_native_class);
+
+public:
+	static void invalidate() { epoch.increment(); }
+
+	// These return false when the cache can't handle the access. The caller then goes through the
+	// regular path, with the same result.
+	bool call(Object *p_object, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	bool get(Object *p_object, const StringName &p_name, Variant &r_ret);
+
+	bool is_megamorphic() const { return misses >= MAX_MISSES; }
+};
+
+#endif // GDSCRIPT_INLINE_CACHE_H
@@ -0,0 +1,964 @@
+/**************************************************************************/
+/*  gdscript_numeric_tier.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_numeric_tier.h"
+
+#include "gdscript.h"
+#include "gdscript_function.h"
+#include "gdscript_sampler.h"
+
+#include "core/debugger/engine_debugger.h"
+#include "core/variant/variant_internal.h"
+
+uint32_t GDScriptNumericTier::call_threshold = 1000;
+Mutex GDScriptNumericTier::mutex;
+HashMap<String, GDScriptNumericTier::NativeFunction> GDScriptNumericTier::native_functions;
+HashMap<String, int> GDScriptNumericTier::native_function_names;
+bool GDScriptNumericTier::has_native = false;
+
+static bool _is_numeric_type(Variant::Type p_type) {
+	return p_type == Variant::INT || p_type == Variant::FLOAT || p_type == Variant::BOOL;
+}
+
+static bool _is_numeric_data_type(const GDScriptDataType &p_type) {
+	return p_type.has_type && p_type.kind == GDScriptDataType::BUILTIN && _is_numeric_type(p_type.builtin_type);
+}
+
+bool GDScriptNumericTier::_can_leave_interpreter() {
+	// The sampler reads the call stack kept by the interpreter.
+	if (GDScriptSampler::is_running()) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	// Breakpoints, stepping and the profiler rely on the interpreter.
+	if (EngineDebugger::is_active() || GDScriptLanguage::get_singleton()->profiling) {
+		return false;
+	}
+#endif
+	return true;
+}
+
+class GDScriptNumericTier::Translator {
+	enum {
+		SCRATCH_COUNT = 2,
+	};
+
+	const GDScriptFunction *function = nullptr;
+	Program *program = nullptr;
+
+	// Static type of every register, NIL until something of a known type is stored in it.
+	LocalVector<Variant::Type> types;
+	// First instruction translated from each bytecode position, -1 inside instructions.
+	LocalVector<int> instruction_at;
+	LocalVector<uint32_t> jumps;
+
+	int constants_base = 0;
+	int scratch_base = 0;
+
+	const int *code = nullptr;
+	int ip = 0;
+
+	int emit(Operation p_op, int p_a = 0, int p_b = 0, int p_c = 0) {
+		Instruction instruction;
+		instruction.op = p_op;
+		instruction.a = p_a;
+		instruction.b = p_b;
+		instruction.c = p_c;
+		program->code.push_back(instruction);
+		return program->code.size() - 1;
+	}
+
+	void emit_jump(Operation p_op, int p_target, int p_a = 0, int p_b = 0, int p_c = 0) {
+		int index = emit(p_op, p_a, p_b, p_c);
+		program->code[index].d = p_target;
+		jumps.push_back(index);
+	}
+
+	// Returns the register holding the value at the given address, or -1 if it has no known numeric type.
+	int read(int p_address, Variant::Type &r_type) const {
+		int address_type = (p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		int reg = -1;
+		if (address_type == GDScriptFunction::ADDR_TYPE_STACK && index >= GDScriptFunction::FIXED_ADDRESSES_MAX && index < function->_stack_size) {
+			reg = index;
+		} else if (address_type == GDScriptFunction::ADDR_TYPE_CONSTANT && index < function->_constant_count) {
+			reg = constants_base + index;
+		}
+		if (reg < 0 || types[reg] == Variant::NIL) {
+			return -1;
+		}
+		r_type = types[reg];
+		return reg;
+	}
+
+	// Returns the register for a stack address, or -1 if it already holds a value of another type.
+	int write(int p_address, Variant::Type p_type) {
+		int address_type = (p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		if (address_type != GDScriptFunction::ADDR_TYPE_STACK || index < GDScriptFunction::FIXED_ADDRESSES_MAX || index >= function->_stack_size) {
+			return -1;
+		}
+		if (types[index] == Variant::NIL) {
+			types[index] = p_type;
+		} else if (types[index] != p_type) {
+			return -1;
+		}
+		return index;
+	}
+
+	int to_float(int p_reg, Variant::Type p_type, int p_scratch) {
+		if (p_type == Variant::FLOAT) {
+			return p_reg;
+		}
+		emit(OP_INT_TO_FLOAT, scratch_base + p_scratch, p_reg);
+		return scratch_base + p_scratch;
+	}
+
+	// Stores `p_src` (of `p_src_type`) converted to `p_type` into `p_dst`, as typed assignments and constructors do.
+	bool convert(int p_dst, int p_src, Variant::Type p_type, Variant::Type p_src_type) {
+		if (p_type == p_src_type) {
+			emit(OP_MOVE, p_dst, p_src);
+		} else if (p_type == Variant::FLOAT && p_src_type == Variant::INT) {
+			emit(OP_INT_TO_FLOAT, p_dst, p_src);
+		} else if (p_type == Variant::INT && p_src_type == Variant::FLOAT) {
+			emit(OP_FLOAT_TO_INT, p_dst, p_src);
+		} else {
+			return false;
+		}
+		return true;
+	}
+
+	bool operation(Variant::Operator p_operator, int p_a, Variant::Type p_a_type, int p_b, Variant::Type p_b_type, int p_dst_address) {
+		static const Operation int_ops[] = { OP_EQUAL_INT, OP_NOT_EQUAL_INT, OP_LESS_INT, OP_LESS_EQUAL_INT, OP_GREATER_INT, OP_GREATER_EQUAL_INT, OP_ADD_INT, OP_SUBTRACT_INT, OP_MULTIPLY_INT };
+		static const Operation float_ops[] = { OP_EQUAL_FLOAT, OP_NOT_EQUAL_FLOAT, OP_LESS_FLOAT, OP_LESS_EQUAL_FLOAT, OP_GREATER_FLOAT, OP_GREATER_EQUAL_FLOAT, OP_ADD_FLOAT, OP_SUBTRACT_FLOAT, OP_MULTIPLY_FLOAT };
+
+		Variant::Type result_type = Variant::get_operator_return_type(p_operator, p_a_type, p_b_type);
+		if (!_is_numeric_type(result_type)) {
+			return false;
+		}
+		int dst = write(p_dst_address, result_type);
+		if (dst < 0) {
+			return false;
+		}
+
+		switch (p_operator) {
+			case Variant::OP_NEGATE: {
+				emit(p_a_type == Variant::FLOAT ? OP_NEGATE_FLOAT : OP_NEGATE_INT, p_a, 0, dst);
+			} break;
+			case Variant::OP_POSITIVE: {
+				emit(OP_MOVE, dst, p_a);
+			} break;
+			case Variant::OP_NOT: {
+				if (p_a_type == Variant::FLOAT) {
+					return false;
+				}
+				emit(OP_NOT, p_a, 0, dst);
+			} break;
+			case Variant::OP_DIVIDE: {
+				if (p_a_type != Variant::FLOAT && p_b_type != Variant::FLOAT) {
+					return false; // Integer division checks for zero, left to the interpreter.
+				}
+				emit(OP_DIVIDE_FLOAT, to_float(p_a, p_a_type, 0), to_float(p_b, p_b_type, 1), dst);
+			} break;
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL:
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL:
+			case Variant::OP_ADD:
+			case Variant::OP_SUBTRACT:
+			case Variant::OP_MULTIPLY: {
+				// Same order as the operator enum, from OP_EQUAL to OP_MULTIPLY.
+				int index = p_operator - Variant::OP_EQUAL;
+				if ((p_a_type == Variant::BOOL) != (p_b_type == Variant::BOOL)) {
+					return false;
+				}
+				if (p_a_type == Variant::FLOAT || p_b_type == Variant::FLOAT) {
+					emit(float_ops[index], to_float(p_a, p_a_type, 0), to_float(p_b, p_b_type, 1), dst);
+				} else {
+					emit(int_ops[index], p_a, p_b, dst);
+				}
+			} break;
+			default: {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool validated_operation() {
+		Variant::Type a_type = Variant::NIL;
+		Variant::Type b_type = Variant::NIL;
+		int a = read(code[ip + 1], a_type);
+		int b = -1;
+		if (code[ip + 2] != GDScriptFunction::ADDR_NIL) {
+			b = read(code[ip + 2], b_type);
+			if (b < 0) {
+				return false;
+			}
+		}
+		int operator_index = code[ip + 4];
+		if (a < 0 || operator_index < 0 || operator_index >= function->_operator_funcs_count) {
+			return false;
+		}
+
+		// The operator is only known by its evaluator, find which one it is for these operand types.
+		static const Variant::Operator candidates[] = {
+			Variant::OP_EQUAL,
+			Variant::OP_NOT_EQUAL,
+			Variant::OP_LESS,
+			Variant::OP_LESS_EQUAL,
+			Variant::OP_GREATER,
+			Variant::OP_GREATER_EQUAL,
+			Variant::OP_ADD,
+			Variant::OP_SUBTRACT,
+			Variant::OP_MULTIPLY,
+			Variant::OP_DIVIDE,
+			Variant::OP_NEGATE,
+			Variant::OP_POSITIVE,
+			Variant::OP_NOT,
+		};
+		Variant::ValidatedOperatorEvaluator evaluator = function->_operator_funcs_ptr[operator_index];
+		for (Variant::Operator candidate : candidates) {
+			if (Variant::get_validated_operator_evaluator(candidate, a_type, b_type) == evaluator) {
+				return operation(candidate, a, a_type, b, b_type, code[ip + 3]);
+			}
+		}
+		return false;
+	}
+
+	bool typed_operation(Variant::Operator p_operator, Variant::Type p_type) {
+		Variant::Type a_type = Variant::NIL;
+		Variant::Type b_type = Variant::NIL;
+		int a = read(code[ip + 1], a_type);
+		int b = read(code[ip + 2], b_type);
+		if (a < 0 || b < 0 || a_type != p_type || b_type != p_type) {
+			return false;
+		}
+		return operation(p_operator, a, a_type, b, b_type, code[ip + 3]);
+	}
+
+	bool validated_construct(int p_argcount, int p_constructor_index) {
+		if (p_argcount > 1 || p_constructor_index < 0 || p_constructor_index >= function->_constructors_count) {
+			return false;
+		}
+		Variant::ValidatedConstructor constructor = function->_constructors_ptr[p_constructor_index];
+
+		static const Variant::Type numeric_types[] = { Variant::BOOL, Variant::INT, Variant::FLOAT };
+		for (Variant::Type type : numeric_types) {
+			for (int i = 0; i < Variant::get_constructor_count(type); i++) {
+				if (Variant::get_validated_constructor(type, i) != constructor || Variant::get_constructor_argument_count(type, i) != p_argcount) {
+					continue;
+				}
+				int dst = write(code[ip + 2 + p_argcount], type);
+				if (dst < 0) {
+					return false;
+				}
+				if (p_argcount == 0) {
+					emit(OP_LOAD_IMMEDIATE, dst, 0);
+					return true;
+				}
+				Variant::Type arg_type = Variant::NIL;
+				int arg = read(code[ip + 2], arg_type);
+				return arg >= 0 && arg_type == Variant::get_constructor_argument_type(type, i, 0) && convert(dst, arg, type, arg_type);
+			}
+		}
+		return false;
+	}
+
+	bool iterate(bool p_begin, Variant::Type p_type) {
+		Variant::Type container_type = Variant::NIL;
+		int container = read(code[ip + 2], container_type);
+		if (container < 0 || container_type != p_type) {
+			return false;
+		}
+		int counter = write(code[ip + 1], p_type);
+		int iterator = write(code[ip + 3], p_type);
+		if (counter < 0 || iterator < 0) {
+			return false;
+		}
+		Operation op;
+		if (p_type == Variant::INT) {
+			op = p_begin ? OP_ITERATE_BEGIN_INT : OP_ITERATE_INT;
+		} else {
+			op = p_begin ? OP_ITERATE_BEGIN_FLOAT : OP_ITERATE_FLOAT;
+		}
+		emit_jump(op, code[ip + 4], counter, container, iterator);
+		return true;
+	}
+
+	bool ret(int p_address, Variant::Type p_return_type) {
+		if (p_address == GDScriptFunction::ADDR_NIL && p_return_type == Variant::NIL) {
+			emit(OP_RETURN_NIL);
+			return true;
+		}
+		Variant::Type type = Variant::NIL;
+		int src = read(p_address, type);
+		if (src < 0) {
+			return false;
+		}
+		if (p_return_type == Variant::NIL || p_return_type == type) {
+			emit(OP_RETURN, src, type);
+			return true;
+		}
+		if (!convert(scratch_base, src, p_return_type, type)) {
+			return false;
+		}
+		emit(OP_RETURN, scratch_base, p_return_type);
+		return true;
+	}
+
+	// Translates the instruction at `ip` and returns its size, or 0 if it can't be translated.
+	int translate_instruction() {
+		const int remaining = function->_code_size - ip;
+
+#define REQUIRE_SPACE(m_size) \
+	if (remaining < (m_size)) \
+		return 0;
+
+		switch (code[ip]) {
+			case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+				REQUIRE_SPACE(5);
+				return validated_operation() ? 5 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_INT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_ADD, Variant::INT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_INT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_SUBTRACT, Variant::INT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_INT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_MULTIPLY, Variant::INT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_LESS_INT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_LESS, Variant::INT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_ADD_FLOAT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_ADD, Variant::FLOAT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_SUBTRACT_FLOAT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_SUBTRACT, Variant::FLOAT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_MULTIPLY_FLOAT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_MULTIPLY, Variant::FLOAT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_OPERATOR_DIVIDE_FLOAT: {
+				REQUIRE_SPACE(4);
+				return typed_operation(Variant::OP_DIVIDE, Variant::FLOAT) ? 4 : 0;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN: {
+				REQUIRE_SPACE(3);
+				Variant::Type type = Variant::NIL;
+				int src = read(code[ip + 2], type);
+				int dst = src < 0 ? -1 : write(code[ip + 1], type);
+				if (dst < 0) {
+					return 0;
+				}
+				emit(OP_MOVE, dst, src);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+			case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+				REQUIRE_SPACE(2);
+				int dst = write(code[ip + 1], Variant::BOOL);
+				if (dst < 0) {
+					return 0;
+				}
+				emit(OP_LOAD_IMMEDIATE, dst, code[ip] == GDScriptFunction::OPCODE_ASSIGN_TRUE ? 1 : 0);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+				REQUIRE_SPACE(4);
+				Variant::Type type = (Variant::Type)code[ip + 3];
+				Variant::Type src_type = Variant::NIL;
+				int src = read(code[ip + 2], src_type);
+				int dst = src < 0 ? -1 : write(code[ip + 1], type);
+				if (dst < 0 || !convert(dst, src, type, src_type)) {
+					return 0;
+				}
+				return 4;
+			}
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+			case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT: {
+				// Registers have a single type, so only the type needs to be recorded.
+				REQUIRE_SPACE(2);
+				Variant::Type type = code[ip] == GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL ? Variant::BOOL : (code[ip] == GDScriptFunction::OPCODE_TYPE_ADJUST_INT ? Variant::INT : Variant::FLOAT);
+				return write(code[ip + 1], type) < 0 ? 0 : 2;
+			}
+			case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED: {
+				REQUIRE_SPACE(2);
+				int instr_arg_count = code[ip + 1];
+				REQUIRE_SPACE(3 + instr_arg_count);
+				int argc = code[ip + 2 + instr_arg_count];
+				if (argc != instr_arg_count - 1 || !validated_construct(argc, code[ip + 3 + instr_arg_count])) {
+					return 0;
+				}
+				return 3 + instr_arg_count;
+			}
+			case GDScriptFunction::OPCODE_JUMP: {
+				REQUIRE_SPACE(2);
+				emit_jump(OP_JUMP, code[ip + 1]);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF:
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+				REQUIRE_SPACE(3);
+				Variant::Type type = Variant::NIL;
+				int test = read(code[ip + 1], type);
+				if (test < 0 || type == Variant::FLOAT) {
+					return 0;
+				}
+				emit_jump(code[ip] == GDScriptFunction::OPCODE_JUMP_IF ? OP_JUMP_IF : OP_JUMP_IF_NOT, code[ip + 2], test);
+				return 3;
+			}
+			case GDScriptFunction::OPCODE_JUMP_IF_NOT_LESS_INT: {
+				REQUIRE_SPACE(4);
+				Variant::Type a_type = Variant::NIL;
+				Variant::Type b_type = Variant::NIL;
+				int a = read(code[ip + 1], a_type);
+				int b = read(code[ip + 2], b_type);
+				if (a < 0 || b < 0 || a_type != Variant::INT || b_type != Variant::INT) {
+					return 0;
+				}
+				emit_jump(OP_JUMP_IF_NOT_LESS_INT, code[ip + 3], a, b);
+				return 4;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT: {
+				REQUIRE_SPACE(5);
+				return iterate(true, Variant::INT) ? 5 : 0;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_INT: {
+				REQUIRE_SPACE(5);
+				return iterate(false, Variant::INT) ? 5 : 0;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_BEGIN_FLOAT: {
+				REQUIRE_SPACE(5);
+				return iterate(true, Variant::FLOAT) ? 5 : 0;
+			}
+			case GDScriptFunction::OPCODE_ITERATE_FLOAT: {
+				REQUIRE_SPACE(5);
+				return iterate(false, Variant::FLOAT) ? 5 : 0;
+			}
+			case GDScriptFunction::OPCODE_RETURN: {
+				REQUIRE_SPACE(2);
+				return ret(code[ip + 1], Variant::NIL) ? 2 : 0;
+			}
+			case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN: {
+				REQUIRE_SPACE(3);
+				Variant::Type type = (Variant::Type)code[ip + 2];
+				if (!_is_numeric_type(type)) {
+					return 0;
+				}
+				return ret(code[ip + 1], type) ? 3 : 0;
+			}
+			case GDScriptFunction::OPCODE_LINE: {
+				REQUIRE_SPACE(2);
+				return 2;
+			}
+			case GDScriptFunction::OPCODE_END: {
+				emit(OP_RETURN_NIL);
+				return 1;
+			}
+			default: {
+				return 0;
+			}
+		}
+
+#undef REQUIRE_SPACE
+	}
+
+	// Registers read and written by an instruction. Iterations only write `c` when they don't jump.
+	static void get_operands(const Instruction &p_instruction, int (&r_reads)[2], int &r_read_count, int (&r_writes)[2], int &r_write_count, int &r_jump_write_count) {
+		r_read_count = 0;
+		r_write_count = 0;
+		switch (p_instruction.op) {
+			case OP_MOVE:
+			case OP_INT_TO_FLOAT:
+			case OP_FLOAT_TO_INT: {
+				r_reads[r_read_count++] = p_instruction.b;
+				r_writes[r_write_count++] = p_instruction.a;
+			} break;
+			case OP_LOAD_IMMEDIATE: {
+				r_writes[r_write_count++] = p_instruction.a;
+			} break;
+			case OP_NEGATE_INT:
+			case OP_NEGATE_FLOAT:
+			case OP_NOT: {
+				r_reads[r_read_count++] = p_instruction.a;
+				r_writes[r_write_count++] = p_instruction.c;
+			} break;
+			case OP_JUMP:
+			case OP_RETURN_NIL: {
+			} break;
+			case OP_JUMP_IF:
+			case OP_JUMP_IF_NOT:
+			case OP_RETURN: {
+				r_reads[r_read_count++] = p_instruction.a;
+			} break;
+			case OP_JUMP_IF_NOT_LESS_INT: {
+				r_reads[r_read_count++] = p_instruction.a;
+				r_reads[r_read_count++] = p_instruction.b;
+			} break;
+			case OP_ITERATE_BEGIN_INT:
+			case OP_ITERATE_BEGIN_FLOAT: {
+				r_reads[r_read_count++] = p_instruction.b;
+				r_writes[r_write_count++] = p_instruction.a;
+				r_writes[r_write_count++] = p_instruction.c;
+			} break;
+			case OP_ITERATE_INT:
+			case OP_ITERATE_FLOAT: {
+				r_reads[r_read_count++] = p_instruction.a;
+				r_reads[r_read_count++] = p_instruction.b;
+				r_writes[r_write_count++] = p_instruction.a;
+				r_writes[r_write_count++] = p_instruction.c;
+			} break;
+			default: {
+				// Binary operations.
+				r_reads[r_read_count++] = p_instruction.a;
+				r_reads[r_read_count++] = p_instruction.b;
+				r_writes[r_write_count++] = p_instruction.c;
+			} break;
+		}
+		r_jump_write_count = (p_instruction.op >= OP_ITERATE_BEGIN_INT && p_instruction.op <= OP_ITERATE_FLOAT) ? 1 : r_write_count;
+	}
+
+	// Types are assigned in code order, which doesn't mean every path stores a value before reading it.
+	// The interpreter reads `null` from locals that were never assigned, so those functions are rejected.
+	bool check_assignments() const {
+		const uint32_t register_count = program->registers.size();
+		const uint32_t code_size = program->code.size();
+
+		// Registers assigned on every path to each instruction. Starts full, except at the entry.
+		LocalVector<uint8_t> assigned;
+		assigned.resize(code_size * register_count);
+		memset(assigned.ptr(), 1, assigned.size());
+		for (uint32_t i = 0; i < register_count; i++) {
+			const bool argument = i >= GDScriptFunction::FIXED_ADDRESSES_MAX && i < GDScriptFunction::FIXED_ADDRESSES_MAX + program->argument_types.size();
+			assigned[i] = argument || (i >= (uint32_t)constants_base && i < (uint32_t)scratch_base);
+		}
+
+		LocalVector<uint8_t> out;
+		out.resize(register_count);
+		int reads[2];
+		int writes[2];
+		int read_count = 0;
+		int write_count = 0;
+		int jump_write_count = 0;
+
+		// Removes from the target what isn't assigned after this instruction, with its first `p_write_count` writes.
+		auto merge = [&](const uint8_t *p_in, int p_write_count, uint32_t p_target) {
+			memcpy(out.ptr(), p_in, register_count);
+			for (int w = 0; w < p_write_count; w++) {
+				out[writes[w]] = 1;
+			}
+			bool target_changed = false;
+			uint8_t *target_in = &assigned[p_target * register_count];
+			for (uint32_t r = 0; r < register_count; r++) {
+				if (target_in[r] && !out[r]) {
+					target_in[r] = 0;
+					target_changed = true;
+				}
+			}
+			return target_changed;
+		};
+
+		// Sets only ever lose registers, so this ends once a pass changes nothing.
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (uint32_t i = 0; i < code_size; i++) {
+				const Instruction &instruction = program->code[i];
+				get_operands(instruction, reads, read_count, writes, write_count, jump_write_count);
+				const uint8_t *in = &assigned[i * register_count];
+				const bool falls_through = instruction.op != OP_JUMP && instruction.op != OP_RETURN && instruction.op != OP_RETURN_NIL;
+				if (falls_through && i + 1 < code_size) {
+					changed = merge(in, write_count, i + 1) || changed;
+				}
+				if (instruction.op >= OP_JUMP && instruction.op <= OP_ITERATE_FLOAT) {
+					changed = merge(in, jump_write_count, instruction.d) || changed;
+				}
+			}
+		}
+
+		for (uint32_t i = 0; i < code_size; i++) {
+			get_operands(program->code[i], reads, read_count, writes, write_count, jump_write_count);
+			for (int r = 0; r < read_count; r++) {
+				if (!assigned[i * register_count + reads[r]]) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+public:
+	Program *translate() {
+		if (!function->_code_ptr || function->_default_arg_count > 0) {
+			return nullptr;
+		}
+		const GDScriptDataType &return_type = function->return_type;
+		if (return_type.has_type && !_is_numeric_data_type(return_type) && (return_type.kind != GDScriptDataType::BUILTIN || return_type.builtin_type != Variant::NIL)) {
+			return nullptr; // Only numeric and void returns.
+		}
+		for (const GDScriptDataType &argument_type : function->argument_types) {
+			if (!_is_numeric_data_type(argument_type)) {
+				return nullptr;
+			}
+		}
+
+		constants_base = function->_stack_size;
+		scratch_base = constants_base + function->_constant_count;
+
+		program = memnew(Program);
+		program->registers.resize(scratch_base + SCRATCH_COUNT);
+		memset(program->registers.ptr(), 0, sizeof(Register) * program->registers.size());
+		types.resize(program->registers.size());
+		for (uint32_t i = 0; i < types.size(); i++) {
+			types[i] = Variant::NIL;
+		}
+
+		for (int i = 0; i < function->argument_types.size(); i++) {
+			program->argument_types.push_back(function->argument_types[i].builtin_type);
+			types[GDScriptFunction::FIXED_ADDRESSES_MAX + i] = function->argument_types[i].builtin_type;
+		}
+		for (int i = 0; i < function->_constant_count; i++) {
+			const Variant &constant = function->_constants_ptr[i];
+			Register &reg = program->registers[constants_base + i];
+			switch (constant.get_type()) {
+				case Variant::BOOL:
+					reg.i = *VariantInternal::get_bool(&constant) ? 1 : 0;
+					break;
+				case Variant::INT:
+					reg.i = *VariantInternal::get_int(&constant);
+					break;
+				case Variant::FLOAT:
+					reg.f = *VariantInternal::get_float(&constant);
+					break;
+				default:
+					continue; // Leaves the constant untyped, so reading it fails.
+			}
+			types[constants_base + i] = constant.get_type();
+		}
+
+		code = function->_code_ptr;
+		instruction_at.resize(function->_code_size + 1);
+		for (uint32_t i = 0; i < instruction_at.size(); i++) {
+			instruction_at[i] = -1;
+		}
+
+		while (ip < function->_code_size) {
+			instruction_at[ip] = program->code.size();
+			int size = translate_instruction();
+			if (size == 0) {
+				memdelete(program);
+				return nullptr;
+			}
+			ip += size;
+		}
+		instruction_at[function->_code_size] = program->code.size();
+		emit(OP_RETURN_NIL);
+
+		for (uint32_t index : jumps) {
+			int target = program->code[index].d;
+			if (target < 0 || target > function->_code_size || instruction_at[target] < 0) {
+				memdelete(program);
+				return nullptr;
+			}
+			program->code[index].d = instruction_at[target];
+		}
+
+		if (!check_assignments()) {
+			memdelete(program);
+			return nullptr;
+		}
+
+		return program;
+	}
+
+	Translator(const GDScriptFunction *p_function) :
+			function(p_function) {}
+};
+
+GDScriptNumericTier::Program *GDScriptNumericTier::translate(const GDScriptFunction *p_function) {
+	ERR_FAIL_NULL_V(p_function, nullptr);
+	Translator translator(p_function);
+	return translator.translate();
+}
+
+void GDScriptNumericTier::tier_up(GDScriptFunction *p_function) {
+	MutexLock lock(mutex);
+	if (p_function->numeric_tier_tried.is_set()) {
+		return;
+	}
+	GDScriptNumericTier::Program *program = translate(p_function);
+	if (program && has_native) {
+		const NativeFunction *native = native_functions.getptr(get_native_key(p_function, program));
+		if (native) {
+			p_function->numeric_native = *native;
+		}
+	}
+	p_function->numeric_program = program;
+	p_function->numeric_tier_tried.set();
+}
+
+String GDScriptNumericTier::get_native_key(const GDScriptFunction *p_function, const Program *p_program) {
+	// Hashed field by field, instructions have padding.
+	uint32_t hash = HASH_MURMUR3_SEED;
+	for (const Instruction &instruction : p_program->code) {
+		hash = hash_murmur3_one_32(instruction.op, hash);
+		hash = hash_murmur3_one_32(instruction.a, hash);
+		hash = hash_murmur3_one_32(instruction.b, hash);
+		hash = hash_murmur3_one_32(instruction.c, hash);
+		hash = hash_murmur3_one_32(instruction.d, hash);
+	}
+	for (const Register &reg : p_program->registers) {
+		hash = hash_murmur3_one_64(reg.i, hash);
+	}
+	for (Variant::Type type : p_program->argument_types) {
+		hash = hash_murmur3_one_32(type, hash);
+	}
+	hash = hash_fmix32(hash);
+
+	return vformat("%s::%08x", _get_native_name(p_function), hash);
+}
+
+String GDScriptNumericTier::_get_native_name(const GDScriptFunction *p_function) {
+	String script_name = p_function->get_script() ? p_function->get_script()->get_fully_qualified_name() : String();
+	return vformat("%s::%s", script_name, p_function->get_name());
+}
+
+void GDScriptNumericTier::register_native_function(const String &p_key, NativeFunction p_function) {
+	ERR_FAIL_NULL(p_function);
+	const int name_end = p_key.rfind("::");
+	ERR_FAIL_COND_MSG(name_end <= 0, vformat("Invalid native function key \"%s\".", p_key));
+	MutexLock lock(mutex);
+	if (!native_functions.has(p_key)) {
+		native_function_names[p_key.substr(0, name_end)]++;
+	}
+	native_functions[p_key] = p_function;
+	has_native = true;
+}
+
+void GDScriptNumericTier::unregister_native_function(const String &p_key) {
+	MutexLock lock(mutex);
+	if (!native_functions.erase(p_key)) {
+		return;
+	}
+	const String name = p_key.substr(0, p_key.rfind("::"));
+	int *count = native_function_names.getptr(name);
+	if (count && --(*count) == 0) {
+		native_function_names.erase(name);
+	}
+	has_native = !native_functions.is_empty();
+}
+
+bool GDScriptNumericTier::has_native_function(const GDScriptFunction *p_function) {
+	if (!has_native) {
+		return false;
+	}
+	const String name = _get_native_name(p_function);
+	MutexLock lock(mutex);
+	return native_function_names.has(name);
+}
+
+bool GDScriptNumericTier::call_native(NativeFunction p_function, const Variant **p_args, int p_argcount, Variant &r_ret) {
+	if (!_can_leave_interpreter()) {
+		return false;
+	}
+	return p_function(p_args, p_argcount, r_ret);
+}
+
+bool GDScriptNumericTier::call(const Program *p_program, const Variant **p_args, int p_argcount, Variant &r_ret) {
+	if (p_argcount != (int)p_program->argument_types.size()) {
+		return false;
+	}
+	for (int i = 0; i < p_argcount; i++) {
+		if (p_args[i]->get_type() != p_program->argument_types[i]) {
+			return false;
+		}
+	}
+	if (!_can_leave_interpreter()) {
+		return false;
+	}
+
+	Register *r = (Register *)alloca(sizeof(Register) * p_program->registers.size());
+	memcpy(r, p_program->registers.ptr(), sizeof(Register) * p_program->registers.size());
+	for (int i = 0; i < p_argcount; i++) {
+		Register &arg = r[GDScriptFunction::FIXED_ADDRESSES_MAX + i];
+		switch (p_program->argument_types[i]) {
+			case Variant::BOOL:
+				arg.i = *VariantInternal::get_bool(p_args[i]) ? 1 : 0;
+				break;
+			case Variant::INT:
+				arg.i = *VariantInternal::get_int(p_args[i]);
+				break;
+			default:
+				arg.f = *VariantInternal::get_float(p_args[i]);
+				break;
+		}
+	}
+
+	const Instruction *code = p_program->code.ptr();
+	const Instruction *in = code;
+
+#define BINARY_OP(m_op, m_result, m_operand, m_operator)                      \
+	case m_op: {                                                              \
+		r[in->c].m_result = r[in->a].m_operand m_operator r[in->b].m_operand; \
+	} break
+
+	while (true) {
+		switch (in->op) {
+			case OP_MOVE: {
+				r[in->a] = r[in->b];
+			} break;
+			case OP_LOAD_IMMEDIATE: {
+				r[in->a].i = in->b;
+			} break;
+			case OP_INT_TO_FLOAT: {
+				r[in->a].f = (double)r[in->b].i;
+			} break;
+			case OP_FLOAT_TO_INT: {
+				r[in->a].i = (int64_t)r[in->b].f;
+			} break;
+			BINARY_OP(OP_ADD_INT, i, i, +);
+			BINARY_OP(OP_SUBTRACT_INT, i, i, -);
+			BINARY_OP(OP_MULTIPLY_INT, i, i, *);
+			BINARY_OP(OP_ADD_FLOAT, f, f, +);
+			BINARY_OP(OP_SUBTRACT_FLOAT, f, f, -);
+			BINARY_OP(OP_MULTIPLY_FLOAT, f, f, *);
+			BINARY_OP(OP_DIVIDE_FLOAT, f, f, /);
+			BINARY_OP(OP_EQUAL_INT, i, i, ==);
+			BINARY_OP(OP_NOT_EQUAL_INT, i, i, !=);
+			BINARY_OP(OP_LESS_INT, i, i, <);
+			BINARY_OP(OP_LESS_EQUAL_INT, i, i, <=);
+			BINARY_OP(OP_GREATER_INT, i, i, >);
+			BINARY_OP(OP_GREATER_EQUAL_INT, i, i, >=);
+			BINARY_OP(OP_EQUAL_FLOAT, i, f, ==);
+			BINARY_OP(OP_NOT_EQUAL_FLOAT, i, f, !=);
+			BINARY_OP(OP_LESS_FLOAT, i, f, <);
+			BINARY_OP(OP_LESS_EQUAL_FLOAT, i, f, <=);
+			BINARY_OP(OP_GREATER_FLOAT, i, f, >);
+			BINARY_OP(OP_GREATER_EQUAL_FLOAT, i, f, >=);
+			case OP_NEGATE_INT: {
+				r[in->c].i = -r[in->a].i;
+			} break;
+			case OP_NEGATE_FLOAT: {
+				r[in->c].f = -r[in->a].f;
+			} break;
+			case OP_NOT: {
+				r[in->c].i = !r[in->a].i;
+			} break;
+			case OP_JUMP: {
+				in = code + in->d;
+				continue;
+			}
+			case OP_JUMP_IF: {
+				if (r[in->a].i) {
+					in = code + in->d;
+					continue;
+				}
+			} break;
+			case OP_JUMP_IF_NOT: {
+				if (!r[in->a].i) {
+					in = code + in->d;
+					continue;
+				}
+			} break;
+			case OP_JUMP_IF_NOT_LESS_INT: {
+				if (!(r[in->a].i < r[in->b].i)) {
+					in = code + in->d;
+					continue;
+				}
+			} break;
+			case OP_ITERATE_BEGIN_INT: {
+				r[in->a].i = 0;
+				if (r[in->b].i <= 0) {
+					in = code + in->d;
+					continue;
+				}
+				r[in->c].i = 0;
+			} break;
+			case OP_ITERATE_INT: {
+				r[in->a].i++;
+				if (r[in->a].i >= r[in->b].i) {
+					in = code + in->d;
+					continue;
+				}
+				r[in->c].i = r[in->a].i;
+			} break;
+			case OP_ITERATE_BEGIN_FLOAT: {
+				r[in->a].f = 0.0;
+				if (!(r[in->b].f > 0)) {
+					in = code + in->d;
+					continue;
+				}
+				r[in->c].f = 0.0;
+			} break;
+			case OP_ITERATE_FLOAT: {
+				r[in->a].f++;
+				if (r[in->a].f >= r[in->b].f) {
+					in = code + in->d;
+					continue;
+				}
+				r[in->c].f = r[in->a].f;
+			} break;
+			case OP_RETURN: {
+				switch (Variant::Type(in->b)) {
+					case Variant::BOOL:
+						r_ret = bool(r[in->a].i);
+						break;
+					case Variant::INT:
+						r_ret = r[in->a].i;
+						break;
+					default:
+						r_ret = r[in->a].f;
+						break;
+				}
+				return true;
+			}
+			case OP_RETURN_NIL: {
+				r_ret = Variant();
+				return true;
+			}
+		}
+		in++;
+	}
+
+#undef BINARY_OP
+}
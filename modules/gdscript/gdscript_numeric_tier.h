@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*  gdscript_numeric_tier.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_NUMERIC_TIER_H
+#define GDSCRIPT_NUMERIC_TIER_H
+
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+class GDScriptFunction;
+
+// Second execution tier for hot GDScript functions that only deal with `int`, `float` and `bool`.
+// Once a function has been called `call_threshold` times, its bytecode is translated into a
+// register program that works on unboxed values, with every stack slot and constant given a
+// single static type. Functions using anything else (objects, members, calls, other builtin
+// types, default arguments, ...) are rejected and stay in the interpreter.
+// The translated program is guarded by the exact types of the arguments: when a call passes
+// values that would need a conversion, it runs in the interpreter instead.
+// Programs can also be compiled ahead of time to C++ (see `GDScriptNativeExporter`). Those native
+// functions are registered by key, and replace the program of the function they were exported from.
+class GDScriptNumericTier {
+public:
+	// Same contract as `call()`.
+	typedef bool (*NativeFunction)(const Variant **p_args, int p_argcount, Variant &r_ret);
+
+	enum Operation : uint8_t {
+		OP_MOVE,
+		OP_LOAD_IMMEDIATE,
+		OP_INT_TO_FLOAT,
+		OP_FLOAT_TO_INT,
+		OP_ADD_INT,
+		OP_SUBTRACT_INT,
+		OP_MULTIPLY_INT,
+		OP_NEGATE_INT,
+		OP_ADD_FLOAT,
+		OP_SUBTRACT_FLOAT,
+		OP_MULTIPLY_FLOAT,
+		OP_DIVIDE_FLOAT,
+		OP_NEGATE_FLOAT,
+		OP_EQUAL_INT,
+		OP_NOT_EQUAL_INT,
+		OP_LESS_INT,
+		OP_LESS_EQUAL_INT,
+		OP_GREATER_INT,
+		OP_GREATER_EQUAL_INT,
+		OP_EQUAL_FLOAT,
+		OP_NOT_EQUAL_FLOAT,
+		OP_LESS_FLOAT,
+		OP_LESS_EQUAL_FLOAT,
+		OP_GREATER_FLOAT,
+		OP_GREATER_EQUAL_FLOAT,
+		OP_NOT,
+		OP_JUMP,
+		OP_JUMP_IF,
+		OP_JUMP_IF_NOT,
+		OP_JUMP_IF_NOT_LESS_INT,
+		OP_ITERATE_BEGIN_INT,
+		OP_ITERATE_INT,
+		OP_ITERATE_BEGIN_FLOAT,
+		OP_ITERATE_FLOAT,
+		OP_RETURN,
+		OP_RETURN_NIL,
+	};
+
+	// Booleans are stored as 0 or 1 in `i`.
+	union Register {
+		int64_t i;
+		double f;
+	};
+
+	// Binary operations read `a` and `b` and write `c`. Jumps keep their destination in `d`.
+	struct Instruction {
+		Operation op = OP_RETURN_NIL;
+		int32_t a = 0;
+		int32_t b = 0;
+		int32_t c = 0;
+		int32_t d = 0;
+	};
+
+	struct Program {
+		LocalVector<Instruction> code;
+		LocalVector<Register> registers; // Initial register file, with constants already loaded.
+		LocalVector<Variant::Type> argument_types;
+	};
+
+private:
+	static uint32_t call_threshold;
+	static Mutex mutex;
+	static HashMap<String, NativeFunction> native_functions;
+	static HashMap<String, int> native_function_names; // Number of registered keys for each `script::function`.
+	static bool has_native;
+
+	class Translator;
+
+	static bool _can_leave_interpreter();
+	static String _get_native_name(const GDScriptFunction *p_function);
+
+public:
+	static void set_call_threshold(uint32_t p_calls) { call_threshold = p_calls; }
+	static uint32_t get_call_threshold() { return call_threshold; }
+
+	// Returns nullptr if the function can't run in this tier.
+	static Program *translate(const GDScriptFunction *p_function);
+	// Called by the VM once the function is hot. Translates it at most once.
+	static void tier_up(GDScriptFunction *p_function);
+	// Returns false without side effects if the arguments don't match the guard.
+	static bool call(const Program *p_program, const Variant **p_args, int p_argcount, Variant &r_ret);
+	static bool call_native(NativeFunction p_function, const Variant **p_args, int p_argcount, Variant &r_ret);
+
+	// Identifies a program by its function and contents, so a native function is only used
+	// for the exact code it was generated from.
+	static String get_native_key(const GDScriptFunction *p_function, const Program *p_program);
+	static void register_native_function(const String &p_key, NativeFunction p_function);
+	static void unregister_native_function(const String &p_key);
+	// Whether a native function was registered for this function, whatever its code. The VM uses
+	// it to tier up such functions on their first call, instead of waiting until they are hot.
+	static bool has_native_function(const GDScriptFunction *p_function);
+};
+
+#endif // GDSCRIPT_NUMERIC_TIER_H
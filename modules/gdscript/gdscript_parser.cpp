@@ -734,6 +734,9 @@ void GDScriptParser::parse_extends() {
 			push_error(vformat(R"(Only strings or identifiers can be used after "extends", found "%s" instead.)", Variant::get_type_name(previous.literal.get_type())));
 		}
 		current_class->extends_path = previous.literal;
+		if (collect_dependencies) {
+			dependency_paths.push_back(current_class->extends_path);
+		}
 
 		if (!match(GDScriptTokenizer::Token::PERIOD)) {
 			return;
@@ -2351,6 +2354,10 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_identifier(ExpressionNode
 	identifier->name = previous.get_identifier();
 	identifier->suite = current_suite;
 
+	if (collect_dependencies) {
+		dependency_names.insert(identifier->name);
+	}
+
 	if (current_suite != nullptr && current_suite->has_local(identifier->name)) {
 		const SuiteNode::Local &declaration = current_suite->get_local(identifier->name);
 
@@ -3193,6 +3200,11 @@ GDScriptParser::ExpressionNode *GDScriptParser::parse_preload(ExpressionNode *p_
 
 	if (preload->path == nullptr) {
 		push_error(R"(Expected resource path after "(".)");
+	} else if (collect_dependencies && preload->path->type == Node::LITERAL) {
+		const Variant &literal = static_cast<LiteralNode *>(preload->path)->value;
+		if (literal.get_type() == Variant::STRING) {
+			dependency_paths.push_back(literal);
+		}
 	}
 
 	pop_completion_call();
@@ -44,6 +44,7 @@
 #include "core/string/string_name.h"
 #include "core/string/ustring.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
 #include "core/templates/list.h"
 #include "core/templates/rb_map.h"
 #include "core/templates/vector.h"
@@ -1332,6 +1333,11 @@ private:
 	Node *list = nullptr;
 	List<ParserError> errors;
 
+	// Gathered while parsing when enabled, to find other scripts this one may need.
+	bool collect_dependencies = false;
+	HashSet<StringName> dependency_names;
+	Vector<String> dependency_paths;
+
 #ifdef DEBUG_ENABLED
 	bool is_ignoring_warnings = false;
 	List<GDScriptWarning> warnings;
@@ -1560,6 +1566,12 @@ public:
 		// TODO: Keep track of deps.
 		return List<String>();
 	}
+
+	// Must be enabled before parsing. Names are all the identifiers found, some of which may be global classes.
+	// Paths are the `extends` and `preload()` string literals, as written.
+	void set_collect_dependencies(bool p_enabled) { collect_dependencies = p_enabled; }
+	const HashSet<StringName> &get_dependency_names() const { return dependency_names; }
+	const Vector<String> &get_dependency_paths() const { return dependency_paths; }
 #ifdef DEBUG_ENABLED
 	const List<GDScriptWarning> &get_warnings() const { return warnings; }
 	const HashSet<int> &get_unsafe_lines() const { return unsafe_lines; }
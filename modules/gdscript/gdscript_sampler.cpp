@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  gdscript_sampler.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "gdscript_sampler.h"
+
+#include "gdscript.h"
+#include "gdscript_function.h"
+
+#include "core/config/project_settings.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
+
+GDScriptSampler *GDScriptSampler::singleton = nullptr;
+SafeNumeric<uint32_t> GDScriptSampler::pending_ticks;
+SafeFlag GDScriptSampler::running;
+
+void GDScriptSampler::_thread_func(void *p_user) {
+	GDScriptSampler *sampler = (GDScriptSampler *)p_user;
+	Thread::set_name("GDScript Sampler");
+
+	while (running.is_set()) {
+		OS::get_singleton()->delay_usec(sampler->interval_usec);
+		pending_ticks.increment();
+	}
+}
+
+void GDScriptSampler::_take_sample(int p_skip_frames) {
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return;
+	}
+
+	// Only the main thread takes ticks out, so nothing can be lost between both calls.
+	uint32_t ticks = pending_ticks.get();
+	pending_ticks.sub(ticks);
+
+	const GDScriptLanguage::CallStack &call_stack = GDScriptLanguage::_call_stack;
+	int depth = call_stack.levels ? call_stack.stack_pos - p_skip_frames : 0;
+
+	String stack;
+	if (depth <= 0) {
+		stack = ENGINE_FRAME;
+	} else {
+		for (int i = 0; i < depth; i++) {
+			const GDScriptFunction *function = call_stack.levels[i].function;
+			if (i > 0) {
+				stack += ";";
+			}
+			stack += String(function->get_source()) + ":" + String(function->get_name());
+		}
+	}
+
+	add_sample(stack, ticks);
+}
+
+void GDScriptSampler::_profiler_toggle(void *p_user, bool p_enable, const Array &p_opts) {
+	GDScriptSampler *sampler = (GDScriptSampler *)p_user;
+
+	if (p_enable) {
+		sampler->clear();
+		uint64_t interval = p_opts.size() > 0 ? uint64_t(p_opts[0]) : DEFAULT_INTERVAL_USEC;
+		sampler->start(interval);
+		return;
+	}
+
+	sampler->stop();
+	if (!EngineDebugger::is_active()) {
+		return;
+	}
+
+	Array profile;
+	profile.push_back(sampler->to_folded());
+	profile.push_back(sampler->to_speedscope(GLOBAL_GET("application/config/name")));
+	EngineDebugger::get_singleton()->send_message("gdscript_sampler:profile", profile);
+}
+
+void GDScriptSampler::start(uint64_t p_interval_usec) {
+	ERR_FAIL_COND_MSG(p_interval_usec == 0, "The sampling interval must be greater than zero.");
+	if (running.is_set()) {
+		return;
+	}
+
+	// The call stack is only maintained while something needs it.
+	GDScriptLanguage::get_singleton()->tracking_call_stack = true;
+
+	interval_usec = p_interval_usec;
+	pending_ticks.set(0);
+	running.set();
+	thread.start(_thread_func, this);
+}
+
+void GDScriptSampler::stop() {
+	if (!running.is_set()) {
+		return;
+	}
+
+	running.clear();
+	thread.wait_to_finish();
+	pending_ticks.set(0);
+}
+
+void GDScriptSampler::clear() {
+	MutexLock lock(mutex);
+	stacks.clear();
+	sample_count = 0;
+}
+
+void GDScriptSampler::add_sample(const String &p_stack, uint64_t p_weight) {
+	MutexLock lock(mutex);
+	HashMap<String, uint64_t>::Iterator E = stacks.find(p_stack);
+	if (E) {
+		E->value += p_weight;
+	} else {
+		stacks.insert(p_stack, p_weight);
+	}
+	sample_count += p_weight;
+}
+
+uint64_t GDScriptSampler::get_sample_count() {
+	MutexLock lock(mutex);
+	return sample_count;
+}
+
+String GDScriptSampler::to_folded() {
+	MutexLock lock(mutex);
+
+	Vector<String> lines;
+	for (const KeyValue<String, uint64_t> &E : stacks) {
+		lines.push_back(E.key + " " + itos(E.value));
+	}
+	lines.sort();
+
+	String folded;
+	for (const String &line : lines) {
+		folded += line + "\n";
+	}
+	return folded;
+}
+
+String GDScriptSampler::to_speedscope(const String &p_name) {
+	MutexLock lock(mutex);
+
+	Vector<String> sorted_stacks;
+	for (const KeyValue<String, uint64_t> &E : stacks) {
+		sorted_stacks.push_back(E.key);
+	}
+	sorted_stacks.sort();
+
+	HashMap<String, int> frame_indices;
+	Array frames;
+	Array samples;
+	Array weights;
+	uint64_t total = 0;
+
+	for (const String &stack : sorted_stacks) {
+		Array sample;
+		Vector<String> stack_frames = stack.split(";");
+		for (const String &frame : stack_frames) {
+			HashMap<String, int>::Iterator E = frame_indices.find(frame);
+			if (!E) {
+				Dictionary frame_info;
+				// Frames are `path:function`, the path has a colon of its own.
+				int separator = frame.rfind(":");
+				if (separator > 0) {
+					frame_info["name"] = frame.substr(separator + 1);
+					frame_info["file"] = frame.substr(0, separator);
+				} else {
+					frame_info["name"] = frame;
+				}
+				E = frame_indices.insert(frame, frames.size());
+				frames.push_back(frame_info);
+			}
+			sample.push_back(E->value);
+		}
+
+		uint64_t weight = stacks[stack] * interval_usec;
+		samples.push_back(sample);
+		weights.push_back(weight);
+		total += weight;
+	}
+
+	Dictionary profile;
+	profile["type"] = "sampled";
+	profile["name"] = p_name;
+	profile["unit"] = "microseconds";
+	profile["startValue"] = 0;
+	profile["endValue"] = total;
+	profile["samples"] = samples;
+	profile["weights"] = weights;
+
+	Dictionary shared;
+	shared["frames"] = frames;
+
+	Array profiles;
+	profiles.push_back(profile);
+
+	Dictionary file;
+	file["$schema"] = "https://www.speedscope.app/file-format-schema.json";
+	file["exporter"] = "Godot Engine GDScript sampler";
+	file["name"] = p_name;
+	file["activeProfileIndex"] = 0;
+	file["shared"] = shared;
+	file["profiles"] = profiles;
+	return JSON::stringify(file);
+}
+
+Error GDScriptSampler::save(const String &p_path) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("Could not open \"%s\" to save the GDScript samples.", p_path));
+
+	if (p_path.get_extension().to_lower() == "json") {
+		f->store_string(to_speedscope(p_path.get_file().get_basename()));
+	} else {
+		f->store_string(to_folded());
+	}
+	return OK;
+}
+
+void GDScriptSampler::register_profiler() {
+	EngineDebugger::register_profiler("gdscript_sampler", EngineDebugger::Profiler(this, _profiler_toggle, nullptr, nullptr));
+}
+
+void GDScriptSampler::unregister_profiler() {
+	if (EngineDebugger::has_profiler("gdscript_sampler")) {
+		EngineDebugger::unregister_profiler("gdscript_sampler");
+	}
+}
+
+GDScriptSampler::GDScriptSampler() {
+	if (!singleton) {
+		singleton = this;
+	}
+}
+
+GDScriptSampler::~GDScriptSampler() {
+	stop();
+	if (singleton == this) {
+		singleton = nullptr;
+	}
+}
@@ -0,0 +1,100 @@
+/**************************************************************************/
+/*  gdscript_sampler.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLER_H
+#define GDSCRIPT_SAMPLER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+
+// Sampling profiler for the main thread's scripts.
+// A timer thread only counts elapsed ticks. The main thread checks for pending ticks at every line
+// and when a function returns, and then records its GDScript call stack once, weighted by the number
+// of ticks that elapsed. This keeps the cost to a branch per line while idle, and to building one
+// stack string per sample, instead of timing every call like the instrumenting profiler.
+// Ticks that elapse while no script runs on the main thread are recorded under `ENGINE_FRAME`.
+class GDScriptSampler {
+	static GDScriptSampler *singleton;
+
+	static SafeNumeric<uint32_t> pending_ticks;
+	static SafeFlag running;
+
+	Thread thread;
+	uint64_t interval_usec = DEFAULT_INTERVAL_USEC;
+
+	Mutex mutex;
+	HashMap<String, uint64_t> stacks;
+	uint64_t sample_count = 0;
+
+	static void _thread_func(void *p_user);
+	void _take_sample(int p_skip_frames);
+
+	static void _profiler_toggle(void *p_user, bool p_enable, const Array &p_opts);
+
+public:
+	static constexpr uint64_t DEFAULT_INTERVAL_USEC = 1000;
+	static constexpr const char *ENGINE_FRAME = "<engine>";
+
+	static GDScriptSampler *get_singleton() { return singleton; }
+
+	_FORCE_INLINE_ static bool is_running() { return running.is_set(); }
+
+	// Called by the VM at line boundaries, on return, and on entry with the new frame skipped,
+	// since the ticks pending then elapsed in the caller.
+	_FORCE_INLINE_ static void poll(int p_skip_frames = 0) {
+		if (unlikely(pending_ticks.get() != 0)) {
+			singleton->_take_sample(p_skip_frames);
+		}
+	}
+
+	void start(uint64_t p_interval_usec = DEFAULT_INTERVAL_USEC);
+	void stop();
+	void clear();
+
+	void add_sample(const String &p_stack, uint64_t p_weight);
+	uint64_t get_sample_count();
+
+	// One `frame;frame;frame count` line per distinct stack, as read by flamegraph.pl and speedscope.
+	String to_folded();
+	// Speedscope's own JSON format, as a single sampled profile.
+	String to_speedscope(const String &p_name);
+	Error save(const String &p_path);
+
+	void register_profiler();
+	void unregister_profiler();
+
+	GDScriptSampler();
+	~GDScriptSampler();
+};
+
+#endif // GDSCRIPT_SAMPLER_H
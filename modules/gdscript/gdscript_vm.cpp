@@ -31,6 +31,7 @@
 #include "gdscript.h"
 #include "gdscript_function.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_sampler.h"
 
 #include "core/core_string_names.h"
 #include "core/os/os.h"
@@ -215,6 +216,14 @@ void (*type_init_function_table[])(Variant *) = {
 	static const void *switch_table_ops[] = {          \
 		&&OPCODE_OPERATOR,                             \
 		&&OPCODE_OPERATOR_VALIDATED,                   \
+		&&OPCODE_OPERATOR_ADD_INT,                     \
+		&&OPCODE_OPERATOR_SUBTRACT_INT,                \
+		&&OPCODE_OPERATOR_MULTIPLY_INT,                \
+		&&OPCODE_OPERATOR_LESS_INT,                    \
+		&&OPCODE_OPERATOR_ADD_FLOAT,                   \
+		&&OPCODE_OPERATOR_SUBTRACT_FLOAT,              \
+		&&OPCODE_OPERATOR_MULTIPLY_FLOAT,              \
+		&&OPCODE_OPERATOR_DIVIDE_FLOAT,                \
 		&&OPCODE_TYPE_TEST_BUILTIN,                    \
 		&&OPCODE_TYPE_TEST_ARRAY,                      \
 		&&OPCODE_TYPE_TEST_NATIVE,                     \
@@ -222,9 +231,27 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_SET_KEYED,                            \
 		&&OPCODE_SET_KEYED_VALIDATED,                  \
 		&&OPCODE_SET_INDEXED_VALIDATED,                \
+		&&OPCODE_SET_INDEXED_PACKED_BYTE_ARRAY,        \
+		&&OPCODE_SET_INDEXED_PACKED_INT32_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_INT64_ARRAY,       \
+		&&OPCODE_SET_INDEXED_PACKED_FLOAT32_ARRAY,     \
+		&&OPCODE_SET_INDEXED_PACKED_FLOAT64_ARRAY,     \
+		&&OPCODE_SET_INDEXED_PACKED_STRING_ARRAY,      \
+		&&OPCODE_SET_INDEXED_PACKED_VECTOR2_ARRAY,     \
+		&&OPCODE_SET_INDEXED_PACKED_VECTOR3_ARRAY,     \
+		&&OPCODE_SET_INDEXED_PACKED_COLOR_ARRAY,       \
 		&&OPCODE_GET_KEYED,                            \
 		&&OPCODE_GET_KEYED_VALIDATED,                  \
 		&&OPCODE_GET_INDEXED_VALIDATED,                \
+		&&OPCODE_GET_INDEXED_PACKED_BYTE_ARRAY,        \
+		&&OPCODE_GET_INDEXED_PACKED_INT32_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_INT64_ARRAY,       \
+		&&OPCODE_GET_INDEXED_PACKED_FLOAT32_ARRAY,     \
+		&&OPCODE_GET_INDEXED_PACKED_FLOAT64_ARRAY,     \
+		&&OPCODE_GET_INDEXED_PACKED_STRING_ARRAY,      \
+		&&OPCODE_GET_INDEXED_PACKED_VECTOR2_ARRAY,     \
+		&&OPCODE_GET_INDEXED_PACKED_VECTOR3_ARRAY,     \
+		&&OPCODE_GET_INDEXED_PACKED_COLOR_ARRAY,       \
 		&&OPCODE_SET_NAMED,                            \
 		&&OPCODE_SET_NAMED_VALIDATED,                  \
 		&&OPCODE_GET_NAMED,                            \
@@ -269,6 +296,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_JUMP,                                 \
 		&&OPCODE_JUMP_IF,                              \
 		&&OPCODE_JUMP_IF_NOT,                          \
+		&&OPCODE_JUMP_IF_NOT_LESS_INT,                 \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,                 \
 		&&OPCODE_JUMP_IF_SHARED,                       \
 		&&OPCODE_RETURN,                               \
@@ -447,6 +475,23 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	r_err.error = Callable::CallError::CALL_OK;
 
+	if (!p_state) {
+		// Hot functions that only use int, float and bool values can run unboxed in the numeric tier.
+		// Functions compiled ahead of time are tiered up on their first call.
+		if (unlikely(!numeric_tier_tried.is_set())) {
+			const uint32_t calls = numeric_tier_calls.increment();
+			if (calls >= GDScriptNumericTier::get_call_threshold() || (calls == 1 && GDScriptNumericTier::has_native_function(this))) {
+				GDScriptNumericTier::tier_up(this);
+			}
+		}
+		if (numeric_tier_tried.is_set() && numeric_program) {
+			Variant ret;
+			if (numeric_native ? GDScriptNumericTier::call_native(numeric_native, p_args, p_argcount, ret) : GDScriptNumericTier::call(numeric_program, p_args, p_argcount, ret)) {
+				return ret;
+			}
+		}
+	}
+
 	static thread_local int call_depth = 0;
 	if (unlikely(++call_depth > MAX_CALL_DEPTH)) {
 		call_depth--;
@@ -492,11 +537,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	if (p_state) {
 		//use existing (supplied) state (awaited)
-		stack = (Variant *)p_state->stack.ptr();
-		instruction_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		instruction_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -577,12 +622,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
-#ifdef DEBUG_ENABLED
-
-	if (EngineDebugger::is_active()) {
+	if (GDScriptLanguage::get_singleton()->is_tracking_call_stack()) {
 		GDScriptLanguage::get_singleton()->enter_function(p_instance, this, stack, &ip, &line);
+		GDScriptSampler::poll(1);
 	}
 
+#ifdef DEBUG_ENABLED
+
 #define GD_ERR_BREAK(m_cond)                                                                                           \
 	{                                                                                                                  \
 		if (unlikely(m_cond)) {                                                                                        \
@@ -594,6 +640,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #define CHECK_SPACE(m_space) \
 	GD_ERR_BREAK((ip + m_space) > _code_size)
 
+#define OOB_INDEX_BREAK(m_action, m_index, m_base)                                                                        \
+	{                                                                                                                     \
+		err_text = "Out of bounds " m_action " index '" + itos(m_index) + "' (on base: '" + _get_var_type(m_base) + "')"; \
+		OPCODE_BREAK;                                                                                                     \
+	}
+
 #define GET_VARIANT_PTR(m_v, m_code_ofs)                                                            \
 	Variant *m_v;                                                                                   \
 	{                                                                                               \
@@ -620,6 +672,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #else
 #define GD_ERR_BREAK(m_cond)
 #define CHECK_SPACE(m_space)
+#define OOB_INDEX_BREAK(m_action, m_index, m_base)
 
 #define GET_VARIANT_PTR(m_v, m_code_ofs)                                                        \
 	Variant *m_v;                                                                               \
@@ -654,9 +707,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		profile.frame_call_count.increment();
 	}
 	bool exit_ok = false;
-	bool awaited = false;
 	int variant_address_limits[ADDR_TYPE_MAX] = { _stack_size, _constant_count, p_instance ? (int)p_instance->members.size() : 0 };
 #endif
+	bool frame_suspended = false; // Stack handed over to a `GDScriptFunctionState` by `await`.
+	bool awaited = false;
 
 	Variant *variant_addresses[ADDR_TYPE_MAX] = { stack, _constants_ptr, p_instance ? p_instance->members.ptrw() : nullptr };
 
@@ -772,6 +826,28 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			// Arithmetic on operands statically known to be int or float, done in place without going
+			// through the validated evaluator. The destination must already hold the result type.
+#define OPCODE_OPERATOR_TYPED(m_name, m_result, m_operand, m_operator)                                                                \
+	OPCODE(OPCODE_OPERATOR_##m_name) {                                                                                                \
+		CHECK_SPACE(4);                                                                                                               \
+		GET_VARIANT_PTR(a, 0);                                                                                                        \
+		GET_VARIANT_PTR(b, 1);                                                                                                        \
+		GET_VARIANT_PTR(dst, 2);                                                                                                      \
+		*VariantInternal::get_##m_result(dst) = *VariantInternal::get_##m_operand(a) m_operator *VariantInternal::get_##m_operand(b); \
+		ip += 4;                                                                                                                      \
+	}                                                                                                                                 \
+	DISPATCH_OPCODE
+
+			OPCODE_OPERATOR_TYPED(ADD_INT, int, int, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_INT, int, int, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_INT, int, int, *);
+			OPCODE_OPERATOR_TYPED(LESS_INT, bool, int, <);
+			OPCODE_OPERATOR_TYPED(ADD_FLOAT, float, float, +);
+			OPCODE_OPERATOR_TYPED(SUBTRACT_FLOAT, float, float, -);
+			OPCODE_OPERATOR_TYPED(MULTIPLY_FLOAT, float, float, *);
+			OPCODE_OPERATOR_TYPED(DIVIDE_FLOAT, float, float, /);
+
 			OPCODE(OPCODE_TYPE_TEST_BUILTIN) {
 				CHECK_SPACE(4);
 
@@ -969,6 +1045,37 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_SET_INDEXED_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_value_get_func)   \
+	OPCODE(OPCODE_SET_INDEXED_PACKED_##m_var_type##_ARRAY) {                                     \
+		CHECK_SPACE(4);                                                                          \
+		GET_VARIANT_PTR(dst, 0);                                                                 \
+		GET_VARIANT_PTR(index, 1);                                                               \
+		GET_VARIANT_PTR(value, 2);                                                               \
+		Vector<m_elem_type> *array = VariantInternal::m_get_func(dst);                           \
+		int64_t int_index = *VariantInternal::get_int(index);                                    \
+		if (int_index < 0) {                                                                     \
+			int_index += array->size();                                                          \
+		}                                                                                        \
+		if (likely(int_index >= 0 && int_index < array->size())) {                               \
+			/* Only copies when the storage is shared, otherwise this costs a refcount check. */ \
+			array->ptrw()[int_index] = (m_elem_type)*VariantInternal::m_value_get_func(value);   \
+		} else {                                                                                 \
+			OOB_INDEX_BREAK("set", *VariantInternal::get_int(index), dst);                       \
+		}                                                                                        \
+		ip += 4;                                                                                 \
+	}                                                                                            \
+	DISPATCH_OPCODE
+
+			OPCODE_SET_INDEXED_PACKED_ARRAY(BYTE, uint8_t, get_byte_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(INT32, int32_t, get_int32_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(INT64, int64_t, get_int64_array, get_int);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(FLOAT32, float, get_float32_array, get_float);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(FLOAT64, double, get_float64_array, get_float);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(STRING, String, get_string_array, get_string);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(VECTOR2, Vector2, get_vector2_array, get_vector2);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(VECTOR3, Vector3, get_vector3_array, get_vector3);
+			OPCODE_SET_INDEXED_PACKED_ARRAY(COLOR, Color, get_color_array, get_color);
+
 			OPCODE(OPCODE_GET_KEYED) {
 				CHECK_SPACE(3);
 
@@ -1073,6 +1180,39 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+#define OPCODE_GET_INDEXED_PACKED_ARRAY(m_var_type, m_elem_type, m_get_func, m_ret_type, m_ret_get_func) \
+	OPCODE(OPCODE_GET_INDEXED_PACKED_##m_var_type##_ARRAY) {                                             \
+		CHECK_SPACE(4);                                                                                  \
+		GET_VARIANT_PTR(src, 0);                                                                         \
+		GET_VARIANT_PTR(index, 1);                                                                       \
+		GET_VARIANT_PTR(dst, 2);                                                                         \
+		const Vector<m_elem_type> *array = VariantInternal::m_get_func((const Variant *)src);            \
+		int64_t int_index = *VariantInternal::get_int(index);                                            \
+		if (int_index < 0) {                                                                             \
+			int_index += array->size();                                                                  \
+		}                                                                                                \
+		if (likely(int_index >= 0 && int_index < array->size())) {                                       \
+			/* Read before changing the type of `dst`, which may be `src`. */                            \
+			m_ret_type element = array->ptr()[int_index];                                                \
+			VariantTypeChanger<m_ret_type>::change(dst);                                                 \
+			*VariantInternal::m_ret_get_func(dst) = element;                                             \
+		} else {                                                                                         \
+			OOB_INDEX_BREAK("get", *VariantInternal::get_int(index), src);                               \
+		}                                                                                                \
+		ip += 4;                                                                                         \
+	}                                                                                                    \
+	DISPATCH_OPCODE
+
+			OPCODE_GET_INDEXED_PACKED_ARRAY(BYTE, uint8_t, get_byte_array, int64_t, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(INT32, int32_t, get_int32_array, int64_t, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(INT64, int64_t, get_int64_array, int64_t, get_int);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(FLOAT32, float, get_float32_array, double, get_float);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(FLOAT64, double, get_float64_array, double, get_float);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(STRING, String, get_string_array, String, get_string);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(VECTOR2, Vector2, get_vector2_array, Vector2, get_vector2);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(VECTOR3, Vector3, get_vector3_array, Vector3, get_vector3);
+			OPCODE_GET_INDEXED_PACKED_ARRAY(COLOR, Color, get_color_array, Color, get_color);
+
 			OPCODE(OPCODE_SET_NAMED) {
 				CHECK_SPACE(3);
 
@@ -1122,7 +1262,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 0);
 				GET_VARIANT_PTR(dst, 1);
@@ -1132,22 +1272,31 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, valid);
+				int inline_cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(inline_cache_idx < 0 || inline_cache_idx >= _inline_caches_count);
 
+#ifdef DEBUG_ENABLED
+				Object *src_obj = src->get_validated_object();
 #else
-				*dst = src->get_named(*index, valid);
+				Object *src_obj = src->operator Object *();
 #endif
+
+				bool valid;
+				//allow better error message in cases where src and dst are the same stack position
+				Variant ret;
+				if (src_obj && _inline_caches_ptr[inline_cache_idx].get(src_obj, *index, ret)) {
+					valid = true;
+				} else {
+					ret = src->get_named(*index, valid);
+				}
 #ifdef DEBUG_ENABLED
 				if (!valid) {
 					err_text = "Invalid access to property or key '" + index->operator String() + "' on a base object of type '" + _get_var_type(src) + "'.";
 					OPCODE_BREAK;
 				}
-				*dst = ret;
 #endif
-				ip += 4;
+				*dst = ret;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1673,7 +1822,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				bool call_async = (_code_ptr[ip]) == OPCODE_CALL_ASYNC;
 #endif
 				LOAD_INSTRUCTION_ARGS
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 
 				ip += instr_arg_count;
 
@@ -1684,6 +1833,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int inline_cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(inline_cache_idx < 0 || inline_cache_idx >= _inline_caches_count);
+				GDScriptInlineCache *inline_cache = &_inline_caches_ptr[inline_cache_idx];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1696,12 +1849,16 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Variant::Type base_type = base->get_type();
 				Object *base_obj = base->get_validated_object();
 				StringName base_class = base_obj ? base_obj->get_class_name() : StringName();
+#else
+				Object *base_obj = base->operator Object *();
 #endif
 
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!base_obj || !inline_cache->call(base_obj, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (ret->get_type() == Variant::NIL) {
 						if (base_type == Variant::OBJECT) {
@@ -1731,7 +1888,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!base_obj || !inline_cache->call(base_obj, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 
@@ -1781,7 +1940,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -2273,12 +2432,19 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 					gdfs->function = this;
 
-					gdfs->state.stack.resize(alloca_size);
-
-					// First 3 stack addresses are special, so we just skip them here.
-					for (int i = 3; i < _stack_size; i++) {
-						memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+					if (p_state) {
+						// Already running in a suspended frame, hand it over as is.
+						gdfs->state.stack = p_state->stack;
+						p_state->stack = nullptr;
+						p_state->stack_size = 0;
+					} else {
+						// First 3 stack addresses are special, so we just skip them here.
+						// The rest is relocated bitwise, like `CowData` does with variants, so this
+						// frame no longer owns them.
+						gdfs->state.stack = GDScriptFramePool::allocate(alloca_size);
+						memcpy(&gdfs->state.stack[sizeof(Variant) * FIXED_ADDRESSES_MAX], &stack[FIXED_ADDRESSES_MAX], sizeof(Variant) * (_stack_size - FIXED_ADDRESSES_MAX));
 					}
+					frame_suspended = true;
 					gdfs->state.stack_size = _stack_size;
 					gdfs->state.alloca_size = alloca_size;
 					gdfs->state.ip = ip + 2;
@@ -2311,8 +2477,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 #ifdef DEBUG_ENABLED
 					exit_ok = true;
-					awaited = true;
 #endif
+					awaited = true;
 					OPCODE_BREAK;
 				}
 			}
@@ -2440,6 +2606,22 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_JUMP_IF_NOT_LESS_INT) {
+				CHECK_SPACE(4);
+
+				GET_VARIANT_PTR(a, 0);
+				GET_VARIANT_PTR(b, 1);
+
+				if (!(*VariantInternal::get_int(a) < *VariantInternal::get_int(b))) {
+					int to = _code_ptr[ip + 3];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 4;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_JUMP_TO_DEF_ARGUMENT) {
 				CHECK_SPACE(2);
 				ip = _default_arg_ptr[defarg];
@@ -2937,7 +3119,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			GET_VARIANT_PTR(iterator, 2);                                                                                  \
 			VariantInternal::initialize(iterator, Variant::m_var_ret_type);                                                \
 			m_ret_type *it = VariantInternal::m_ret_get_func(iterator);                                                    \
-			*it = array->get(0);                                                                                           \
+			*it = array->ptr()[0];                                                                                         \
 			ip += 5;                                                                                                       \
 		} else {                                                                                                           \
 			int jumpto = _code_ptr[ip + 4];                                                                                \
@@ -3272,7 +3454,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			ip = jumpto;                                                                            \
 		} else {                                                                                    \
 			GET_VARIANT_PTR(iterator, 2);                                                           \
-			*VariantInternal::m_ret_get_func(iterator) = array->get(*idx);                          \
+			*VariantInternal::m_ret_get_func(iterator) = array->ptr()[*idx];                        \
 			ip += 5;                                                                                \
 		}                                                                                           \
 	}                                                                                               \
@@ -3462,6 +3644,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+				GDScriptSampler::poll();
+
 				if (EngineDebugger::is_active()) {
 					// line
 					bool do_break = false;
@@ -3559,17 +3743,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	// If that is the case then we exit the function as normal. Otherwise we postpone it until the last `await` is completed.
 	// This ensures the call stack can be properly shown when using `await`, showing what resumed the function.
 	if (!p_state || awaited) {
-		if (EngineDebugger::is_active()) {
+		if (GDScriptLanguage::get_singleton()->is_tracking_call_stack()) {
+			GDScriptSampler::poll();
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
 #endif
 
 		// Free stack, except reserved addresses.
-		for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
-			stack[i].~Variant();
+		if (!frame_suspended) {
+			for (int i = FIXED_ADDRESSES_MAX; i < _stack_size; i++) {
+				stack[i].~Variant();
+			}
 		}
 #ifdef DEBUG_ENABLED
 	}
+#else
+	// The function state keeps the stack in debug builds only, but the call stack is unwound in both.
+	if (GDScriptLanguage::get_singleton()->is_tracking_call_stack() && (!p_state || awaited)) {
+		GDScriptSampler::poll();
+		GDScriptLanguage::get_singleton()->exit_function();
+	}
 #endif
 
 	// Always free reserved addresses, since they are never copied.
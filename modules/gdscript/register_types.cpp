@@ -32,12 +32,14 @@
 
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_cache.h"
 #include "gdscript_tokenizer.h"
 #include "gdscript_utility_functions.h"
 
 #ifdef TOOLS_ENABLED
 #include "editor/gdscript_highlighter.h"
+#include "editor/gdscript_native_exporter.h"
 #include "editor/gdscript_translation_parser_plugin.h"
 
 #ifndef GDSCRIPT_NO_LSP
@@ -81,7 +83,22 @@ Ref<GDScriptEditorTranslationParserPlugin> gdscript_translation_parser_plugin;
 class EditorExportGDScript : public EditorExportPlugin {
 	GDCLASS(EditorExportGDScript, EditorExportPlugin);
 
+	GDScriptNativeExporter native_exporter;
+	String native_module_dir;
+	bool export_bytecode = true;
+
 public:
+	virtual void _get_export_options(const Ref<EditorExportPlatform> &p_export_platform, List<EditorExportPlatform::ExportOption> *r_options) const override {
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::BOOL, "gdscript/export_bytecode"), true));
+		r_options->push_back(EditorExportPlatform::ExportOption(PropertyInfo(Variant::STRING, "gdscript/native_module_dir", PROPERTY_HINT_GLOBAL_DIR), ""));
+	}
+
+	virtual void _export_begin(const HashSet<String> &p_features, bool p_debug, const String &p_path, int p_flags) override {
+		native_exporter.clear();
+		native_module_dir = get_option("gdscript/native_module_dir");
+		export_bytecode = get_option("gdscript/export_bytecode");
+	}
+
 	virtual void _export_file(const String &p_path, const String &p_type, const HashSet<String> &p_features) override {
 		String script_key;
 
@@ -95,7 +112,40 @@ public:
 			return;
 		}
 
-		return;
+		Error err = OK;
+		Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+		if (err != OK || script.is_null() || !script->is_valid()) {
+			return;
+		}
+
+		if (!native_module_dir.is_empty()) {
+			native_exporter.add_script(script);
+		}
+
+		// Without images, scripts are compiled from source when loaded, as in the editor.
+		if (!export_bytecode) {
+			return;
+		}
+
+		// The source is still exported, scripts are compiled from it when the image can't be used.
+		Vector<String> features;
+		for (const String &feature : p_features) {
+			features.push_back(feature);
+		}
+		Vector<uint8_t> image;
+		err = GDScriptBytecodeCache::save_for_export(script, features, image);
+		if (err == OK) {
+			add_file(GDScriptBytecodeCache::get_cache_path(p_path), image, false);
+		}
+	}
+
+	virtual void _export_end() override {
+		if (!native_module_dir.is_empty()) {
+			if (native_exporter.save_module(native_module_dir) == OK) {
+				print_line(vformat("GDScript: Wrote %d native functions to \"%s\", build export templates with `custom_modules=%s` to use them.", native_exporter.get_function_count(), native_module_dir.path_join(GDScriptNativeExporter::MODULE_NAME), native_module_dir));
+			}
+		}
+		native_exporter.clear();
 	}
 
 	virtual String get_name() const override { return "GDScript"; }
@@ -168,6 +218,7 @@ void uninitialize_gdscript_module(ModuleInitializationLevel p_level) {
 		ResourceSaver::remove_resource_format_saver(resource_saver_gd);
 		resource_saver_gd.unref();
 
+		GDScriptBytecodeCache::clear();
 		GDScriptParser::cleanup();
 		GDScriptUtilityFunctions::unregister_functions();
 	}
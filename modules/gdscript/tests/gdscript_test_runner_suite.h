@@ -33,6 +33,8 @@
 
 #include "gdscript_test_runner.h"
 
+#include "../gdscript_numeric_tier.h"
+
 #include "tests/test_macros.h"
 
 namespace GDScriptTests {
@@ -48,6 +50,17 @@ TEST_SUITE("[Modules][GDScript]") {
 		INFO("Make sure `*.out` files have expected results.");
 		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass.");
 	}
+
+	TEST_CASE("Script compilation and runtime with the numeric tier") {
+		// Translate eligible functions on their first call, so the corpus also checks the numeric tier.
+		const uint32_t call_threshold = GDScriptNumericTier::get_call_threshold();
+		GDScriptNumericTier::set_call_threshold(0);
+		GDScriptTestRunner runner("modules/gdscript/tests/scripts", true);
+		int fail_count = runner.run_tests();
+		GDScriptNumericTier::set_call_threshold(call_threshold);
+		INFO("Make sure `*.out` files have expected results.");
+		REQUIRE_MESSAGE(fail_count == 0, "All GDScript tests should pass with the numeric tier.");
+	}
 }
 
 TEST_CASE("[Modules][GDScript] Load source code dynamically and run it") {
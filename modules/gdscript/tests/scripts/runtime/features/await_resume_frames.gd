@@ -0,0 +1,21 @@
+signal step
+
+var results := []
+
+func worker(id: int, count: int) -> void:
+	var values := [id]
+	var text := "w%d" % id
+	for _i in count:
+		var value = await step
+		values.append(value)
+		text += ":" + str(value)
+	results.append(values)
+	results.append(text)
+
+func test():
+	worker(1, 3)
+	worker(2, 2)
+	step.emit("a")
+	step.emit("b")
+	step.emit("c")
+	print(results)
@@ -0,0 +1,27 @@
+const ENABLED = false
+const MODES = { "fast": 1, "slow": 2 }
+
+func pick() -> int:
+	if ENABLED:
+		return -1
+	elif MODES["fast"] == 1:
+		return MODES["slow"]
+	else:
+		return 0
+
+func test():
+	print(pick())
+
+	while ENABLED:
+		print("never")
+
+	var total := 0
+	for i in 5:
+		if i == 3:
+			continue
+		total += i
+	print(total)
+
+	if not ENABLED:
+		var local := "kept"
+		print(local)
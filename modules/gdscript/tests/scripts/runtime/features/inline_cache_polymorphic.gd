@@ -0,0 +1,71 @@
+# Untyped member access and calls, with receivers changing at the same call site.
+
+class A:
+	var value = 1
+	var doubled:
+		get:
+			return value * 2
+
+	func name():
+		return "A"
+
+	func add(x):
+		return value + x
+
+class B extends A:
+	func _init():
+		value = 10
+
+	func name():
+		return "B"
+
+class C:
+	var value = 100
+
+	func name():
+		return "C"
+
+	func add(x):
+		return value - x
+
+class D:
+	func name():
+		return "D"
+
+class E:
+	func name():
+		return "E"
+
+func describe(objects):
+	var names = []
+	for object in objects:
+		names.append(object.name())
+	return " ".join(names)
+
+func test():
+	var a = A.new()
+	var b = B.new()
+	var c = C.new()
+
+	var total = 0
+	for i in 3:
+		for object in [a, b, c]:
+			total += object.add(i) + object.value
+	print(total)
+
+	for i in 2:
+		print(a.doubled, " ", b.doubled)
+	b.value = 7
+	print(b.doubled)
+
+	# More receivers than a call site keeps.
+	for i in 2:
+		print(describe([a, b, c, D.new(), E.new(), a]))
+
+	# Native methods and properties, on objects with and without a script.
+	var resource = Resource.new()
+	resource.resource_name = "native"
+	for object in [resource, a, resource]:
+		print(object.get_class(), " ", object.is_class("RefCounted"))
+	for i in 2:
+		print(resource.resource_name)
@@ -0,0 +1,60 @@
+# Typed int and float arithmetic folded into assignments and loop conditions.
+# Operators reading the assigned local keep writing to a temporary.
+
+func sum_to(n: int) -> int:
+	var total: int = 0
+	var i := 0
+	while i < n:
+		total += i
+		i += 1
+	return total
+
+func factorial(n: int) -> int:
+	var result := 1
+	for k in range(2, n + 1):
+		result = result * k
+	return result
+
+func lerp_steps(from: float, to: float, steps: int) -> float:
+	var value := from
+	var step := (to - from) / float(steps)
+	var i := 0
+	while i < steps:
+		value = value + step
+		i = i + 1
+	return value
+
+func count_below(values: Array[int], limit: int) -> int:
+	var count := 0
+	for v in values:
+		if v < limit:
+			count += 1
+	return count
+
+func test():
+	print(sum_to(10))
+	print(sum_to(0))
+	print(factorial(10))
+	print(lerp_steps(0.0, 1.0, 4))
+	print(count_below([1, 5, 3, 8, -2], 4))
+
+	var a := 7
+	var b := 3
+	a -= b
+	print(a)
+	var x := 1.5
+	x *= x
+	print(x)
+	var declared_late: int
+	declared_late = a * b
+	print(declared_late)
+
+	var packed: PackedInt32Array = [3, 4]
+	var prefix: PackedInt32Array = [1, 2]
+	packed = prefix + packed
+	print(packed)
+	packed = packed + prefix
+	print(packed)
+	var text := "b"
+	text = "a" + text
+	print(text)
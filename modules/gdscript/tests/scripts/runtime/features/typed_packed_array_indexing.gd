@@ -0,0 +1,36 @@
+func build(count: int) -> PackedVector3Array:
+	var vertices := PackedVector3Array()
+	vertices.resize(count)
+	for i in count:
+		vertices[i] = Vector3(i, i * 2, 0)
+	return vertices
+
+func test():
+	var vertices := build(4)
+	var shared := vertices
+	var copy := vertices.duplicate()
+	copy[0] = Vector3(9, 9, 9)
+	vertices[-1] += Vector3(0, 0, 1)
+	print(vertices[-1], " ", shared[3], " ", copy[0], " ", vertices[0])
+
+	var floats := PackedFloat32Array([0.5, 1.5, 2.5])
+	var total := 0.0
+	for i in floats.size():
+		floats[i] = floats[i] * 2.0
+		total += floats[i]
+	print(floats, " ", total)
+
+	var bytes := PackedByteArray([1, 2, 3])
+	bytes[1] = 258
+	var ints := PackedInt32Array([7, 8])
+	var value := ints[1]
+	value = ints[0]
+	print(bytes, " ", value)
+
+	var names := PackedStringArray(["a", "b"])
+	names[0] = names[1] + "c"
+	print(names)
+
+	var colors := PackedColorArray([Color.RED])
+	colors[0].a = 0.5
+	print(colors[0])
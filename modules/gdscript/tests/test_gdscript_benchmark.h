@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*  test_gdscript_benchmark.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_BENCHMARK_H
+#define TEST_GDSCRIPT_BENCHMARK_H
+
+#include "../gdscript.h"
+
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+// Loop throughput of the VM on typed code. These are pending tests since timings are only
+// meaningful on optimized builds; run them with `--test --no-skip --test-case="*Benchmark*"`.
+
+namespace GDScriptTests {
+
+static const char *benchmark_source = R"(
+extends RefCounted
+
+func int_loop(n: int) -> int:
+	var total := 0
+	var i := 0
+	while i < n:
+		total += i * 3
+		i += 1
+	return total
+
+func float_loop(n: int) -> float:
+	var x := 0.0
+	var v := 1.0
+	var i := 0
+	while i < n:
+		v = v * 0.999 + 0.5
+		x += v / 3.0
+		i += 1
+	return x
+
+func array_loop(values: Array[int], n: int) -> int:
+	var total := 0
+	for j in n:
+		for value in values:
+			if value < j:
+				total += value
+	return total
+
+func untyped_loop(n):
+	var total = 0
+	var i = 0
+	while i < n:
+		total += i * 3
+		i += 1
+	return total
+
+func packed_loop(n: int) -> float:
+	var vertices := PackedVector3Array()
+	vertices.resize(n)
+	var heights := PackedFloat32Array()
+	heights.resize(n)
+	for i in n:
+		heights[i] = i * 0.5
+	for i in n:
+		vertices[i] = Vector3(i, heights[i], 0.0)
+	var total := 0.0
+	for vertex in vertices:
+		total += vertex.y
+	return total
+
+signal step
+var resumed := 0
+
+func await_loop(n: int) -> void:
+	var total := 0
+	for i in n:
+		total += await step
+		resumed += 1
+)";
+
+static void run_benchmark(Object *p_object, const StringName &p_method, const Vector<Variant> &p_args, int64_t p_iterations) {
+	const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * p_args.size());
+	for (int i = 0; i < p_args.size(); i++) {
+		argptrs[i] = &p_args[i];
+	}
+
+	Callable::CallError ce;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	p_object->callp(p_method, argptrs, p_args.size(), ce);
+	const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+
+	MESSAGE(vformat("%s: %d iterations in %.2f ms, %.1f M iterations/s", p_method, p_iterations, elapsed / 1000.0, double(p_iterations) / elapsed).utf8().get_data());
+}
+
+TEST_CASE_PENDING("[Modules][GDScript][Benchmark] Typed loop throughput") {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(benchmark_source);
+	REQUIRE(script->reload() == OK);
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+	REQUIRE(object->get_script_instance() != nullptr);
+
+	const int64_t n = 2000000;
+	run_benchmark(object.ptr(), "int_loop", varray(n), n);
+	run_benchmark(object.ptr(), "float_loop", varray(n), n);
+	run_benchmark(object.ptr(), "untyped_loop", varray(n), n);
+
+	TypedArray<int> values;
+	for (int i = 0; i < 100; i++) {
+		values.push_back(i);
+	}
+	run_benchmark(object.ptr(), "array_loop", varray(values, n / 100), n);
+	run_benchmark(object.ptr(), "packed_loop", varray(n), n);
+
+	object->set_script(Variant());
+}
+
+TEST_CASE_PENDING("[Modules][GDScript][Benchmark] Await and resume throughput") {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(benchmark_source);
+	REQUIRE(script->reload() == OK);
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+	REQUIRE(object->get_script_instance() != nullptr);
+
+	// Many coroutines each awaiting the same signal in a loop, like per-agent logic waiting on timers.
+	const int coroutines = 1000;
+	const int steps = 1000;
+	for (int i = 0; i < coroutines; i++) {
+		object->call("await_loop", steps);
+	}
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < steps; i++) {
+		object->emit_signal("step", 1);
+	}
+	const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+	const int64_t resumes = int64_t(coroutines) * steps;
+	CHECK(int64_t(object->get("resumed")) == resumes);
+
+	MESSAGE(vformat("await_loop: %d resumes in %.2f ms, %.1f M resumes/s", resumes, elapsed / 1000.0, double(resumes) / elapsed).utf8().get_data());
+
+	object->set_script(Variant());
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_BENCHMARK_H
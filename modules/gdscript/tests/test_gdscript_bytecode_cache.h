@@ -0,0 +1,254 @@
+/**************************************************************************/
+/*  test_gdscript_bytecode_cache.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_BYTECODE_CACHE_H
+#define TEST_GDSCRIPT_BYTECODE_CACHE_H
+
+#include "../gdscript.h"
+#include "../gdscript_analyzer.h"
+#include "../gdscript_bytecode_cache.h"
+#include "../gdscript_cache.h"
+#include "../gdscript_compiler.h"
+#include "../gdscript_parser.h"
+
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static const char *bytecode_cache_source = R"(
+extends RefCounted
+
+class Inner:
+	var value := 3
+
+	func twice() -> int:
+		return value * 2
+
+var items: Array[int] = [1, 2, 3]
+var lookup := { "a": 1 }
+
+static func add(a: int, b: int = 5) -> int:
+	return a + b
+
+func total() -> int:
+	var sum := 0
+	for item in items:
+		sum += item
+	return sum
+
+func inner_value() -> int:
+	return Inner.new().twice()
+
+func with_lambda() -> int:
+	var offset := 4
+	var f := func(x: int) -> int: return x + offset
+	return f.call(lookup["a"])
+
+func vector_length() -> float:
+	return Vector2(3, 4).length()
+)";
+
+static Ref<GDScript> compile_bytecode_cache_script(const String &p_source) {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error err = script->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(err == OK, "The script should compile successfully.");
+	return script;
+}
+
+TEST_CASE("[Modules][GDScript][BytecodeCache] Loaded script behaves like the compiled one") {
+	Ref<GDScript> compiled = compile_bytecode_cache_script(bytecode_cache_source);
+
+	Vector<uint8_t> image;
+	REQUIRE(GDScriptBytecodeCache::save(compiled, image) == OK);
+	CHECK(image.size() > 0);
+
+	Ref<GDScript> loaded;
+	loaded.instantiate();
+	loaded->set_source_code(bytecode_cache_source);
+	REQUIRE(GDScriptBytecodeCache::make_scripts(loaded.ptr(), image) == OK);
+	REQUIRE(GDScriptBytecodeCache::load(loaded.ptr(), image) == OK);
+	CHECK(loaded->is_valid());
+	CHECK(loaded->get_subclasses().has("Inner"));
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(loaded);
+	REQUIRE(object->get_script_instance() != nullptr);
+
+	CHECK(int(object->call("total")) == 6);
+	CHECK(int(object->call("inner_value")) == 6);
+	CHECK(int(object->call("with_lambda")) == 5);
+	CHECK(double(object->call("vector_length")) == doctest::Approx(5.0));
+	CHECK(int(loaded->call("add", 1)) == 6);
+	CHECK(int(loaded->call("add", 1, 2)) == 3);
+
+	// Loading replaces compilation, it doesn't apply to compiled scripts.
+	CHECK(GDScriptBytecodeCache::load(loaded.ptr(), image) == ERR_ALREADY_IN_USE);
+
+	object->set_script(Variant());
+}
+
+TEST_CASE("[Modules][GDScript][BytecodeCache] Stale and corrupted images are rejected") {
+	Ref<GDScript> compiled = compile_bytecode_cache_script(bytecode_cache_source);
+
+	Vector<uint8_t> image;
+	REQUIRE(GDScriptBytecodeCache::save(compiled, image) == OK);
+
+	SUBCASE("Source changed since the image was saved") {
+		Ref<GDScript> changed;
+		changed.instantiate();
+		changed->set_source_code(String(bytecode_cache_source) + "\nfunc extra():\n\tpass\n");
+		CHECK(GDScriptBytecodeCache::make_scripts(changed.ptr(), image) == ERR_INVALID_DATA);
+		CHECK(GDScriptBytecodeCache::load(changed.ptr(), image) == ERR_INVALID_DATA);
+		CHECK_FALSE(changed->is_valid());
+	}
+
+	SUBCASE("Truncated image") {
+		Ref<GDScript> loaded;
+		loaded.instantiate();
+		loaded->set_source_code(bytecode_cache_source);
+		image.resize(image.size() / 2);
+		CHECK(GDScriptBytecodeCache::load(loaded.ptr(), image) == ERR_INVALID_DATA);
+		CHECK_FALSE(loaded->is_valid());
+	}
+}
+
+TEST_CASE("[Modules][GDScript][BytecodeCache] Release images") {
+	const String source = R"(
+extends RefCounted
+
+func checked(value: int) -> int:
+	assert(value > 0)
+	return value * 2
+)";
+
+	// Compiled the way exports for release builds do it.
+	Ref<GDScript> compiled;
+	compiled.instantiate();
+	compiled->set_source_code(source);
+	GDScriptParser parser;
+	REQUIRE(parser.parse(source, "", false) == OK);
+	GDScriptAnalyzer analyzer(&parser);
+	REQUIRE(analyzer.analyze() == OK);
+	GDScriptCompiler compiler;
+	compiler.set_debug_code(false);
+	REQUIRE(compiler.compile(&parser, compiled.ptr()) == OK);
+
+	Vector<uint8_t> image;
+	REQUIRE(GDScriptBytecodeCache::save(compiled, image) == OK);
+
+	Ref<GDScript> loaded;
+	loaded.instantiate();
+	loaded->set_source_code(source);
+
+	// Only builds of the same type use the image.
+	CHECK(GDScriptBytecodeCache::load(loaded.ptr(), image, true) == ERR_INVALID_DATA);
+	REQUIRE(GDScriptBytecodeCache::make_scripts(loaded.ptr(), image, false) == OK);
+	REQUIRE(GDScriptBytecodeCache::load(loaded.ptr(), image, false) == OK);
+	CHECK(loaded->is_valid());
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(loaded);
+	REQUIRE(object->get_script_instance() != nullptr);
+
+	CHECK(int(object->call("checked", 2)) == 4);
+	// Release code has no asserts.
+	CHECK(int(object->call("checked", -1)) == -2);
+
+	object->set_script(Variant());
+}
+
+TEST_CASE("[Modules][GDScript][BytecodeCache] Exports use the optimization level of their features") {
+	const String source = "extends RefCounted\n\nfunc is_debug() -> bool:\n\treturn OS.is_debug_build()\n";
+	const String dir = OS::get_singleton()->get_cache_path().path_join("gdscript_bytecode_cache_test");
+	const String path = dir.path_join("export.gd");
+	DirAccess::make_dir_recursive_absolute(dir);
+	{
+		Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(file.is_valid());
+		file->store_string(source);
+	}
+
+	const String setting = "gdscript/compiler/optimization_level.release";
+	ProjectSettings::get_singleton()->set_setting(setting, GDScriptCompiler::OPTIMIZATION_BUILD_CONSTANTS);
+
+	Error err = OK;
+	Ref<GDScript> script = GDScriptCache::get_full_script(path, err);
+	REQUIRE(err == OK);
+
+	Vector<String> features;
+	features.push_back("release");
+	Vector<uint8_t> image;
+	REQUIRE(GDScriptBytecodeCache::save_for_export(script, features, image) == OK);
+
+	Ref<GDScript> loaded;
+	loaded.instantiate();
+	loaded->set_source_code(source);
+	REQUIRE(GDScriptBytecodeCache::make_scripts(loaded.ptr(), image, false) == OK);
+	REQUIRE(GDScriptBytecodeCache::load(loaded.ptr(), image, false) == OK);
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(loaded);
+	REQUIRE(object->get_script_instance() != nullptr);
+	// Tests run in a debug build, so only the folded constant returns false here.
+	CHECK_FALSE(bool(object->call("is_debug")));
+	object->set_script(Variant());
+
+	// The override doesn't apply to debug exports, which keep the call.
+	features.clear();
+	features.push_back("debug");
+	REQUIRE(GDScriptBytecodeCache::save_for_export(script, features, image) == OK);
+	loaded.instantiate();
+	loaded->set_source_code(source);
+	REQUIRE(GDScriptBytecodeCache::make_scripts(loaded.ptr(), image, true) == OK);
+	REQUIRE(GDScriptBytecodeCache::load(loaded.ptr(), image, true) == OK);
+	object->set_script(loaded);
+	REQUIRE(object->get_script_instance() != nullptr);
+	CHECK(bool(object->call("is_debug")) == GDScriptBytecodeCache::DEBUG_BUILD);
+	object->set_script(Variant());
+
+	ProjectSettings::get_singleton()->set_setting(setting, Variant());
+	CHECK(DirAccess::remove_absolute(path) == OK);
+	CHECK(DirAccess::remove_absolute(dir) == OK);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_BYTECODE_CACHE_H
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  test_gdscript_cache.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_CACHE_H
+#define TEST_GDSCRIPT_CACHE_H
+
+#include "../gdscript_cache.h"
+#include "../gdscript_parser.h"
+
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static String get_cache_test_dir() {
+	return OS::get_singleton()->get_cache_path().path_join("gdscript_cache_test");
+}
+
+static String write_cache_test_script(const String &p_name, const String &p_source) {
+	const String path = get_cache_test_dir().path_join(p_name);
+	DirAccess::make_dir_recursive_absolute(path.get_base_dir());
+	Ref<FileAccess> file = FileAccess::open(path, FileAccess::WRITE);
+	file->store_string(p_source);
+	return path;
+}
+
+TEST_CASE("[Modules][GDScript][Cache] Scripts and their references are parsed ahead") {
+	const String main_path = write_cache_test_script("main.gd", "extends \"base.gd\"\nconst Shared = preload(\"shared/shared.gd\")\nfunc f():\n\treturn Shared.VALUE\n");
+	const String base_path = write_cache_test_script("base.gd", "const Helper = preload(\"res://missing_helper.gd\")\nvar base_value = 1\n");
+	const String shared_path = write_cache_test_script("shared/shared.gd", "const VALUE = 2\n");
+	const String unused_path = write_cache_test_script("unused.gd", "var unused_value = 3\n");
+
+	Vector<String> paths;
+	paths.push_back(main_path);
+	GDScriptCache::parse_scripts(paths);
+
+	// Only parsers filled by `parse_scripts()` collect the names they contain.
+	const String parsed_paths[] = { main_path, base_path, shared_path };
+	for (const String &path : parsed_paths) {
+		Error err = OK;
+		Ref<GDScriptParserRef> ref = GDScriptCache::get_parser(path, GDScriptParserRef::PARSED, err);
+		CHECK_MESSAGE(err == OK, path);
+		REQUIRE(ref.is_valid());
+		CHECK_MESSAGE(!ref->get_parser()->get_dependency_names().is_empty(), path);
+	}
+
+	{
+		Error err = OK;
+		Ref<GDScriptParserRef> ref = GDScriptCache::get_parser(unused_path, GDScriptParserRef::PARSED, err);
+		REQUIRE(ref.is_valid());
+		CHECK(ref->get_parser()->get_dependency_names().is_empty());
+	}
+
+	{
+		Error err = OK;
+		Ref<GDScriptParserRef> ref = GDScriptCache::get_parser(main_path, GDScriptParserRef::PARSED, err);
+		const Vector<String> &dependencies = ref->get_parser()->get_dependency_paths();
+		REQUIRE(dependencies.size() == 2);
+		CHECK(dependencies[0] == "base.gd");
+		CHECK(dependencies[1] == "shared/shared.gd");
+	}
+
+	GDScriptCache::release_parsed_scripts();
+
+	Ref<DirAccess> dir = DirAccess::open(get_cache_test_dir());
+	REQUIRE(dir.is_valid());
+	CHECK(dir->erase_contents_recursive() == OK);
+	CHECK(DirAccess::remove_absolute(get_cache_test_dir()) == OK);
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_CACHE_H
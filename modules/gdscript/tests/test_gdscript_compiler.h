@@ -0,0 +1,124 @@
+/**************************************************************************/
+/*  test_gdscript_compiler.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_COMPILER_H
+#define TEST_GDSCRIPT_COMPILER_H
+
+#include "../gdscript_analyzer.h"
+#include "../gdscript_compiler.h"
+#include "../gdscript_parser.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static const char *optimization_source = R"(
+extends RefCounted
+
+const VERBOSE = false
+
+static func constant_branch(n: int) -> int:
+	if VERBOSE:
+		var a := n * 2
+		var b := a + 1
+		print(a, b)
+	elif n > 100:
+		return 0
+	return n + 1
+
+static func after_return(n: int) -> int:
+	return n * 2
+	var unused := n + 3
+	return unused
+
+static func debug_only(n: int) -> int:
+	if not OS.is_debug_build():
+		var x := n - 1
+		var y := x - 1
+		return y
+	return n
+)";
+
+static Ref<GDScript> compile_optimization_script(GDScriptCompiler::OptimizationLevel p_level) {
+	GDScriptParser parser;
+	REQUIRE(parser.parse(optimization_source, "res://optimization_test.gd", false) == OK);
+	GDScriptAnalyzer analyzer(&parser);
+	REQUIRE(analyzer.analyze() == OK);
+
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_path("res://optimization_test.gd");
+
+	GDScriptCompiler compiler;
+	compiler.set_optimization_level(p_level);
+	REQUIRE(compiler.compile(&parser, script.ptr(), false) == OK);
+	return script;
+}
+
+static int64_t call_optimization_function(const Ref<GDScript> &p_script, const StringName &p_name, int64_t p_arg) {
+	GDScriptFunction *function = p_script->get_member_functions()[p_name];
+	Variant arg = p_arg;
+	const Variant *args[1] = { &arg };
+	Callable::CallError ce;
+	Variant ret = function->call(nullptr, args, 1, ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	return ret;
+}
+
+static int get_optimization_stack_size(const Ref<GDScript> &p_script, const StringName &p_name) {
+	return p_script->get_member_functions()[p_name]->get_max_stack_size();
+}
+
+TEST_CASE("[Modules][GDScript][Compiler] Optimization levels") {
+	Ref<GDScript> none = compile_optimization_script(GDScriptCompiler::OPTIMIZATION_NONE);
+	Ref<GDScript> branches = compile_optimization_script(GDScriptCompiler::OPTIMIZATION_CONSTANT_BRANCHES);
+	Ref<GDScript> build = compile_optimization_script(GDScriptCompiler::OPTIMIZATION_BUILD_CONSTANTS);
+
+	// Locals of code that can't run are never allocated.
+	CHECK(get_optimization_stack_size(branches, "constant_branch") < get_optimization_stack_size(none, "constant_branch"));
+	CHECK(get_optimization_stack_size(branches, "debug_only") == get_optimization_stack_size(none, "debug_only"));
+#ifdef DEBUG_ENABLED
+	CHECK(get_optimization_stack_size(build, "debug_only") < get_optimization_stack_size(branches, "debug_only"));
+	const int64_t debug_only_result = 5;
+#else
+	const int64_t debug_only_result = 3;
+#endif
+
+	for (const Ref<GDScript> &script : { none, branches, build }) {
+		CHECK(call_optimization_function(script, "constant_branch", 1) == 2);
+		CHECK(call_optimization_function(script, "constant_branch", 101) == 0);
+		CHECK(call_optimization_function(script, "after_return", 3) == 6);
+		CHECK(call_optimization_function(script, "debug_only", 5) == debug_only_result);
+	}
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_COMPILER_H
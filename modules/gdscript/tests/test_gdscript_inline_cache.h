@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*  test_gdscript_inline_cache.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_INLINE_CACHE_H
+#define TEST_GDSCRIPT_INLINE_CACHE_H
+
+#include "../gdscript.h"
+#include "../gdscript_inline_cache.h"
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static Ref<GDScript> compile_inline_cache_script(const String &p_source, const Ref<GDScript> &p_script = Ref<GDScript>()) {
+	Ref<GDScript> script = p_script;
+	if (script.is_null()) {
+		script.instantiate();
+	}
+	script->set_source_code(p_source);
+	ERR_PRINT_OFF;
+	const Error err = script->reload(true);
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(err == OK, "The script should compile successfully.");
+	return script;
+}
+
+static Variant call_inline_cache(GDScriptInlineCache &p_cache, Object *p_object, const StringName &p_method, bool &r_handled) {
+	Variant ret;
+	Callable::CallError ce;
+	r_handled = p_cache.call(p_object, p_method, nullptr, 0, ret, ce);
+	if (r_handled) {
+		CHECK(ce.error == Callable::CallError::CALL_OK);
+	}
+	return ret;
+}
+
+TEST_CASE("[Modules][GDScript][InlineCache] Script entries follow the epoch") {
+	Ref<GDScript> script = compile_inline_cache_script("extends RefCounted\nvar member := 10\nfunc value():\n\treturn 1\n");
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	GDScriptInlineCache cache;
+	bool handled = false;
+	CHECK(int(call_inline_cache(cache, object.ptr(), "value", handled)) == 1);
+	CHECK(handled);
+	// Hits don't count as misses.
+	for (int i = 0; i < GDScriptInlineCache::MAX_MISSES * 2; i++) {
+		CHECK(int(call_inline_cache(cache, object.ptr(), "value", handled)) == 1);
+	}
+	CHECK_FALSE(cache.is_megamorphic());
+
+	// Recompiling frees the cached function, the next call must resolve the new one.
+	compile_inline_cache_script("extends RefCounted\nvar member := 10\nfunc value():\n\treturn 2\n", script);
+	CHECK(int(call_inline_cache(cache, object.ptr(), "value", handled)) == 2);
+	CHECK(handled);
+
+	GDScriptInlineCache get_cache;
+	Variant member;
+	CHECK(get_cache.get(object.ptr(), "member", member));
+	CHECK(int(member) == 10);
+	object->set("member", 20);
+	CHECK(get_cache.get(object.ptr(), "member", member));
+	CHECK(int(member) == 20);
+
+	// Scripts are compiled and freed at any time, each epoch refills the entry without counting as
+	// a miss, so the site keeps caching.
+	for (int i = 0; i < GDScriptInlineCache::MAX_MISSES * 2; i++) {
+		GDScriptInlineCache::invalidate();
+		CHECK(int(call_inline_cache(cache, object.ptr(), "value", handled)) == 2);
+		CHECK(handled);
+	}
+	CHECK_FALSE(cache.is_megamorphic());
+
+	// Entries left by other scripts in older epochs are reused by new receivers, so compiling a new
+	// script for each receiver keeps a slot available past `MAX_ENTRIES`.
+	{
+		GDScriptInlineCache reuse_cache;
+		LocalVector<Ref<RefCounted>> objects;
+		for (int i = 0; i < GDScriptInlineCache::MAX_ENTRIES * 2; i++) {
+			Ref<GDScript> other = compile_inline_cache_script(vformat("extends RefCounted\nfunc value():\n\treturn %d\n", i));
+			Ref<RefCounted> other_object;
+			other_object.instantiate();
+			other_object->set_script(other);
+			objects.push_back(other_object);
+			CHECK(int(call_inline_cache(reuse_cache, other_object.ptr(), "value", handled)) == i);
+			CHECK(handled);
+		}
+		CHECK_FALSE(reuse_cache.is_megamorphic());
+		for (Ref<RefCounted> &other_object : objects) {
+			other_object->set_script(Variant());
+		}
+	}
+
+	object->set_script(Variant());
+}
+
+TEST_CASE("[Modules][GDScript][InlineCache] Native entries ignore the epoch") {
+	Ref<RefCounted> object;
+	object.instantiate();
+
+	GDScriptInlineCache cache;
+	bool handled = false;
+	for (int i = 0; i < GDScriptInlineCache::MAX_MISSES * 2; i++) {
+		GDScriptInlineCache::invalidate();
+		CHECK(int(call_inline_cache(cache, object.ptr(), "get_reference_count", handled)) == 1);
+		CHECK(handled);
+	}
+	CHECK_FALSE(cache.is_megamorphic());
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Modules][GDScript][InlineCache] Receivers can't be freed during cached calls") {
+	Ref<GDScript> script = compile_inline_cache_script("extends Object\nfunc free_self():\n\tfree()\n");
+	Object *object = memnew(Object);
+	const ObjectID id = object->get_instance_id();
+	object->set_script(script);
+
+	GDScriptInlineCache cache;
+	bool handled = false;
+	ERR_PRINT_OFF;
+	call_inline_cache(cache, object, "free_self", handled);
+	ERR_PRINT_ON;
+	CHECK(handled);
+	// Same as through `Object::callp()`, the object is locked while it runs one of its methods.
+	CHECK(ObjectDB::get_instance(id) == object);
+
+	memdelete(object);
+}
+#endif // DEBUG_ENABLED
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_INLINE_CACHE_H
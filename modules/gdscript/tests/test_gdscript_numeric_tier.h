@@ -0,0 +1,319 @@
+/**************************************************************************/
+/*  test_gdscript_numeric_tier.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_NUMERIC_TIER_H
+#define TEST_GDSCRIPT_NUMERIC_TIER_H
+
+#include "../gdscript.h"
+#include "../gdscript_numeric_tier.h"
+
+#include "core/variant/variant_internal.h"
+
+#ifdef TOOLS_ENABLED
+#include "../editor/gdscript_native_exporter.h"
+#endif
+
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+static const char *numeric_tier_source = R"(
+extends RefCounted
+
+var member := 1
+
+func sum_to(n: int) -> int:
+	var total := 0
+	var i := 0
+	while i < n:
+		total += i * 2 - 1
+		i += 1
+	return total
+
+func mixed(a: int, b: float) -> float:
+	var result := 0.0
+	for i in a:
+		if i % 2 == 0 or b > 10.0:
+			result += b / (i + 1)
+		else:
+			result -= -b * i
+	return result
+
+func clamp_steps(x: float, steps: int) -> int:
+	var value: int
+	value = int(x * steps)
+	if value > steps:
+		return steps
+	return value if value >= 0 else 0
+
+func compare(a: int, b: int) -> bool:
+	return a <= b and not (a == b)
+
+func uses_member(n: int) -> int:
+	return n + member
+
+func with_default(n: int, m: int = 2) -> int:
+	return n * m
+
+func maybe_assigned(a: int):
+	var x
+	if a > 0:
+		x = 1
+	return x
+
+func always_assigned(a: int):
+	var x
+	if a > 0:
+		x = 1
+	else:
+		x = 2
+	return x
+)";
+
+static Ref<GDScript> compile_numeric_tier_script() {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(numeric_tier_source);
+	ERR_PRINT_OFF;
+	const Error err = script->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(err == OK, "The script should compile successfully.");
+	return script;
+}
+
+static Variant call_interpreted(Object *p_object, const StringName &p_method, const Vector<Variant> &p_args) {
+	const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * p_args.size());
+	for (int i = 0; i < p_args.size(); i++) {
+		argptrs[i] = &p_args[i];
+	}
+	Callable::CallError ce;
+	Variant ret = p_object->callp(p_method, argptrs, p_args.size(), ce);
+	CHECK(ce.error == Callable::CallError::CALL_OK);
+	return ret;
+}
+
+static Variant call_numeric_program(const GDScriptNumericTier::Program *p_program, const Vector<Variant> &p_args, bool &r_called) {
+	const Variant **argptrs = (const Variant **)alloca(sizeof(Variant *) * p_args.size());
+	for (int i = 0; i < p_args.size(); i++) {
+		argptrs[i] = &p_args[i];
+	}
+	Variant ret;
+	r_called = GDScriptNumericTier::call(p_program, argptrs, p_args.size(), ret);
+	return ret;
+}
+
+TEST_CASE("[Modules][GDScript][NumericTier] Translated functions match the interpreter") {
+	Ref<GDScript> script = compile_numeric_tier_script();
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+	REQUIRE(object->get_script_instance() != nullptr);
+
+	const HashMap<StringName, GDScriptFunction *> &functions = script->get_member_functions();
+
+	// `mixed` uses integer modulo, which stays in the interpreter.
+	const char *translated[] = { "sum_to", "clamp_steps", "compare" };
+	const Vector<Variant> arguments[] = { varray(100), varray(0.75, 8), varray(3, 4) };
+	for (int i = 0; i < 3; i++) {
+		GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(functions[translated[i]]);
+		REQUIRE_MESSAGE(program != nullptr, translated[i]);
+
+		bool called = false;
+		Variant ret = call_numeric_program(program, arguments[i], called);
+		CHECK(called);
+		Variant expected = call_interpreted(object.ptr(), translated[i], arguments[i]);
+		CHECK(ret.get_type() == expected.get_type());
+		CHECK(ret == expected);
+
+		memdelete(program);
+	}
+
+	CHECK(GDScriptNumericTier::translate(functions["mixed"]) == nullptr);
+	CHECK(GDScriptNumericTier::translate(functions["uses_member"]) == nullptr);
+	CHECK(GDScriptNumericTier::translate(functions["with_default"]) == nullptr);
+
+	object->set_script(Variant());
+}
+
+TEST_CASE("[Modules][GDScript][NumericTier] Argument type guard") {
+	Ref<GDScript> script = compile_numeric_tier_script();
+	GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(script->get_member_functions()["clamp_steps"]);
+	REQUIRE(program != nullptr);
+
+	bool called = false;
+	CHECK(int(call_numeric_program(program, varray(1.5, 4), called)) == 4);
+	CHECK(called);
+	CHECK(int(call_numeric_program(program, varray(-0.5, 4), called)) == 0);
+	CHECK(called);
+
+	// These need conversions or report errors, which the interpreter takes care of.
+	call_numeric_program(program, varray(1, 4), called);
+	CHECK_FALSE(called);
+	call_numeric_program(program, varray(1.5), called);
+	CHECK_FALSE(called);
+	call_numeric_program(program, varray(1.5, "4"), called);
+	CHECK_FALSE(called);
+
+	memdelete(program);
+}
+
+TEST_CASE("[Modules][GDScript][NumericTier] Hot functions tier up") {
+	const uint32_t call_threshold = GDScriptNumericTier::get_call_threshold();
+	GDScriptNumericTier::set_call_threshold(3);
+
+	Ref<GDScript> script = compile_numeric_tier_script();
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	for (int i = 0; i < 10; i++) {
+		CHECK(int(object->call("sum_to", i)) == i * i - 2 * i);
+		CHECK(bool(object->call("compare", i, 5)) == (i < 5));
+		// An int for a float argument falls back to the interpreter, which converts it.
+		CHECK(int(object->call("clamp_steps", 1, 4)) == 4);
+	}
+
+	GDScriptNumericTier::set_call_threshold(call_threshold);
+	object->set_script(Variant());
+}
+
+TEST_CASE("[Modules][GDScript][NumericTier] Locals must be assigned on every path") {
+	const uint32_t call_threshold = GDScriptNumericTier::get_call_threshold();
+	GDScriptNumericTier::set_call_threshold(1);
+
+	Ref<GDScript> script = compile_numeric_tier_script();
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	// `x` is only assigned on one branch, the interpreter returns `null` on the other.
+	const HashMap<StringName, GDScriptFunction *> &functions = script->get_member_functions();
+	CHECK(GDScriptNumericTier::translate(functions["maybe_assigned"]) == nullptr);
+	GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(functions["always_assigned"]);
+	CHECK(program != nullptr);
+	if (program) {
+		memdelete(program);
+	}
+
+	// Hot calls give the same results as the interpreter.
+	for (int i = 0; i < 4; i++) {
+		const int a = i % 2 == 0 ? 0 : 5;
+		const Variant maybe = object->call("maybe_assigned", a);
+		CHECK(maybe.get_type() == (a > 0 ? Variant::INT : Variant::NIL));
+		CHECK(maybe == (a > 0 ? Variant(1) : Variant()));
+		CHECK(int(object->call("always_assigned", a)) == (a > 0 ? 1 : 2));
+	}
+
+	GDScriptNumericTier::set_call_threshold(call_threshold);
+	object->set_script(Variant());
+}
+
+#ifdef TOOLS_ENABLED
+TEST_CASE("[Modules][GDScript][NumericTier] Native export") {
+	Ref<GDScript> script = compile_numeric_tier_script();
+	GDScriptFunction *function = script->get_member_functions()["sum_to"];
+	GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(function);
+	REQUIRE(program != nullptr);
+
+	const String code = GDScriptNativeExporter::emit_function(program, "sum_to_native");
+	CHECK(code.begins_with("static bool sum_to_native(const Variant **p_args, int p_argcount, Variant &r_ret) {"));
+	CHECK(code.contains("p_argcount != 1 || p_args[0]->get_type() != Variant::INT"));
+	CHECK(code.contains("goto L"));
+	CHECK(code.contains("return true;"));
+
+	// The key changes with the code, so stale native functions are never used.
+	const String key = GDScriptNumericTier::get_native_key(function, program);
+	CHECK(key.begins_with(script->get_fully_qualified_name() + "::sum_to::"));
+	program->code[0].a++;
+	CHECK(GDScriptNumericTier::get_native_key(function, program) != key);
+	memdelete(program);
+
+	GDScriptNativeExporter exporter;
+	exporter.add_script(script);
+	CHECK(exporter.get_function_count() >= 3);
+}
+#endif // TOOLS_ENABLED
+
+static int sum_to_native_calls = 0;
+
+// Written the way `GDScriptNativeExporter` emits `sum_to`, with structured loops instead of labels.
+static bool sum_to_native(const Variant **p_args, int p_argcount, Variant &r_ret) {
+	if (p_argcount != 1 || p_args[0]->get_type() != Variant::INT) {
+		return false;
+	}
+	const int64_t n = *VariantInternal::get_int(p_args[0]);
+	int64_t total = 0;
+	for (int64_t i = 0; i < n; i++) {
+		total += i * 2 - 1;
+	}
+	sum_to_native_calls++;
+	r_ret = total;
+	return true;
+}
+
+TEST_CASE("[Modules][GDScript][NumericTier] Native functions run from their first call") {
+	const uint32_t call_threshold = GDScriptNumericTier::get_call_threshold();
+	GDScriptNumericTier::set_call_threshold(UINT32_MAX);
+
+	Ref<GDScript> script = compile_numeric_tier_script();
+	GDScriptFunction *function = script->get_member_functions()["sum_to"];
+	GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(function);
+	REQUIRE(program != nullptr);
+	const String key = GDScriptNumericTier::get_native_key(function, program);
+	memdelete(program);
+
+	CHECK_FALSE(GDScriptNumericTier::has_native_function(function));
+	GDScriptNumericTier::register_native_function(key, sum_to_native);
+	CHECK(GDScriptNumericTier::has_native_function(function));
+	CHECK_FALSE(GDScriptNumericTier::has_native_function(script->get_member_functions()["compare"]));
+
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	sum_to_native_calls = 0;
+	for (int i = 0; i < 10; i++) {
+		CHECK(int(object->call("sum_to", i)) == i * i - 2 * i);
+		CHECK(bool(object->call("compare", i, 5)) == (i < 5));
+	}
+	CHECK(sum_to_native_calls == 10);
+	// Arguments that fail the guard still run as bytecode.
+	CHECK(int(object->call("sum_to", 4.0)) == 8);
+	CHECK(sum_to_native_calls == 10);
+
+	GDScriptNumericTier::unregister_native_function(key);
+	CHECK_FALSE(GDScriptNumericTier::has_native_function(function));
+	GDScriptNumericTier::set_call_threshold(call_threshold);
+	object->set_script(Variant());
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_NUMERIC_TIER_H
@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*  test_gdscript_sampler.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GDSCRIPT_SAMPLER_H
+#define TEST_GDSCRIPT_SAMPLER_H
+
+#include "../gdscript.h"
+#include "../gdscript_numeric_tier.h"
+#include "../gdscript_sampler.h"
+
+#include "core/io/json.h"
+#include "tests/test_macros.h"
+
+namespace GDScriptTests {
+
+TEST_CASE("[Modules][GDScript][Sampler] Folded and speedscope export") {
+	GDScriptSampler sampler;
+	sampler.add_sample("res://main.gd:_process;res://enemy.gd:think", 3);
+	sampler.add_sample("res://main.gd:_process", 1);
+	sampler.add_sample("res://main.gd:_process;res://enemy.gd:think", 2);
+	sampler.add_sample(GDScriptSampler::ENGINE_FRAME, 4);
+
+	CHECK(sampler.get_sample_count() == 10);
+	CHECK(sampler.to_folded() == "<engine> 4\nres://main.gd:_process 1\nres://main.gd:_process;res://enemy.gd:think 5\n");
+
+	Dictionary file = JSON::parse_string(sampler.to_speedscope("test"));
+	Array frames = Dictionary(file["shared"])["frames"];
+	REQUIRE(frames.size() == 3);
+	CHECK(Dictionary(frames[1])["name"] == Variant("_process"));
+	CHECK(Dictionary(frames[1])["file"] == Variant("res://main.gd"));
+	CHECK(Dictionary(frames[2])["name"] == Variant("think"));
+
+	Dictionary profile = Array(file["profiles"])[0];
+	CHECK(profile["type"] == Variant("sampled"));
+	Array samples = profile["samples"];
+	Array weights = profile["weights"];
+	REQUIRE(samples.size() == 3);
+	CHECK(Array(samples[2]).size() == 2);
+	CHECK(int(weights[2]) == int(5 * GDScriptSampler::DEFAULT_INTERVAL_USEC));
+	CHECK(int(profile["endValue"]) == int(10 * GDScriptSampler::DEFAULT_INTERVAL_USEC));
+
+	sampler.clear();
+	CHECK(sampler.get_sample_count() == 0);
+	CHECK(sampler.to_folded().is_empty());
+}
+
+TEST_CASE("[Modules][GDScript][Sampler] Running functions are sampled") {
+	Ref<GDScript> script;
+	script.instantiate();
+	script->set_source_code(R"(
+extends RefCounted
+
+func busy(usec: int) -> int:
+	var start := Time.get_ticks_usec()
+	var count := 0
+	while Time.get_ticks_usec() - start < usec:
+		count += 1
+	return count
+
+func sum_to(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i
+	return total
+)");
+	REQUIRE(script->reload() == OK);
+	Ref<RefCounted> object;
+	object.instantiate();
+	object->set_script(script);
+
+	GDScriptSampler local_sampler; // Only used if the language didn't create one.
+	GDScriptSampler *sampler = GDScriptSampler::get_singleton();
+	REQUIRE(sampler != nullptr);
+	sampler->clear();
+	sampler->start(200);
+	CHECK(GDScriptSampler::is_running());
+
+	CHECK(int(object->call("busy", 50000)) > 0);
+
+	// Functions in the numeric tier would run without a call stack to sample.
+	GDScriptNumericTier::Program *program = GDScriptNumericTier::translate(script->get_member_functions()["sum_to"]);
+	REQUIRE(program != nullptr);
+	const Variant arg = 4;
+	const Variant *args[1] = { &arg };
+	Variant ret;
+	CHECK_FALSE(GDScriptNumericTier::call(program, args, 1, ret));
+
+	sampler->stop();
+	CHECK(GDScriptNumericTier::call(program, args, 1, ret));
+	CHECK(int(ret) == 6);
+	memdelete(program);
+
+	CHECK(sampler->get_sample_count() > 0);
+	const String folded = sampler->to_folded();
+	CHECK_MESSAGE(folded.contains(":busy "), folded);
+
+	sampler->clear();
+	object->set_script(Variant());
+}
+
+} // namespace GDScriptTests
+
+#endif // TEST_GDSCRIPT_SAMPLER_H
@@ -91,6 +91,15 @@ void GodotAreaPair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint2D::SortKey GodotAreaPair2D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = area->get_self().get_id();
+	key.ids[1] = body->get_self().get_id();
+	key.indices[0] = area_shape;
+	key.indices[1] = body_shape;
+	return key;
+}
+
 GodotAreaPair2D::GodotAreaPair2D(GodotBody2D *p_body, int p_body_shape, GodotArea2D *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -174,6 +183,15 @@ void GodotArea2Pair2D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint2D::SortKey GodotArea2Pair2D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = area_a->get_self().get_id();
+	key.ids[1] = area_b->get_self().get_id();
+	key.indices[0] = shape_a;
+	key.indices[1] = shape_b;
+	return key;
+}
+
 GodotArea2Pair2D::GodotArea2Pair2D(GodotArea2D *p_area_a, int p_shape_a, GodotArea2D *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
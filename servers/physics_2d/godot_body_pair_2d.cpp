@@ -591,6 +591,15 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+GodotConstraint2D::SortKey GodotBodyPair2D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = A->get_self().get_id();
+	key.ids[1] = B->get_self().get_id();
+	key.indices[0] = shape_A;
+	key.indices[1] = shape_B;
+	return key;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
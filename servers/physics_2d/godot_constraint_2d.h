@@ -34,6 +34,28 @@
 #include "godot_body_2d.h"
 
 class GodotConstraint2D {
+public:
+	// Identifies a constraint by the objects it acts on, so constraints can be sorted
+	// regardless of their addresses and of the order they were created in.
+	struct SortKey {
+		uint64_t ids[2] = {};
+		int indices[2] = {};
+
+		bool operator<(const SortKey &p_key) const {
+			if (ids[0] != p_key.ids[0]) {
+				return ids[0] < p_key.ids[0];
+			}
+			if (ids[1] != p_key.ids[1]) {
+				return ids[1] < p_key.ids[1];
+			}
+			if (indices[0] != p_key.indices[0]) {
+				return indices[0] < p_key.indices[0];
+			}
+			return indices[1] < p_key.indices[1];
+		}
+	};
+
+private:
 	GodotBody2D **_body_ptr;
 	int _body_count;
 	uint64_t island_step = 0;
@@ -64,6 +86,13 @@ public:
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// Joints are identified by their RID, pairs override this with their objects and shapes.
+	virtual SortKey get_sort_key() const {
+		SortKey key;
+		key.ids[0] = self.get_id();
+		return key;
+	}
+
 	virtual ~GodotConstraint2D() {}
 };
 
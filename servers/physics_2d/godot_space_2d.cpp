@@ -33,8 +33,10 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
+#include "core/templates/parallel.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -114,16 +116,14 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState2D::_intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, GodotCollisionObject2D **r_cull_results, int *r_cull_subindices) {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_segment(begin, end, r_cull_results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_cull_subindices);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -134,17 +134,17 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = r_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_cull_subindices[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -204,6 +204,39 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, space->intersection_query_results, space->intersection_query_subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState2D::intersect_rays_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	// The broadphase culls are serialized by its own lock, the narrow phase runs in parallel.
+	SafeNumeric<int> hit_count;
+	auto chunk_function = [&](int64_t p_chunk, int64_t p_begin, int64_t p_end) {
+		FrameLocalVector<GodotCollisionObject2D *> cull_results;
+		FrameLocalVector<int> cull_subindices;
+		cull_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+		cull_subindices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+		int chunk_hit_count = 0;
+		for (int64_t i = p_begin; i < p_end; i++) {
+			r_hits[i] = _intersect_ray(p_parameters, p_from[i], p_to[i], r_results[i], cull_results.ptr(), cull_subindices.ptr());
+			if (r_hits[i]) {
+				chunk_hit_count++;
+			}
+		}
+		hit_count.add(chunk_hit_count);
+	};
+
+	const int64_t grain_size = MAX<int64_t>(ParallelChunksBase::get_grain_size(p_count, 0), GodotSpace2D::INTERSECTION_QUERY_BATCH_MIN_GRAIN);
+	ParallelChunks<decltype(chunk_function)>(0, p_count, grain_size, chunk_function).run();
+
+	return hit_count.get();
+}
+
 int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -253,43 +286,40 @@ int GodotPhysicsDirectSpaceState2D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
-	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
-
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
+void GodotPhysicsDirectSpaceState2D::_cast_motion(const ShapeParameters &p_parameters, GodotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, GodotCollisionObject2D **r_cull_results, int *r_cull_subindices) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_cull_results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_cull_subindices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = r_cull_results[i];
+		int shape_idx = r_cull_subindices[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (GodotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (GodotCollisionSolver2D::solve(p_shape, p_transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
-		Vector2 mnormal = p_parameters.motion.normalized();
+		Vector2 mnormal = p_motion.normalized();
 
 		//just do kinematic solving
 		real_t low = 0.0;
@@ -299,7 +329,7 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -332,6 +362,33 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	_cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, p_closest_safe, p_closest_unsafe, space->intersection_query_results, space->intersection_query_subindex_results);
+	return true;
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motions_batch(const ShapeParameters &p_parameters, const Transform2D *p_transforms, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	auto chunk_function = [&](int64_t p_chunk, int64_t p_begin, int64_t p_end) {
+		FrameLocalVector<GodotCollisionObject2D *> cull_results;
+		FrameLocalVector<int> cull_subindices;
+		cull_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+		cull_subindices.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+
+		for (int64_t i = p_begin; i < p_end; i++) {
+			_cast_motion(p_parameters, shape, p_transforms[i], p_motions[i], r_closest_safe[i], r_closest_unsafe[i], cull_results.ptr(), cull_subindices.ptr());
+		}
+	};
+
+	const int64_t grain_size = MAX<int64_t>(ParallelChunksBase::get_grain_size(p_count, 0), GodotSpace2D::INTERSECTION_QUERY_BATCH_MIN_GRAIN);
+	ParallelChunks<decltype(chunk_function)>(0, p_count, grain_size, chunk_function).run();
 
 	return true;
 }
@@ -1012,13 +1069,21 @@ bool GodotSpace2D::test_body_motion(GodotBody2D *p_body, const PhysicsServer2D::
 void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A, GodotCollisionObject2D *B, int p_subindex_B, void *p_self) {
 	GodotCollisionObject2D::Type type_A = A->get_type();
 	GodotCollisionObject2D::Type type_B = B->get_type();
-	if (type_A > type_B) {
+
+	GodotSpace2D *self = static_cast<GodotSpace2D *>(p_self);
+
+	// The broadphase reports pairs in an order that depends on its tree, make it only depend on the objects.
+	bool swap = type_A > type_B;
+	if (self->deterministic && type_A == type_B) {
+		uint64_t id_A = A->get_self().get_id();
+		uint64_t id_B = B->get_self().get_id();
+		swap = id_A > id_B || (id_A == id_B && p_subindex_A > p_subindex_B);
+	}
+	if (swap) {
 		SWAP(A, B);
 		SWAP(p_subindex_A, p_subindex_B);
 		SWAP(type_A, type_B);
 	}
-
-	GodotSpace2D *self = static_cast<GodotSpace2D *>(p_self);
 	self->collision_pairs++;
 
 	if (type_A == GodotCollisionObject2D::TYPE_AREA) {
@@ -1220,6 +1285,7 @@ GodotSpace2D::GodotSpace2D() {
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/2d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/2d/time_before_sleep");
 	solver_iterations = GLOBAL_GET("physics/2d/solver/solver_iterations");
+	deterministic = GLOBAL_GET("physics/2d/solver/deterministic");
 	contact_recycle_radius = GLOBAL_GET("physics/2d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/2d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/2d/solver/contact_max_allowed_penetration");
@@ -77,6 +77,23 @@ void GodotStep2D::_setup_constraint(uint32_t p_constraint_index, void *p_userdat
 	constraint->setup(delta);
 }
 
+void GodotStep2D::_sort_island(LocalVector<GodotConstraint2D *> &p_constraint_island) {
+	// Islands are built by walking the bodies' constraint maps, which are in the order the
+	// broadphase reported the pairs. Sorting by the objects involved makes the solving order
+	// only depend on the state of the simulation.
+	uint32_t constraint_count = p_constraint_island.size();
+	sorted_constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint2D *constraint = p_constraint_island[constraint_index];
+		sorted_constraints[constraint_index].key = constraint->get_sort_key();
+		sorted_constraints[constraint_index].constraint = constraint;
+	}
+	sorted_constraints.sort();
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		p_constraint_island[constraint_index] = sorted_constraints[constraint_index].constraint;
+	}
+}
+
 void GodotStep2D::_pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const {
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
@@ -133,6 +150,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 	p_space->set_last_step(p_delta);
 
 	iterations = p_space->get_solver_iterations();
+	deterministic = p_space->is_deterministic();
 	delta = p_delta;
 
 	const SelfList<GodotBody2D>::List *body_list = &p_space->get_active_body_list();
@@ -253,6 +271,9 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		if (deterministic) {
+			_sort_island(constraint_islands[island_index]);
+		}
 		_pre_solve_island(constraint_islands[island_index]);
 	}
 
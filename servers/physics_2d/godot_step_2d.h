@@ -40,6 +40,16 @@ class GodotStep2D {
 
 	int iterations = 0;
 	real_t delta = 0.0;
+	bool deterministic = false;
+
+	struct SortedConstraint {
+		GodotConstraint2D::SortKey key;
+		GodotConstraint2D *constraint = nullptr;
+
+		bool operator<(const SortedConstraint &p_other) const { return key < p_other.key; }
+	};
+
+	LocalVector<SortedConstraint> sorted_constraints; // Scratch space for _sort_island.
 
 	LocalVector<LocalVector<GodotBody2D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
@@ -47,6 +57,7 @@ class GodotStep2D {
 
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _sort_island(LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
 	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
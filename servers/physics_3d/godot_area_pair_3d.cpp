@@ -92,6 +92,15 @@ void GodotAreaPair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint3D::SortKey GodotAreaPair3D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = area->get_self().get_id();
+	key.ids[1] = body->get_self().get_id();
+	key.indices[0] = area_shape;
+	key.indices[1] = body_shape;
+	return key;
+}
+
 GodotAreaPair3D::GodotAreaPair3D(GodotBody3D *p_body, int p_body_shape, GodotArea3D *p_area, int p_area_shape) {
 	body = p_body;
 	area = p_area;
@@ -175,6 +184,15 @@ void GodotArea2Pair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint3D::SortKey GodotArea2Pair3D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = area_a->get_self().get_id();
+	key.ids[1] = area_b->get_self().get_id();
+	key.indices[0] = shape_a;
+	key.indices[1] = shape_b;
+	return key;
+}
+
 GodotArea2Pair3D::GodotArea2Pair3D(GodotArea3D *p_area_a, int p_shape_a, GodotArea3D *p_area_b, int p_shape_b) {
 	area_a = p_area_a;
 	area_b = p_area_b;
@@ -270,6 +288,15 @@ void GodotAreaSoftBodyPair3D::solve(real_t p_step) {
 	// Nothing to do.
 }
 
+GodotConstraint3D::SortKey GodotAreaSoftBodyPair3D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = area->get_self().get_id();
+	key.ids[1] = soft_body->get_self().get_id();
+	key.indices[0] = area_shape;
+	key.indices[1] = soft_body_shape;
+	return key;
+}
+
 GodotAreaSoftBodyPair3D::GodotAreaSoftBodyPair3D(GodotSoftBody3D *p_soft_body, int p_soft_body_shape, GodotArea3D *p_area, int p_area_shape) {
 	soft_body = p_soft_body;
 	area = p_area;
@@ -170,6 +170,42 @@ void GodotBody3D::reset_mass_properties() {
 	_mass_properties_changed();
 }
 
+void GodotBody3D::save_state(State &r_state) const {
+	r_state.transform = get_transform();
+	r_state.inv_transform = get_inv_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.applied_force = applied_force;
+	r_state.applied_torque = applied_torque;
+	r_state.still_time = still_time;
+	r_state.active = active;
+	r_state.first_time_kinematic = first_time_kinematic;
+}
+
+void GodotBody3D::load_state(const State &p_state) {
+	_set_transform(p_state.transform);
+	_set_inv_transform(p_state.inv_transform);
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	applied_force = p_state.applied_force;
+	applied_torque = p_state.applied_torque;
+	still_time = p_state.still_time;
+	first_time_kinematic = p_state.first_time_kinematic;
+
+	_update_transform_dependent();
+
+	// Let the nodes pick up the restored transforms on the next flush.
+	if (get_space() && (fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+}
+
 void GodotBody3D::set_active(bool p_active) {
 	if (active == p_active) {
 		return;
@@ -675,7 +711,7 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 		return;
 	}
 
-	if (fi_callback_data || body_state_callback.is_valid()) {
+	if ((fi_callback_data || body_state_callback.is_valid()) && !direct_state_query_list.in_list()) {
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 	}
 
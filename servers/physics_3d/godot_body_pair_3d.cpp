@@ -38,6 +38,15 @@
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
 
+// Squared area of the quad with these corners, or rather of its largest diagonal
+// cross product, since the contacts can come in any order.
+static real_t _get_contact_area_squared(const Vector3 &p_a, const Vector3 &p_b, const Vector3 &p_c, const Vector3 &p_d) {
+	real_t area_1 = (p_a - p_b).cross(p_c - p_d).length_squared();
+	real_t area_2 = (p_a - p_c).cross(p_b - p_d).length_squared();
+	real_t area_3 = (p_a - p_d).cross(p_b - p_c).length_squared();
+	return MAX(area_1, MAX(area_2, area_3));
+}
+
 void GodotBodyPair3D::_contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata) {
 	GodotBodyPair3D *pair = static_cast<GodotBodyPair3D *>(p_userdata);
 	pair->contact_added_callback(p_point_A, p_index_A, p_point_B, p_index_B, normal);
@@ -59,58 +68,56 @@ void GodotBodyPair3D::contact_added_callback(const Vector3 &p_point_A, int p_ind
 	contact.normal = (p_point_A - p_point_B).normalized();
 	contact.used = true;
 
-	// Attempt to determine if the contact will be reused.
+	// Attempt to determine if the contact will be reused. The closest previous contact is kept,
+	// so the accumulated impulses go to the right place.
 	real_t contact_recycle_radius = space->get_contact_recycle_radius();
+	real_t recycle_distance = contact_recycle_radius * contact_recycle_radius;
+	int recycled = -1;
 
 	for (int i = 0; i < contact_count; i++) {
-		Contact &c = contacts[i];
-		if (c.local_A.distance_squared_to(local_A) < (contact_recycle_radius * contact_recycle_radius) &&
-				c.local_B.distance_squared_to(local_B) < (contact_recycle_radius * contact_recycle_radius)) {
-			contact.acc_normal_impulse = c.acc_normal_impulse;
-			contact.acc_bias_impulse = c.acc_bias_impulse;
-			contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
-			contact.acc_tangent_impulse = c.acc_tangent_impulse;
-			c = contact;
-			return;
+		const Contact &c = contacts[i];
+		real_t distance_A = c.local_A.distance_squared_to(local_A);
+		real_t distance_B = c.local_B.distance_squared_to(local_B);
+		if (distance_A < recycle_distance && distance_B < recycle_distance) {
+			recycle_distance = MAX(distance_A, distance_B);
+			recycled = i;
 		}
 	}
 
+	if (recycled > -1) {
+		Contact &c = contacts[recycled];
+		contact.acc_normal_impulse = c.acc_normal_impulse;
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		// Keep the friction impulse in the tangent plane if the normal has changed.
+		contact.acc_tangent_impulse = c.acc_tangent_impulse - contact.normal * contact.normal.dot(c.acc_tangent_impulse);
+		c = contact;
+		return;
+	}
+
 	// Figure out if the contact amount must be reduced to fit the new contact.
 	if (new_index == MAX_CONTACTS) {
-		// Remove the contact with the minimum depth.
-
 		const Basis &basis_A = A->get_transform().basis;
 		const Basis &basis_B = B->get_transform().basis;
 
-		int least_deep = -1;
-		real_t min_depth;
-
-		// Start with depth for new contact.
-		{
-			Vector3 global_A = basis_A.xform(contact.local_A);
-			Vector3 global_B = basis_B.xform(contact.local_B) + offset_B;
+		// The new contact goes last.
+		Vector3 points[MAX_CONTACTS + 1];
+		real_t depths[MAX_CONTACTS + 1];
 
-			Vector3 axis = global_A - global_B;
-			min_depth = axis.dot(contact.normal);
-		}
-
-		for (int i = 0; i < contact_count; i++) {
-			const Contact &c = contacts[i];
+		for (int i = 0; i <= MAX_CONTACTS; i++) {
+			const Contact &c = i < MAX_CONTACTS ? contacts[i] : contact;
 			Vector3 global_A = basis_A.xform(c.local_A);
 			Vector3 global_B = basis_B.xform(c.local_B) + offset_B;
 
 			Vector3 axis = global_A - global_B;
-			real_t depth = axis.dot(c.normal);
-
-			if (depth < min_depth) {
-				min_depth = depth;
-				least_deep = i;
-			}
+			depths[i] = axis.dot(c.normal);
+			points[i] = global_A;
 		}
 
-		if (least_deep > -1) {
-			// Replace the least deep contact by the new one.
-			contacts[least_deep] = contact;
+		int removed = get_contact_to_remove(points, depths);
+		if (removed < MAX_CONTACTS) {
+			// Replace the removed contact by the new one.
+			contacts[removed] = contact;
 		}
 
 		return;
@@ -120,6 +127,40 @@ void GodotBodyPair3D::contact_added_callback(const Vector3 &p_point_A, int p_ind
 	contact_count++;
 }
 
+int GodotBodyPair3D::get_contact_to_remove(const Vector3 (&p_points)[MAX_CONTACTS + 1], const real_t (&p_depths)[MAX_CONTACTS + 1]) {
+	int deepest = 0;
+	for (int i = 1; i <= MAX_CONTACTS; i++) {
+		if (p_depths[i] > p_depths[deepest]) {
+			deepest = i;
+		}
+	}
+
+	int removed = -1;
+	real_t max_area = -1.0;
+
+	for (int i = 0; i <= MAX_CONTACTS; i++) {
+		if (i == deepest) {
+			continue;
+		}
+
+		Vector3 kept[MAX_CONTACTS];
+		int kept_count = 0;
+		for (int j = 0; j <= MAX_CONTACTS; j++) {
+			if (j != i) {
+				kept[kept_count++] = p_points[j];
+			}
+		}
+
+		real_t area = _get_contact_area_squared(kept[0], kept[1], kept[2], kept[3]);
+		if (area > max_area) {
+			max_area = area;
+			removed = i;
+		}
+	}
+
+	return removed;
+}
+
 void GodotBodyPair3D::validate_contacts() {
 	// Make sure to erase contacts that are no longer valid.
 	real_t max_separation = space->get_contact_max_separation();
@@ -595,6 +636,31 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+GodotConstraint3D::SortKey GodotBodyPair3D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = A->get_self().get_id();
+	key.ids[1] = B->get_self().get_id();
+	key.indices[0] = shape_A;
+	key.indices[1] = shape_B;
+	return key;
+}
+
+void GodotBodyPair3D::save_state(State &r_state) const {
+	for (int i = 0; i < contact_count; i++) {
+		r_state.contacts[i] = contacts[i];
+	}
+	r_state.contact_count = contact_count;
+	r_state.sep_axis = sep_axis;
+}
+
+void GodotBodyPair3D::load_state(const State &p_state) {
+	for (int i = 0; i < p_state.contact_count; i++) {
+		contacts[i] = p_state.contacts[i];
+	}
+	contact_count = p_state.contact_count;
+	sep_axis = p_state.sep_axis;
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
 		GodotBodyContact3D(_arr, 2) {
 	A = p_A;
@@ -972,6 +1038,14 @@ void GodotBodySoftBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+GodotConstraint3D::SortKey GodotBodySoftBodyPair3D::get_sort_key() const {
+	SortKey key;
+	key.ids[0] = body->get_self().get_id();
+	key.ids[1] = soft_body->get_self().get_id();
+	key.indices[0] = body_shape;
+	return key;
+}
+
 GodotBodySoftBodyPair3D::GodotBodySoftBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotSoftBody3D *p_B) :
 		GodotBodyContact3D(&body, 1) {
 	body = p_A;
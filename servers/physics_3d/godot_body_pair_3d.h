@@ -38,6 +38,8 @@
 #include "core/templates/local_vector.h"
 
 class GodotBodyContact3D : public GodotConstraint3D {
+	friend class GodotContactSolver3D;
+
 protected:
 	struct Contact {
 		Vector3 position;
@@ -71,6 +73,8 @@ protected:
 };
 
 class GodotBodyPair3D : public GodotBodyContact3D {
+	friend class GodotContactSolver3D;
+
 	enum {
 		MAX_CONTACTS = 4
 	};
@@ -105,10 +109,32 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
+	// Of the current contacts and a new one (last), returns the one to drop so the others fit.
+	// The deepest contact is kept, and of the others the ones that span the largest area.
+	static int get_contact_to_remove(const Vector3 (&p_points)[MAX_CONTACTS + 1], const real_t (&p_depths)[MAX_CONTACTS + 1]);
+
+	// Contacts kept from one step to the next, for space snapshots.
+	struct State {
+		Contact contacts[MAX_CONTACTS];
+		int contact_count = 0;
+		Vector3 sep_axis;
+	};
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	virtual GodotBodyPair3D *get_body_pair() override { return this; }
+	virtual SortKey get_sort_key() const override;
+
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+
+	void save_state(State &r_state) const;
+	void load_state(const State &p_state);
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
@@ -139,9 +165,13 @@ public:
 
 	virtual GodotSoftBody3D *get_soft_body_ptr(int p_index) const override { return soft_body; }
 	virtual int get_soft_body_count() const override { return 1; }
+	virtual SortKey get_sort_key() const override;
 
 	GodotBodySoftBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotSoftBody3D *p_B);
 	~GodotBodySoftBodyPair3D();
 };
 
+real_t combine_bounce(GodotBody3D *A, GodotBody3D *B);
+real_t combine_friction(GodotBody3D *A, GodotBody3D *B);
+
 #endif // GODOT_BODY_PAIR_3D_H
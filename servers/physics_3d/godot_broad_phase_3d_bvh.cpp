@@ -125,4 +125,7 @@ GodotBroadPhase3D *GodotBroadPhase3DBVH::_create() {
 GodotBroadPhase3DBVH::GodotBroadPhase3DBVH() {
 	bvh.set_pair_callback(_pair_callback, this);
 	bvh.set_unpair_callback(_unpair_callback, this);
+	// Pair callbacks create and free the space's pair constraints, so they stay on
+	// the physics thread. Only finding the pairs is done in parallel.
+	bvh.params_set_parallel_pairing(true);
 }
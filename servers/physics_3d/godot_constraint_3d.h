@@ -32,9 +32,32 @@
 #define GODOT_CONSTRAINT_3D_H
 
 class GodotBody3D;
+class GodotBodyPair3D;
 class GodotSoftBody3D;
 
 class GodotConstraint3D {
+public:
+	// Identifies a constraint by the objects it acts on, so constraints can be sorted
+	// regardless of their addresses and of the order they were created in.
+	struct SortKey {
+		uint64_t ids[2] = {};
+		int indices[2] = {};
+
+		bool operator<(const SortKey &p_key) const {
+			if (ids[0] != p_key.ids[0]) {
+				return ids[0] < p_key.ids[0];
+			}
+			if (ids[1] != p_key.ids[1]) {
+				return ids[1] < p_key.ids[1];
+			}
+			if (indices[0] != p_key.indices[0]) {
+				return indices[0] < p_key.indices[0];
+			}
+			return indices[1] < p_key.indices[1];
+		}
+	};
+
+private:
 	GodotBody3D **_body_ptr;
 	int _body_count;
 	uint64_t island_step;
@@ -65,6 +88,16 @@ public:
 	virtual GodotSoftBody3D *get_soft_body_ptr(int p_index) const { return nullptr; }
 	virtual int get_soft_body_count() const { return 0; }
 
+	// Body pairs can have their contacts solved in batches by GodotContactSolver3D.
+	virtual GodotBodyPair3D *get_body_pair() { return nullptr; }
+
+	// Joints are identified by their RID, pairs override this with their objects and shapes.
+	virtual SortKey get_sort_key() const {
+		SortKey key;
+		key.ids[0] = self.get_id();
+		return key;
+	}
+
 	_FORCE_INLINE_ void set_priority(int p_priority) { priority = p_priority; }
 	_FORCE_INLINE_ int get_priority() const { return priority; }
 
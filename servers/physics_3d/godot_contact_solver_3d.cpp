@@ -0,0 +1,595 @@
+/**************************************************************************/
+/*  godot_contact_solver_3d.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_contact_solver_3d.h"
+
+#include "core/templates/parallel.h"
+
+#if !defined(REAL_T_IS_DOUBLE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CONTACT_SOLVER_SSE2
+#include <emmintrin.h>
+#elif !defined(REAL_T_IS_DOUBLE) && ((defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64))
+#define CONTACT_SOLVER_NEON
+#include <arm_neon.h>
+#endif
+
+// Same as in godot_body_pair_3d.cpp.
+#define MIN_VELOCITY 0.0001
+#define MAX_BIAS_ROTATION (Math_PI / 8)
+
+static_assert(GodotContactSolver3D::LANES == 4, "The SIMD lane types below are 4 wide.");
+
+// Four real_t values, and masks to select between them.
+
+#if defined(CONTACT_SOLVER_SSE2)
+
+struct LaneMask {
+	__m128 m;
+
+	_FORCE_INLINE_ LaneMask operator&(const LaneMask &p_other) const { return { _mm_and_ps(m, p_other.m) }; }
+	_FORCE_INLINE_ LaneMask operator|(const LaneMask &p_other) const { return { _mm_or_ps(m, p_other.m) }; }
+	_FORCE_INLINE_ bool any() const { return _mm_movemask_ps(m) != 0; }
+};
+
+struct Lanes {
+	__m128 v;
+
+	_FORCE_INLINE_ static Lanes load(const real_t *p_values) { return { _mm_loadu_ps(p_values) }; }
+	_FORCE_INLINE_ static Lanes splat(real_t p_value) { return { _mm_set1_ps(p_value) }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const { _mm_storeu_ps(r_values, v); }
+
+	_FORCE_INLINE_ Lanes operator+(const Lanes &p_other) const { return { _mm_add_ps(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator-(const Lanes &p_other) const { return { _mm_sub_ps(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator*(const Lanes &p_other) const { return { _mm_mul_ps(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator/(const Lanes &p_other) const { return { _mm_div_ps(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator-() const { return { _mm_sub_ps(_mm_setzero_ps(), v) }; }
+	_FORCE_INLINE_ LaneMask operator>(const Lanes &p_other) const { return { _mm_cmpgt_ps(v, p_other.v) }; }
+
+	_FORCE_INLINE_ Lanes abs() const { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), v) }; }
+	_FORCE_INLINE_ Lanes sqrt() const { return { _mm_sqrt_ps(v) }; }
+	_FORCE_INLINE_ Lanes max(const Lanes &p_other) const { return { _mm_max_ps(v, p_other.v) }; }
+	_FORCE_INLINE_ static Lanes select(const LaneMask &p_mask, const Lanes &p_true, const Lanes &p_false) {
+		return { _mm_or_ps(_mm_and_ps(p_mask.m, p_true.v), _mm_andnot_ps(p_mask.m, p_false.v)) };
+	}
+};
+
+#elif defined(CONTACT_SOLVER_NEON)
+
+struct LaneMask {
+	uint32x4_t m;
+
+	_FORCE_INLINE_ LaneMask operator&(const LaneMask &p_other) const { return { vandq_u32(m, p_other.m) }; }
+	_FORCE_INLINE_ LaneMask operator|(const LaneMask &p_other) const { return { vorrq_u32(m, p_other.m) }; }
+	_FORCE_INLINE_ bool any() const { return vmaxvq_u32(m) != 0; }
+};
+
+struct Lanes {
+	float32x4_t v;
+
+	_FORCE_INLINE_ static Lanes load(const real_t *p_values) { return { vld1q_f32(p_values) }; }
+	_FORCE_INLINE_ static Lanes splat(real_t p_value) { return { vdupq_n_f32(p_value) }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const { vst1q_f32(r_values, v); }
+
+	_FORCE_INLINE_ Lanes operator+(const Lanes &p_other) const { return { vaddq_f32(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator-(const Lanes &p_other) const { return { vsubq_f32(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator*(const Lanes &p_other) const { return { vmulq_f32(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator/(const Lanes &p_other) const { return { vdivq_f32(v, p_other.v) }; }
+	_FORCE_INLINE_ Lanes operator-() const { return { vnegq_f32(v) }; }
+	_FORCE_INLINE_ LaneMask operator>(const Lanes &p_other) const { return { vcgtq_f32(v, p_other.v) }; }
+
+	_FORCE_INLINE_ Lanes abs() const { return { vabsq_f32(v) }; }
+	_FORCE_INLINE_ Lanes sqrt() const { return { vsqrtq_f32(v) }; }
+	_FORCE_INLINE_ Lanes max(const Lanes &p_other) const { return { vmaxq_f32(v, p_other.v) }; }
+	_FORCE_INLINE_ static Lanes select(const LaneMask &p_mask, const Lanes &p_true, const Lanes &p_false) {
+		return { vbslq_f32(p_mask.m, p_true.v, p_false.v) };
+	}
+};
+
+#else
+
+// Plain loops, which compilers can still vectorize. Also used with double precision.
+
+struct LaneMask {
+	bool m[4];
+
+	_FORCE_INLINE_ LaneMask operator&(const LaneMask &p_other) const { return { { m[0] && p_other.m[0], m[1] && p_other.m[1], m[2] && p_other.m[2], m[3] && p_other.m[3] } }; }
+	_FORCE_INLINE_ LaneMask operator|(const LaneMask &p_other) const { return { { m[0] || p_other.m[0], m[1] || p_other.m[1], m[2] || p_other.m[2], m[3] || p_other.m[3] } }; }
+	_FORCE_INLINE_ bool any() const { return m[0] || m[1] || m[2] || m[3]; }
+};
+
+#define LANES_EACH(m_expr)        \
+	Lanes r;                      \
+	for (int i = 0; i < 4; i++) { \
+		r.v[i] = m_expr;          \
+	}                             \
+	return r;
+
+struct Lanes {
+	real_t v[4];
+
+	_FORCE_INLINE_ static Lanes load(const real_t *p_values) { return { { p_values[0], p_values[1], p_values[2], p_values[3] } }; }
+	_FORCE_INLINE_ static Lanes splat(real_t p_value) { return { { p_value, p_value, p_value, p_value } }; }
+	_FORCE_INLINE_ void store(real_t *r_values) const {
+		for (int i = 0; i < 4; i++) {
+			r_values[i] = v[i];
+		}
+	}
+
+	_FORCE_INLINE_ Lanes operator+(const Lanes &p_other) const { LANES_EACH(v[i] + p_other.v[i]) }
+	_FORCE_INLINE_ Lanes operator-(const Lanes &p_other) const { LANES_EACH(v[i] - p_other.v[i]) }
+	_FORCE_INLINE_ Lanes operator*(const Lanes &p_other) const { LANES_EACH(v[i] * p_other.v[i]) }
+	_FORCE_INLINE_ Lanes operator/(const Lanes &p_other) const { LANES_EACH(v[i] / p_other.v[i]) }
+	_FORCE_INLINE_ Lanes operator-() const { LANES_EACH(-v[i]) }
+	_FORCE_INLINE_ LaneMask operator>(const Lanes &p_other) const { return { { v[0] > p_other.v[0], v[1] > p_other.v[1], v[2] > p_other.v[2], v[3] > p_other.v[3] } }; }
+
+	_FORCE_INLINE_ Lanes abs() const { LANES_EACH(Math::abs(v[i])) }
+	_FORCE_INLINE_ Lanes sqrt() const { LANES_EACH(Math::sqrt(v[i])) }
+	_FORCE_INLINE_ Lanes max(const Lanes &p_other) const { LANES_EACH(MAX(v[i], p_other.v[i])) }
+	_FORCE_INLINE_ static Lanes select(const LaneMask &p_mask, const Lanes &p_true, const Lanes &p_false) {
+		Lanes r;
+		for (int i = 0; i < 4; i++) {
+			r.v[i] = p_mask.m[i] ? p_true.v[i] : p_false.v[i];
+		}
+		return r;
+	}
+};
+
+#undef LANES_EACH
+
+#endif
+
+struct LaneVector3 {
+	Lanes x, y, z;
+
+	_FORCE_INLINE_ static LaneVector3 load(const real_t p_values[3][GodotContactSolver3D::LANES]) {
+		return { Lanes::load(p_values[0]), Lanes::load(p_values[1]), Lanes::load(p_values[2]) };
+	}
+	_FORCE_INLINE_ void store(real_t r_values[3][GodotContactSolver3D::LANES]) const {
+		x.store(r_values[0]);
+		y.store(r_values[1]);
+		z.store(r_values[2]);
+	}
+
+	_FORCE_INLINE_ LaneVector3 operator+(const LaneVector3 &p_other) const { return { x + p_other.x, y + p_other.y, z + p_other.z }; }
+	_FORCE_INLINE_ LaneVector3 operator-(const LaneVector3 &p_other) const { return { x - p_other.x, y - p_other.y, z - p_other.z }; }
+	_FORCE_INLINE_ LaneVector3 operator*(const Lanes &p_scalar) const { return { x * p_scalar, y * p_scalar, z * p_scalar }; }
+
+	_FORCE_INLINE_ Lanes dot(const LaneVector3 &p_other) const { return x * p_other.x + y * p_other.y + z * p_other.z; }
+	_FORCE_INLINE_ Lanes length() const { return dot(*this).sqrt(); }
+	_FORCE_INLINE_ LaneVector3 cross(const LaneVector3 &p_other) const {
+		return { y * p_other.z - z * p_other.y, z * p_other.x - x * p_other.z, x * p_other.y - y * p_other.x };
+	}
+
+	_FORCE_INLINE_ static LaneVector3 select(const LaneMask &p_mask, const LaneVector3 &p_true, const LaneVector3 &p_false) {
+		return { Lanes::select(p_mask, p_true.x, p_false.x), Lanes::select(p_mask, p_true.y, p_false.y), Lanes::select(p_mask, p_true.z, p_false.z) };
+	}
+
+	// Scales down the lanes longer than p_max_length (which must be positive) to that length.
+	_FORCE_INLINE_ LaneVector3 limit_length(const Lanes &p_max_length) const {
+		const Lanes len = length();
+		return *this * Lanes::select(len > p_max_length, p_max_length / len, Lanes::splat(1.0));
+	}
+};
+
+struct LaneBasis {
+	Lanes rows[3][3];
+
+	_FORCE_INLINE_ LaneVector3 xform(const LaneVector3 &p_vector) const {
+		return {
+			rows[0][0] * p_vector.x + rows[0][1] * p_vector.y + rows[0][2] * p_vector.z,
+			rows[1][0] * p_vector.x + rows[1][1] * p_vector.y + rows[1][2] * p_vector.z,
+			rows[2][0] * p_vector.x + rows[2][1] * p_vector.y + rows[2][2] * p_vector.z,
+		};
+	}
+};
+
+/////////////////////////////////////////////////
+
+template <class T>
+_FORCE_INLINE_ static LaneVector3 _gather_vector(const T *p_bodies, const uint32_t *p_indices, Vector3 T::*p_member) {
+	real_t values[3][GodotContactSolver3D::LANES];
+	for (int i = 0; i < GodotContactSolver3D::LANES; i++) {
+		const Vector3 &v = p_bodies[p_indices[i]].*p_member;
+		values[0][i] = v.x;
+		values[1][i] = v.y;
+		values[2][i] = v.z;
+	}
+	return LaneVector3::load(values);
+}
+
+template <class T>
+_FORCE_INLINE_ static void _scatter_vector(T *p_bodies, const uint32_t *p_indices, const real_t *p_collide, const LaneVector3 &p_vector, Vector3 T::*p_member) {
+	real_t values[3][GodotContactSolver3D::LANES];
+	p_vector.store(values);
+	for (int i = 0; i < GodotContactSolver3D::LANES; i++) {
+		if (p_collide[i] != 0.0) {
+			p_bodies[p_indices[i]].*p_member = Vector3(values[0][i], values[1][i], values[2][i]);
+		}
+	}
+}
+
+template <class T>
+_FORCE_INLINE_ static LaneBasis _gather_inv_inertia(const T *p_bodies, const uint32_t *p_indices, const real_t *p_collide) {
+	LaneBasis basis;
+	for (int r = 0; r < 3; r++) {
+		for (int c = 0; c < 3; c++) {
+			real_t values[GodotContactSolver3D::LANES];
+			for (int i = 0; i < GodotContactSolver3D::LANES; i++) {
+				values[i] = p_bodies[p_indices[i]].inv_inertia_tensor.rows[r][c] * p_collide[i];
+			}
+			basis.rows[r][c] = Lanes::load(values);
+		}
+	}
+	return basis;
+}
+
+uint32_t GodotContactSolver3D::_get_body_index(GodotBody3D *p_body) {
+	const uint32_t *index = body_indices.getptr(p_body);
+	if (index) {
+		return *index;
+	}
+
+	SolverBody solver_body;
+	solver_body.body = p_body;
+	solver_body.dynamic = p_body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC;
+	solver_body.inv_mass = p_body->get_inv_mass();
+	solver_body.inv_inertia_tensor = p_body->get_inv_inertia_tensor();
+	solver_body.linear_velocity = p_body->get_linear_velocity();
+	solver_body.angular_velocity = p_body->get_angular_velocity();
+	solver_body.biased_linear_velocity = p_body->get_biased_linear_velocity();
+	solver_body.biased_angular_velocity = p_body->get_biased_angular_velocity();
+
+	const uint32_t new_index = bodies.size();
+	bodies.push_back(solver_body);
+	body_indices.insert(p_body, new_index);
+	return new_index;
+}
+
+void GodotContactSolver3D::_add_contact(ContactBatch &p_batch, int p_lane, const PendingContact &p_pending) {
+	GodotBodyPair3D *pair = p_pending.pair;
+	GodotBodyContact3D::Contact &c = pair->contacts[p_pending.index];
+	const SolverBody &body_A = bodies[p_pending.body_A];
+	const SolverBody &body_B = bodies[p_pending.body_B];
+
+	Basis zero_basis;
+	zero_basis.set_zero();
+
+	const Basis &inv_inertia_tensor_A = pair->collide_A ? body_A.inv_inertia_tensor : zero_basis;
+	const Basis &inv_inertia_tensor_B = pair->collide_B ? body_B.inv_inertia_tensor : zero_basis;
+	const Vector3 angular_A = inv_inertia_tensor_A.xform(c.rA.cross(c.normal));
+	const Vector3 angular_B = inv_inertia_tensor_B.xform(c.rB.cross(c.normal));
+
+	for (int i = 0; i < 3; i++) {
+		p_batch.normal[i][p_lane] = c.normal[i];
+		p_batch.r_A[i][p_lane] = c.rA[i];
+		p_batch.r_B[i][p_lane] = c.rB[i];
+		p_batch.angular_A[i][p_lane] = angular_A[i];
+		p_batch.angular_B[i][p_lane] = angular_B[i];
+		p_batch.acc_tangent_impulse[i][p_lane] = c.acc_tangent_impulse[i];
+		p_batch.acc_impulse[i][p_lane] = c.acc_impulse[i];
+	}
+	p_batch.inv_mass_A[p_lane] = pair->collide_A ? body_A.inv_mass : 0.0;
+	p_batch.inv_mass_B[p_lane] = pair->collide_B ? body_B.inv_mass : 0.0;
+	p_batch.mass_normal[p_lane] = c.mass_normal;
+	p_batch.bias[p_lane] = c.bias;
+	p_batch.bounce[p_lane] = c.bounce;
+	p_batch.friction[p_lane] = combine_friction(pair->A, pair->B);
+	p_batch.acc_normal_impulse[p_lane] = c.acc_normal_impulse;
+	p_batch.acc_bias_impulse[p_lane] = c.acc_bias_impulse;
+	p_batch.acc_bias_impulse_center_of_mass[p_lane] = c.acc_bias_impulse_center_of_mass;
+	p_batch.active[p_lane] = 1.0;
+	p_batch.collide_A[p_lane] = pair->collide_A ? 1.0 : 0.0;
+	p_batch.collide_B[p_lane] = pair->collide_B ? 1.0 : 0.0;
+	p_batch.body_A[p_lane] = p_pending.body_A;
+	p_batch.body_B[p_lane] = p_pending.body_B;
+	p_batch.contacts[p_lane] = &c;
+}
+
+// Same steps as GodotBodyPair3D::solve(), for all the lanes at once: lanes that
+// would skip a step are masked out instead.
+void GodotContactSolver3D::_solve_batch(ContactBatch &p_batch) {
+	const LaneMask active = Lanes::load(p_batch.active) > Lanes::splat(0.5);
+	if (!active.any()) {
+		return;
+	}
+
+	const Lanes zero = Lanes::splat(0.0);
+	const Lanes one = Lanes::splat(1.0);
+	const Lanes min_velocity = Lanes::splat(MIN_VELOCITY);
+
+	const LaneVector3 normal = LaneVector3::load(p_batch.normal);
+	const LaneVector3 r_A = LaneVector3::load(p_batch.r_A);
+	const LaneVector3 r_B = LaneVector3::load(p_batch.r_B);
+	const LaneVector3 angular_A = LaneVector3::load(p_batch.angular_A);
+	const LaneVector3 angular_B = LaneVector3::load(p_batch.angular_B);
+	const Lanes inv_mass_A = Lanes::load(p_batch.inv_mass_A);
+	const Lanes inv_mass_B = Lanes::load(p_batch.inv_mass_B);
+	const Lanes mass_normal = Lanes::load(p_batch.mass_normal);
+	const Lanes bias = Lanes::load(p_batch.bias);
+
+	const SolverBody *b = bodies.ptr();
+	LaneVector3 lv_A = _gather_vector(b, p_batch.body_A, &SolverBody::linear_velocity);
+	LaneVector3 av_A = _gather_vector(b, p_batch.body_A, &SolverBody::angular_velocity);
+	LaneVector3 blv_A = _gather_vector(b, p_batch.body_A, &SolverBody::biased_linear_velocity);
+	LaneVector3 bav_A = _gather_vector(b, p_batch.body_A, &SolverBody::biased_angular_velocity);
+	LaneVector3 lv_B = _gather_vector(b, p_batch.body_B, &SolverBody::linear_velocity);
+	LaneVector3 av_B = _gather_vector(b, p_batch.body_B, &SolverBody::angular_velocity);
+	LaneVector3 blv_B = _gather_vector(b, p_batch.body_B, &SolverBody::biased_linear_velocity);
+	LaneVector3 bav_B = _gather_vector(b, p_batch.body_B, &SolverBody::biased_angular_velocity);
+
+	// Bias impulse.
+
+	LaneVector3 dbv = (blv_B + bav_B.cross(r_B)) - (blv_A + bav_A.cross(r_A));
+	Lanes vbn = dbv.dot(normal);
+
+	const LaneMask bias_mask = active & ((bias - vbn).abs() > min_velocity);
+	if (bias_mask.any()) {
+		const Lanes max_bias_av = Lanes::splat(max_bias_angular_velocity);
+
+		const Lanes acc_bias_old = Lanes::load(p_batch.acc_bias_impulse);
+		const Lanes acc_bias = Lanes::select(bias_mask, (acc_bias_old + (bias - vbn) * mass_normal).max(zero), acc_bias_old);
+		acc_bias.store(p_batch.acc_bias_impulse);
+
+		const Lanes jb = acc_bias - acc_bias_old;
+		blv_A = blv_A - normal * (jb * inv_mass_A);
+		bav_A = bav_A - (angular_A * jb).limit_length(max_bias_av);
+		blv_B = blv_B + normal * (jb * inv_mass_B);
+		bav_B = bav_B + (angular_B * jb).limit_length(max_bias_av);
+
+		dbv = (blv_B + bav_B.cross(r_B)) - (blv_A + bav_A.cross(r_A));
+		vbn = dbv.dot(normal);
+
+		const LaneMask bias_com_mask = bias_mask & ((bias - vbn).abs() > min_velocity);
+		const Lanes acc_bias_com_old = Lanes::load(p_batch.acc_bias_impulse_center_of_mass);
+		const Lanes acc_bias_com = Lanes::select(bias_com_mask, (acc_bias_com_old + (bias - vbn) / (inv_mass_A + inv_mass_B)).max(zero), acc_bias_com_old);
+		acc_bias_com.store(p_batch.acc_bias_impulse_center_of_mass);
+
+		const Lanes jb_com = acc_bias_com - acc_bias_com_old;
+		blv_A = blv_A - normal * (jb_com * inv_mass_A);
+		blv_B = blv_B + normal * (jb_com * inv_mass_B);
+	}
+
+	// Normal impulse.
+
+	LaneVector3 acc_impulse = LaneVector3::load(p_batch.acc_impulse);
+
+	const LaneVector3 dv = (lv_B + av_B.cross(r_B)) - (lv_A + av_A.cross(r_A));
+	const Lanes vn = dv.dot(normal);
+
+	const LaneMask normal_mask = active & (vn.abs() > min_velocity);
+	const Lanes acc_normal_old = Lanes::load(p_batch.acc_normal_impulse);
+	const Lanes acc_normal = Lanes::select(normal_mask, (acc_normal_old - (Lanes::load(p_batch.bounce) + vn) * mass_normal).max(zero), acc_normal_old);
+	acc_normal.store(p_batch.acc_normal_impulse);
+
+	const Lanes jn = acc_normal - acc_normal_old;
+	lv_A = lv_A - normal * (jn * inv_mass_A);
+	av_A = av_A - angular_A * jn;
+	lv_B = lv_B + normal * (jn * inv_mass_B);
+	av_B = av_B + angular_B * jn;
+	acc_impulse = acc_impulse - normal * jn;
+
+	// Friction impulse.
+
+	const LaneVector3 dtv = (lv_B + av_B.cross(r_B)) - (lv_A + av_A.cross(r_A));
+	const Lanes tn = normal.dot(dtv);
+	LaneVector3 tv = dtv - normal * tn;
+	const Lanes tvl = tv.length();
+
+	const LaneMask friction_mask = active & (tvl > min_velocity);
+	if (friction_mask.any()) {
+		const LaneBasis inv_inertia_A = _gather_inv_inertia(b, p_batch.body_A, p_batch.collide_A);
+		const LaneBasis inv_inertia_B = _gather_inv_inertia(b, p_batch.body_B, p_batch.collide_B);
+
+		tv = tv * (one / Lanes::select(friction_mask, tvl, one));
+
+		const LaneVector3 temp_A = inv_inertia_A.xform(r_A.cross(tv));
+		const LaneVector3 temp_B = inv_inertia_B.xform(r_B.cross(tv));
+		const Lanes t = -tvl / (inv_mass_A + inv_mass_B + tv.dot(temp_A.cross(r_A) + temp_B.cross(r_B)));
+
+		const LaneVector3 acc_tangent_old = LaneVector3::load(p_batch.acc_tangent_impulse);
+		LaneVector3 acc_tangent = acc_tangent_old + tv * t;
+
+		const Lanes fi_len = acc_tangent.length();
+		const Lanes jt_max = acc_normal * Lanes::load(p_batch.friction);
+		acc_tangent = acc_tangent * Lanes::select((fi_len > Lanes::splat(CMP_EPSILON)) & (fi_len > jt_max), jt_max / fi_len, one);
+		acc_tangent = LaneVector3::select(friction_mask, acc_tangent, acc_tangent_old);
+		acc_tangent.store(p_batch.acc_tangent_impulse);
+
+		const LaneVector3 jt = acc_tangent - acc_tangent_old;
+		lv_A = lv_A - jt * inv_mass_A;
+		av_A = av_A - inv_inertia_A.xform(r_A.cross(jt));
+		lv_B = lv_B + jt * inv_mass_B;
+		av_B = av_B + inv_inertia_B.xform(r_B.cross(jt));
+		acc_impulse = acc_impulse - jt;
+	}
+
+	acc_impulse.store(p_batch.acc_impulse);
+	Lanes::select(bias_mask | normal_mask | friction_mask, one, zero).store(p_batch.active);
+
+	SolverBody *w = bodies.ptr();
+	_scatter_vector(w, p_batch.body_A, p_batch.collide_A, lv_A, &SolverBody::linear_velocity);
+	_scatter_vector(w, p_batch.body_A, p_batch.collide_A, av_A, &SolverBody::angular_velocity);
+	_scatter_vector(w, p_batch.body_A, p_batch.collide_A, blv_A, &SolverBody::biased_linear_velocity);
+	_scatter_vector(w, p_batch.body_A, p_batch.collide_A, bav_A, &SolverBody::biased_angular_velocity);
+	_scatter_vector(w, p_batch.body_B, p_batch.collide_B, lv_B, &SolverBody::linear_velocity);
+	_scatter_vector(w, p_batch.body_B, p_batch.collide_B, av_B, &SolverBody::angular_velocity);
+	_scatter_vector(w, p_batch.body_B, p_batch.collide_B, blv_B, &SolverBody::biased_linear_velocity);
+	_scatter_vector(w, p_batch.body_B, p_batch.collide_B, bav_B, &SolverBody::biased_angular_velocity);
+}
+
+bool GodotContactSolver3D::setup(LocalVector<GodotConstraint3D *> &p_constraints, real_t p_step) {
+	uint32_t contact_count = 0;
+	for (GodotConstraint3D *constraint : p_constraints) {
+		GodotBodyPair3D *pair = constraint->get_body_pair();
+		if (pair && pair->collided && pair->get_priority() <= 1) {
+			for (int i = 0; i < pair->contact_count; i++) {
+				if (pair->contacts[i].active) {
+					contact_count++;
+				}
+			}
+		}
+	}
+
+	if (contact_count < MIN_CONTACTS) {
+		return false;
+	}
+
+	max_bias_angular_velocity = MAX_BIAS_ROTATION / p_step;
+
+	bodies.clear();
+	body_indices.clear();
+	batches.clear();
+	color_offsets.clear();
+
+	// Unused lanes point to this body, which has no mass and is never written.
+	SolverBody padding_body;
+	padding_body.inv_inertia_tensor.set_zero();
+	bodies.push_back(padding_body);
+
+	LocalVector<PendingContact> pending[2];
+	pending[0].reserve(contact_count);
+	pending[1].reserve(contact_count);
+
+	uint32_t kept_count = 0;
+	for (GodotConstraint3D *constraint : p_constraints) {
+		GodotBodyPair3D *pair = constraint->get_body_pair();
+		if (!pair || !pair->collided || pair->get_priority() > 1) {
+			p_constraints[kept_count++] = constraint;
+			continue;
+		}
+
+		const uint32_t body_A = _get_body_index(pair->A);
+		const uint32_t body_B = _get_body_index(pair->B);
+		for (int i = 0; i < pair->contact_count; i++) {
+			if (pair->contacts[i].active) {
+				PendingContact contact;
+				contact.pair = pair;
+				contact.index = i;
+				contact.body_A = body_A;
+				contact.body_B = body_B;
+				pending[0].push_back(contact);
+			}
+		}
+	}
+	p_constraints.resize(kept_count);
+
+	// Greedy coloring: each pass takes the contacts whose dynamic bodies aren't used yet by
+	// the color, and leaves the others for the next colors. Static and kinematic bodies are
+	// only read, so they can be shared.
+	uint32_t color_stamp = 0;
+	uint32_t current = 0;
+	while (!pending[current].is_empty()) {
+		color_stamp++;
+		color_offsets.push_back(batches.size());
+
+		LocalVector<PendingContact> &next = pending[current ^ 1];
+		next.clear();
+
+		int lane = LANES;
+		for (const PendingContact &contact : pending[current]) {
+			SolverBody &body_A = bodies[contact.body_A];
+			SolverBody &body_B = bodies[contact.body_B];
+			if ((body_A.dynamic && body_A.color_stamp == color_stamp) || (body_B.dynamic && body_B.color_stamp == color_stamp)) {
+				next.push_back(contact);
+				continue;
+			}
+			body_A.color_stamp = color_stamp;
+			body_B.color_stamp = color_stamp;
+
+			if (lane == LANES) {
+				batches.push_back(ContactBatch());
+				lane = 0;
+			}
+			_add_contact(batches[batches.size() - 1], lane++, contact);
+		}
+
+		current ^= 1;
+	}
+	color_offsets.push_back(batches.size());
+
+	return true;
+}
+
+void GodotContactSolver3D::solve(bool p_allow_threads) {
+	for (uint32_t color = 0; color + 1 < color_offsets.size(); color++) {
+		const uint32_t from = color_offsets[color];
+		const uint32_t to = color_offsets[color + 1];
+		if (p_allow_threads && to - from >= MIN_PARALLEL_BATCHES) {
+			parallel_for(from, to, [this](int64_t p_index) {
+				_solve_batch(batches[p_index]);
+			});
+		} else {
+			for (uint32_t i = from; i < to; i++) {
+				_solve_batch(batches[i]);
+			}
+		}
+	}
+}
+
+void GodotContactSolver3D::read_bodies() {
+	for (uint32_t i = 1; i < bodies.size(); i++) {
+		SolverBody &solver_body = bodies[i];
+		if (solver_body.dynamic) {
+			solver_body.linear_velocity = solver_body.body->get_linear_velocity();
+			solver_body.angular_velocity = solver_body.body->get_angular_velocity();
+			solver_body.biased_linear_velocity = solver_body.body->get_biased_linear_velocity();
+			solver_body.biased_angular_velocity = solver_body.body->get_biased_angular_velocity();
+		}
+	}
+}
+
+void GodotContactSolver3D::write_bodies() const {
+	for (uint32_t i = 1; i < bodies.size(); i++) {
+		const SolverBody &solver_body = bodies[i];
+		if (solver_body.dynamic) {
+			solver_body.body->set_linear_velocity(solver_body.linear_velocity);
+			solver_body.body->set_angular_velocity(solver_body.angular_velocity);
+			solver_body.body->set_biased_linear_velocity(solver_body.biased_linear_velocity);
+			solver_body.body->set_biased_angular_velocity(solver_body.biased_angular_velocity);
+		}
+	}
+}
+
+void GodotContactSolver3D::finish() {
+	for (const ContactBatch &batch : batches) {
+		for (int lane = 0; lane < LANES; lane++) {
+			GodotBodyContact3D::Contact *c = batch.contacts[lane];
+			if (!c) {
+				continue;
+			}
+			c->acc_normal_impulse = batch.acc_normal_impulse[lane];
+			c->acc_bias_impulse = batch.acc_bias_impulse[lane];
+			c->acc_bias_impulse_center_of_mass = batch.acc_bias_impulse_center_of_mass[lane];
+			c->acc_tangent_impulse = Vector3(batch.acc_tangent_impulse[0][lane], batch.acc_tangent_impulse[1][lane], batch.acc_tangent_impulse[2][lane]);
+			c->acc_impulse = Vector3(batch.acc_impulse[0][lane], batch.acc_impulse[1][lane], batch.acc_impulse[2][lane]);
+			c->active = batch.active[lane] != 0.0;
+		}
+	}
+}
@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  godot_contact_solver_3d.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_CONTACT_SOLVER_3D_H
+#define GODOT_CONTACT_SOLVER_3D_H
+
+#include "godot_body_pair_3d.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Solves the contacts of the body pairs of an island together, as an alternative to
+// calling GodotBodyPair3D::solve() on each pair.
+//
+// Contacts are packed in batches of LANES, in structure-of-arrays layout, and each batch
+// is solved with SIMD instructions when available. Batches are grouped in colors: no
+// dynamic body is touched by two contacts of the same color, so the contacts of a batch
+// can be solved at the same time, and so can the batches of a color on different threads.
+// This gives the same result as solving the contacts one at a time in color order.
+class GodotContactSolver3D {
+public:
+	enum {
+		LANES = 4,
+	};
+
+private:
+	struct SolverBody {
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 biased_linear_velocity;
+		Vector3 biased_angular_velocity;
+		Basis inv_inertia_tensor;
+		real_t inv_mass = 0.0;
+		GodotBody3D *body = nullptr; // Null for the padding body.
+		bool dynamic = false;
+		uint32_t color_stamp = 0;
+	};
+
+	struct ContactBatch {
+		// Per-lane data, unused lanes point to the padding body and are never active.
+		real_t normal[3][LANES];
+		real_t r_A[3][LANES];
+		real_t r_B[3][LANES];
+		real_t angular_A[3][LANES]; // Inverse inertia of A applied to (r_A x normal).
+		real_t angular_B[3][LANES];
+		real_t inv_mass_A[LANES];
+		real_t inv_mass_B[LANES];
+		real_t mass_normal[LANES];
+		real_t bias[LANES];
+		real_t bounce[LANES];
+		real_t friction[LANES];
+		real_t acc_normal_impulse[LANES];
+		real_t acc_bias_impulse[LANES];
+		real_t acc_bias_impulse_center_of_mass[LANES];
+		real_t acc_tangent_impulse[3][LANES];
+		real_t acc_impulse[3][LANES];
+		real_t active[LANES];
+		// Whether lanes apply impulses to their bodies (see GodotBodyPair3D::collide_A).
+		real_t collide_A[LANES];
+		real_t collide_B[LANES];
+
+		uint32_t body_A[LANES];
+		uint32_t body_B[LANES];
+		GodotBodyContact3D::Contact *contacts[LANES];
+	};
+
+	struct PendingContact {
+		GodotBodyPair3D *pair = nullptr;
+		int index = 0;
+		uint32_t body_A = 0;
+		uint32_t body_B = 0;
+	};
+
+	LocalVector<SolverBody> bodies;
+	HashMap<GodotBody3D *, uint32_t> body_indices;
+	LocalVector<ContactBatch> batches;
+	LocalVector<uint32_t> color_offsets; // Batches of color i are in [color_offsets[i], color_offsets[i + 1]).
+	real_t max_bias_angular_velocity = 0.0;
+
+	uint32_t _get_body_index(GodotBody3D *p_body);
+	void _add_contact(ContactBatch &p_batch, int p_lane, const PendingContact &p_pending);
+	void _solve_batch(ContactBatch &p_batch);
+
+public:
+	enum {
+		// Islands with less contacts than this are solved pair by pair.
+		MIN_CONTACTS = 2 * LANES,
+		// Colors with at least this many batches are solved on several threads.
+		MIN_PARALLEL_BATCHES = 64,
+	};
+
+	// Takes the body pairs of p_constraints that can be batched (collided, default priority),
+	// removes them from it, and packs their active contacts. Returns false and leaves
+	// p_constraints untouched if there aren't enough contacts to be worth it.
+	bool setup(LocalVector<GodotConstraint3D *> &p_constraints, real_t p_step);
+
+	// One solver iteration over all contacts. Colors are solved on several threads when
+	// they are big enough and p_allow_threads is set.
+	void solve(bool p_allow_threads);
+
+	// Between iterations, other constraints work on the bodies themselves.
+	void read_bodies();
+	void write_bodies() const;
+
+	// Stores the accumulated impulses back in the contacts of the body pairs.
+	void finish();
+
+	_FORCE_INLINE_ uint32_t get_batch_count() const { return batches.size(); }
+	_FORCE_INLINE_ uint32_t get_color_count() const { return color_offsets.is_empty() ? 0 : color_offsets.size() - 1; }
+};
+
+#endif // GODOT_CONTACT_SOLVER_3D_H
@@ -117,6 +117,10 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	// Not part of the server API, for engine code that rewinds a space (e.g. rollback networking).
+	void space_save_snapshot(RID p_space, GodotSpace3D::Snapshot &r_snapshot) const;
+	void space_restore_snapshot(RID p_space, const GodotSpace3D::Snapshot &p_snapshot);
+
 	/* AREA API */
 
 	virtual RID area_create() override;
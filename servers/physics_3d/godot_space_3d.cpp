@@ -34,6 +34,8 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
+#include "core/templates/parallel.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,16 +107,14 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_segment(begin, end, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindices);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -126,21 +126,21 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(r_cull_results[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_cull_subindices[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -205,6 +205,39 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, space->intersection_query_results, space->intersection_query_subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	// The broadphase culls are serialized by its own lock, the narrow phase runs in parallel.
+	SafeNumeric<int> hit_count;
+	auto chunk_function = [&](int64_t p_chunk, int64_t p_begin, int64_t p_end) {
+		FrameLocalVector<GodotCollisionObject3D *> cull_results;
+		FrameLocalVector<int> cull_subindices;
+		cull_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+		cull_subindices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+		int chunk_hit_count = 0;
+		for (int64_t i = p_begin; i < p_end; i++) {
+			r_hits[i] = _intersect_ray(p_parameters, p_from[i], p_to[i], r_results[i], cull_results.ptr(), cull_subindices.ptr());
+			if (r_hits[i]) {
+				chunk_hit_count++;
+			}
+		}
+		hit_count.add(chunk_hit_count);
+	};
+
+	const int64_t grain_size = MAX<int64_t>(ParallelChunksBase::get_grain_size(p_count, 0), GodotSpace3D::INTERSECTION_QUERY_BATCH_MIN_GRAIN);
+	ParallelChunks<decltype(chunk_function)>(0, p_count, grain_size, chunk_function).run();
+
+	return hit_count.get();
+}
+
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -260,55 +293,52 @@ int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
-	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
-	ERR_FAIL_NULL_V(shape, false);
-
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
+void GodotPhysicsDirectSpaceState3D::_cast_motion(const ShapeParameters &p_parameters, GodotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = space->broadphase->cull_aabb(aabb, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindices);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	Transform3D xform_inv = p_parameters.transform.affine_inverse();
+	Transform3D xform_inv = p_transform.affine_inverse();
 	GodotMotionShape3D mshape;
-	mshape.shape = shape;
-	mshape.motion = xform_inv.basis.xform(p_parameters.motion);
+	mshape.shape = p_shape;
+	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
-	Vector3 motion_normal = p_parameters.motion.normalized();
+	Vector3 motion_normal = p_motion.normalized();
 
 	Vector3 closest_A, closest_B;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_cull_results[i];
+		int shape_idx = r_cull_subindices[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!GodotCollisionSolver3D::solve_distance(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!GodotCollisionSolver3D::solve_distance(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -319,11 +349,11 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 		for (int j = 0; j < 8; j++) { //steps should be customizable..
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
-			mshape.motion = xform_inv.basis.xform(p_parameters.motion * fraction);
+			mshape.motion = xform_inv.basis.xform(p_motion * fraction);
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -375,6 +405,33 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 
 	p_closest_safe = best_safe;
 	p_closest_unsafe = best_unsafe;
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info) {
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	_cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, p_closest_safe, p_closest_unsafe, r_info, space->intersection_query_results, space->intersection_query_subindex_results);
+	return true;
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motions_batch(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_NULL_V(shape, false);
+
+	auto chunk_function = [&](int64_t p_chunk, int64_t p_begin, int64_t p_end) {
+		FrameLocalVector<GodotCollisionObject3D *> cull_results;
+		FrameLocalVector<int> cull_subindices;
+		cull_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+		cull_subindices.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+
+		for (int64_t i = p_begin; i < p_end; i++) {
+			_cast_motion(p_parameters, shape, p_transforms[i], p_motions[i], r_closest_safe[i], r_closest_unsafe[i], nullptr, cull_results.ptr(), cull_subindices.ptr());
+		}
+	};
+
+	const int64_t grain_size = MAX<int64_t>(ParallelChunksBase::get_grain_size(p_count, 0), GodotSpace3D::INTERSECTION_QUERY_BATCH_MIN_GRAIN);
+	ParallelChunks<decltype(chunk_function)>(0, p_count, grain_size, chunk_function).run();
 
 	return true;
 }
@@ -1031,14 +1088,22 @@ bool GodotSpace3D::test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::
 void *GodotSpace3D::_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self) {
 	GodotCollisionObject3D::Type type_A = A->get_type();
 	GodotCollisionObject3D::Type type_B = B->get_type();
-	if (type_A > type_B) {
+
+	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
+
+	// The broadphase reports pairs in an order that depends on its tree, make it only depend on the objects.
+	bool swap = type_A > type_B;
+	if (self->deterministic && type_A == type_B) {
+		uint64_t id_A = A->get_self().get_id();
+		uint64_t id_B = B->get_self().get_id();
+		swap = id_A > id_B || (id_A == id_B && p_subindex_A > p_subindex_B);
+	}
+	if (swap) {
 		SWAP(A, B);
 		SWAP(p_subindex_A, p_subindex_B);
 		SWAP(type_A, type_B);
 	}
 
-	GodotSpace3D *self = static_cast<GodotSpace3D *>(p_self);
-
 	self->collision_pairs++;
 
 	if (type_A == GodotCollisionObject3D::TYPE_AREA) {
@@ -1186,6 +1251,112 @@ void GodotSpace3D::update() {
 	broadphase->update();
 }
 
+void GodotSpace3D::save_snapshot(Snapshot &r_snapshot) const {
+	ERR_FAIL_COND_MSG(locked, "Can't take a snapshot of a space while it's being stepped.");
+
+	r_snapshot.bodies.clear();
+	r_snapshot.pairs.clear();
+
+	// Active bodies are stored first, restoring them in reverse order rebuilds the same active list.
+	for (const SelfList<GodotBody3D> *b = active_list.first(); b; b = b->next()) {
+		GodotBody3D *body = b->self();
+		Snapshot::BodyState body_state;
+		body_state.body = body;
+		body_state.rid = body->get_self();
+		body->save_state(body_state.state);
+		r_snapshot.bodies.push_back(body_state);
+	}
+
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		GodotBody3D *body = static_cast<GodotBody3D *>(object);
+		if (!body->is_active()) {
+			Snapshot::BodyState body_state;
+			body_state.body = body;
+			body_state.rid = body->get_self();
+			body->save_state(body_state.state);
+			r_snapshot.bodies.push_back(body_state);
+		}
+
+		for (const KeyValue<GodotConstraint3D *, int> &E : body->get_constraint_map()) {
+			if (E.value != 0) {
+				continue; // Each pair is stored once, from its first body.
+			}
+			GodotBodyPair3D *pair = E.key->get_body_pair();
+			if (!pair) {
+				continue;
+			}
+			Snapshot::PairState pair_state;
+			pair_state.body_A = pair->get_body_A();
+			pair_state.body_B = pair->get_body_B();
+			pair_state.rid_A = pair_state.body_A->get_self();
+			pair_state.rid_B = pair_state.body_B->get_self();
+			pair_state.shape_A = pair->get_shape_A();
+			pair_state.shape_B = pair->get_shape_B();
+			pair->save_state(pair_state.state);
+			r_snapshot.pairs.push_back(pair_state);
+		}
+	}
+}
+
+void GodotSpace3D::restore_snapshot(const Snapshot &p_snapshot) {
+	ERR_FAIL_COND_MSG(locked, "Can't restore a snapshot of a space while it's being stepped.");
+
+	// Bodies that were freed or moved to another space since the snapshot are skipped.
+	LocalVector<GodotBody3D *> bodies;
+	bodies.resize(p_snapshot.bodies.size());
+	for (uint32_t i = 0; i < p_snapshot.bodies.size(); i++) {
+		const Snapshot::BodyState &body_state = p_snapshot.bodies[i];
+		GodotBody3D *body = body_state.body;
+		if (!objects.has(body) || body->get_type() != GodotCollisionObject3D::TYPE_BODY || body->get_self() != body_state.rid) {
+			bodies[i] = nullptr;
+			continue;
+		}
+		bodies[i] = body;
+		body->load_state(body_state.state);
+		body->set_active(false);
+	}
+
+	for (int64_t i = (int64_t)p_snapshot.bodies.size() - 1; i >= 0; i--) {
+		if (bodies[i] && p_snapshot.bodies[i].state.active) {
+			bodies[i]->set_active(true);
+		}
+	}
+
+	// Create and remove the pairs for the restored transforms, then bring back their contacts.
+	broadphase->update();
+
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		for (const KeyValue<GodotConstraint3D *, int> &E : static_cast<GodotBody3D *>(object)->get_constraint_map()) {
+			GodotBodyPair3D *pair = E.key->get_body_pair();
+			if (pair) {
+				pair->load_state(GodotBodyPair3D::State());
+			}
+		}
+	}
+
+	// Outside of the deterministic mode, a pair can be recreated with its bodies the other way
+	// around, it then starts again without contacts.
+	for (const Snapshot::PairState &pair_state : p_snapshot.pairs) {
+		GodotBody3D *body_A = pair_state.body_A;
+		if (!objects.has(body_A) || body_A->get_self() != pair_state.rid_A || !objects.has(pair_state.body_B) || pair_state.body_B->get_self() != pair_state.rid_B) {
+			continue;
+		}
+		for (const KeyValue<GodotConstraint3D *, int> &E : body_A->get_constraint_map()) {
+			GodotBodyPair3D *pair = E.key->get_body_pair();
+			if (pair && pair->get_body_A() == body_A && pair->get_body_B() == pair_state.body_B && pair->get_shape_A() == pair_state.shape_A && pair->get_shape_B() == pair_state.shape_B) {
+				pair->load_state(pair_state.state);
+				break;
+			}
+		}
+	}
+}
+
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer3D::SPACE_PARAM_CONTACT_RECYCLE_RADIUS:
@@ -1258,6 +1429,8 @@ GodotSpace3D::GodotSpace3D() {
 	body_angular_velocity_sleep_threshold = GLOBAL_GET("physics/3d/sleep_threshold_angular");
 	body_time_to_sleep = GLOBAL_GET("physics/3d/time_before_sleep");
 	solver_iterations = GLOBAL_GET("physics/3d/solver/solver_iterations");
+	batched_contact_solver = GLOBAL_GET("physics/3d/solver/use_batched_contact_solver");
+	deterministic = GLOBAL_GET("physics/3d/solver/deterministic");
 	contact_recycle_radius = GLOBAL_GET("physics/3d/solver/contact_recycle_radius");
 	contact_max_separation = GLOBAL_GET("physics/3d/solver/contact_max_separation");
 	contact_max_allowed_penetration = GLOBAL_GET("physics/3d/solver/contact_max_allowed_penetration");
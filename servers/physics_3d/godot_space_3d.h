@@ -46,13 +46,19 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// These take the broadphase cull buffers, so batches can run them in parallel with their own.
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices);
+	void _cast_motion(const ShapeParameters &p_parameters, GodotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual int intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
+	virtual bool cast_motions_batch(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
@@ -94,6 +100,8 @@ private:
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
+	bool batched_contact_solver = false;
+	bool deterministic = false;
 
 	real_t contact_recycle_radius = 0.0;
 	real_t contact_max_separation = 0.0;
@@ -101,7 +109,8 @@ private:
 	real_t contact_bias = 0.0;
 
 	enum {
-		INTERSECTION_QUERY_MAX = 2048
+		INTERSECTION_QUERY_MAX = 2048,
+		INTERSECTION_QUERY_BATCH_MIN_GRAIN = 64, // Smallest slice of a batched query given to a thread.
 	};
 
 	GodotCollisionObject3D *intersection_query_results[INTERSECTION_QUERY_MAX];
@@ -161,6 +170,8 @@ public:
 	const HashSet<GodotCollisionObject3D *> &get_objects() const;
 
 	_FORCE_INLINE_ int get_solver_iterations() const { return solver_iterations; }
+	_FORCE_INLINE_ bool is_using_batched_contact_solver() const { return batched_contact_solver; }
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
@@ -211,6 +222,32 @@ public:
 
 	bool test_body_motion(GodotBody3D *p_body, const PhysicsServer3D::MotionParameters &p_parameters, PhysicsServer3D::MotionResult *r_result);
 
+	// State of the rigid bodies and of their contacts, to rewind the simulation.
+	// Areas, soft bodies and joints are not part of it.
+	struct Snapshot {
+		struct BodyState {
+			GodotBody3D *body = nullptr;
+			RID rid;
+			GodotBody3D::State state;
+		};
+
+		struct PairState {
+			GodotBody3D *body_A = nullptr;
+			GodotBody3D *body_B = nullptr;
+			RID rid_A;
+			RID rid_B;
+			int shape_A = 0;
+			int shape_B = 0;
+			GodotBodyPair3D::State state;
+		};
+
+		LocalVector<BodyState> bodies; // Active bodies come first, in the order of the active list.
+		LocalVector<PairState> pairs;
+	};
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void restore_snapshot(const Snapshot &p_snapshot);
+
 	GodotSpace3D();
 	~GodotSpace3D();
 };
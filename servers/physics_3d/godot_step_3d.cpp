@@ -30,6 +30,7 @@
 
 #include "godot_step_3d.h"
 
+#include "godot_contact_solver_3d.h"
 #include "godot_joint_3d.h"
 
 #include "core/object/worker_thread_pool.h"
@@ -40,6 +41,7 @@
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define LARGE_ISLAND_CONSTRAINT_COUNT 256
 
 void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
@@ -117,6 +119,23 @@ void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdat
 	constraint->setup(delta);
 }
 
+void GodotStep3D::_sort_island(LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	// Islands are built by walking the bodies' constraint maps, which are in the order the
+	// broadphase reported the pairs. Sorting by the objects involved makes the solving order
+	// only depend on the state of the simulation.
+	uint32_t constraint_count = p_constraint_island.size();
+	sorted_constraints.resize(constraint_count);
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint3D *constraint = p_constraint_island[constraint_index];
+		sorted_constraints[constraint_index].key = constraint->get_sort_key();
+		sorted_constraints[constraint_index].constraint = constraint;
+	}
+	sorted_constraints.sort();
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		p_constraint_island[constraint_index] = sorted_constraints[constraint_index].constraint;
+	}
+}
+
 void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
 	uint32_t constraint_count = p_constraint_island.size();
 	uint32_t valid_constraint_count = 0;
@@ -130,18 +149,39 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 	p_constraint_island.resize(valid_constraint_count);
 }
 
-void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
+void GodotStep3D::_solve_island(uint32_t p_island_index, bool p_allow_threads) {
 	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
 
+	// Takes the body pairs out of the island when it has enough contacts.
+	GodotContactSolver3D contact_solver;
+	bool solve_contacts = use_batched_contact_solver && contact_solver.setup(constraint_island, delta);
+
 	int current_priority = 1;
 
 	uint32_t constraint_count = constraint_island.size();
-	while (constraint_count > 0) {
+	while (constraint_count > 0 || solve_contacts) {
 		for (int i = 0; i < iterations; i++) {
 			// Go through all iterations.
+			if (solve_contacts) {
+				contact_solver.solve(p_allow_threads);
+				if (constraint_count == 0) {
+					continue;
+				}
+				contact_solver.write_bodies();
+			}
 			for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
 				constraint_island[constraint_index]->solve(delta);
 			}
+			if (solve_contacts) {
+				contact_solver.read_bodies();
+			}
+		}
+
+		if (solve_contacts) {
+			// Body pairs only have the default priority.
+			contact_solver.write_bodies();
+			contact_solver.finish();
+			solve_contacts = false;
 		}
 
 		// Check priority to keep only higher priority constraints.
@@ -158,6 +198,10 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+void GodotStep3D::_solve_threaded_island(uint32_t p_index, void *p_userdata) {
+	_solve_island(threaded_islands[p_index], false);
+}
+
 void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -191,6 +235,9 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	iterations = p_space->get_solver_iterations();
 	delta = p_delta;
+	deterministic = p_space->is_deterministic();
+	// The batched solver applies impulses in an order that depends on the island's graph coloring.
+	use_batched_contact_solver = p_space->is_using_batched_contact_solver() && !deterministic;
 
 	const SelfList<GodotBody3D>::List *body_list = &p_space->get_active_body_list();
 
@@ -357,6 +404,9 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	// Warning: This doesn't run on threads, because it involves thread-unsafe processing.
 	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		if (deterministic) {
+			_sort_island(constraint_islands[island_index]);
+		}
 		_pre_solve_island(constraint_islands[island_index]);
 	}
 
@@ -364,7 +414,20 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
+	threaded_islands.clear();
+	large_islands.clear();
+	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		if (use_batched_contact_solver && constraint_islands[island_index].size() >= LARGE_ISLAND_CONSTRAINT_COUNT) {
+			large_islands.push_back(island_index);
+		} else {
+			threaded_islands.push_back(island_index);
+		}
+	}
+
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_threaded_island, nullptr, threaded_islands.size(), -1, true, SNAME("Physics3DConstraintSolveIslands"));
+	for (uint32_t island_index : large_islands) {
+		_solve_island(island_index, true);
+	}
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
 	{ //profile
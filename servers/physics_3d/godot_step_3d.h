@@ -40,16 +40,31 @@ class GodotStep3D {
 
 	int iterations = 0;
 	real_t delta = 0.0;
+	bool use_batched_contact_solver = false;
+	bool deterministic = false;
+
+	struct SortedConstraint {
+		GodotConstraint3D::SortKey key;
+		GodotConstraint3D *constraint = nullptr;
+
+		bool operator<(const SortedConstraint &p_other) const { return key < p_other.key; }
+	};
+
+	LocalVector<SortedConstraint> sorted_constraints; // Scratch space for _sort_island.
 
 	LocalVector<LocalVector<GodotBody3D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
+	LocalVector<uint32_t> threaded_islands; // Solved in a group task, one island per thread.
+	LocalVector<uint32_t> large_islands; // Solved on the calling thread, with the colors of their contacts spread over threads.
 
 	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _sort_island(LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
-	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _solve_island(uint32_t p_island_index, bool p_allow_threads);
+	void _solve_threaded_island(uint32_t p_index, void *p_userdata = nullptr);
 	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
 
 public:
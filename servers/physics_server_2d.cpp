@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 PhysicsServer2D *PhysicsServer2D::singleton = nullptr;
@@ -410,6 +411,86 @@ Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion(const Ref<PhysicsShapeQue
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState2D::_intersect_rays_batch(const Ref<PhysicsRayQueryParameters2D> &p_ray_query, const PackedVector2Array &p_from, const PackedVector2Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The \"from\" and \"to\" arrays must have the same size.");
+
+	const int count = p_from.size();
+	LocalVector<RayResult> results;
+	LocalVector<bool> hits;
+	results.resize(count);
+	hits.resize(count);
+	// Servers may return early without writing any result (e.g. while the space is locked).
+	memset(hits.ptr(), 0, count * sizeof(bool));
+	intersect_rays_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), hits.ptr());
+
+	PackedVector2Array positions;
+	PackedVector2Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	shapes.resize(count);
+
+	Vector2 *positions_w = positions.ptrw();
+	Vector2 *normals_w = normals.ptrw();
+	int64_t *collider_ids_w = collider_ids.ptrw();
+	int32_t *shapes_w = shapes.ptrw();
+	for (int i = 0; i < count; i++) {
+		if (hits[i]) {
+			positions_w[i] = results[i].position;
+			normals_w[i] = results[i].normal;
+			collider_ids_w[i] = (int64_t)results[i].collider_id;
+			shapes_w[i] = results[i].shape;
+		} else {
+			positions_w[i] = Vector2();
+			normals_w[i] = Vector2();
+			collider_ids_w[i] = 0;
+			shapes_w[i] = -1;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState2D::_cast_motions_batch(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, const PackedVector2Array &p_origins, const PackedVector2Array &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "The \"origins\" and \"motions\" arrays must have the same size.");
+
+	const ShapeParameters &parameters = p_shape_query->get_parameters();
+	const int count = p_origins.size();
+	LocalVector<Transform2D> transforms;
+	LocalVector<real_t> closest_safe;
+	LocalVector<real_t> closest_unsafe;
+	transforms.resize(count);
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms[i] = parameters.transform;
+		transforms[i].set_origin(p_origins[i]);
+	}
+
+	if (!cast_motions_batch(parameters, transforms.ptr(), p_motions.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr())) {
+		return Vector<real_t>();
+	}
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_w = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_w[i * 2 + 0] = closest_safe[i];
+		ret_w[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
 TypedArray<Vector2> PhysicsDirectSpaceState2D::_collide_shape(const Ref<PhysicsShapeQueryParameters2D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Vector2>());
 
@@ -449,6 +530,34 @@ Dictionary PhysicsDirectSpaceState2D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+int PhysicsDirectSpaceState2D::intersect_rays_batch(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	int hit_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+		if (r_hits[i]) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
+bool PhysicsDirectSpaceState2D::cast_motions_batch(const ShapeParameters &p_parameters, const Transform2D *p_transforms, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		parameters.motion = p_motions[i];
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		if (!cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 PhysicsDirectSpaceState2D::PhysicsDirectSpaceState2D() {
 }
 
@@ -457,6 +566,8 @@ void PhysicsDirectSpaceState2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState2D::_intersect_ray);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState2D::_cast_motion);
+	ClassDB::bind_method(D_METHOD("intersect_rays_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState2D::_intersect_rays_batch);
+	ClassDB::bind_method(D_METHOD("cast_motions_batch", "parameters", "origins", "motions"), &PhysicsDirectSpaceState2D::_cast_motions_batch);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState2D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState2D::_get_rest_info);
 }
@@ -908,6 +1019,7 @@ PhysicsServer2D::PhysicsServer2D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.01,10,0.01,or_greater"), 0.3);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/2d/solver/default_constraint_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.2);
+	GLOBAL_DEF("physics/2d/solver/deterministic", false);
 }
 
 PhysicsServer2D::~PhysicsServer2D() {
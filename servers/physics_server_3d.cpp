@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/string/print_string.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/typed_array.h"
 
 void PhysicsServer3DRenderingServerHandler::set_vertex(int p_vertex_id, const Vector3 &p_vertex) {
@@ -435,6 +436,91 @@ Vector<real_t> PhysicsDirectSpaceState3D::_cast_motion(const Ref<PhysicsShapeQue
 	return ret;
 }
 
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays_batch(const Ref<PhysicsRayQueryParameters3D> &p_ray_query, const PackedVector3Array &p_from, const PackedVector3Array &p_to) {
+	ERR_FAIL_COND_V(!p_ray_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V_MSG(p_from.size() != p_to.size(), Dictionary(), "The \"from\" and \"to\" arrays must have the same size.");
+
+	const int count = p_from.size();
+	LocalVector<RayResult> results;
+	LocalVector<bool> hits;
+	results.resize(count);
+	hits.resize(count);
+	// Servers may return early without writing any result (e.g. while the space is locked).
+	memset(hits.ptr(), 0, count * sizeof(bool));
+	intersect_rays_batch(p_ray_query->get_parameters(), p_from.ptr(), p_to.ptr(), count, results.ptr(), hits.ptr());
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	PackedInt32Array face_indices;
+	positions.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+	shapes.resize(count);
+	face_indices.resize(count);
+
+	Vector3 *positions_w = positions.ptrw();
+	Vector3 *normals_w = normals.ptrw();
+	int64_t *collider_ids_w = collider_ids.ptrw();
+	int32_t *shapes_w = shapes.ptrw();
+	int32_t *face_indices_w = face_indices.ptrw();
+	for (int i = 0; i < count; i++) {
+		if (hits[i]) {
+			positions_w[i] = results[i].position;
+			normals_w[i] = results[i].normal;
+			collider_ids_w[i] = (int64_t)results[i].collider_id;
+			shapes_w[i] = results[i].shape;
+			face_indices_w[i] = results[i].face_index;
+		} else {
+			positions_w[i] = Vector3();
+			normals_w[i] = Vector3();
+			collider_ids_w[i] = 0;
+			shapes_w[i] = -1;
+			face_indices_w[i] = -1;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+	d["face_index"] = face_indices;
+
+	return d;
+}
+
+Vector<real_t> PhysicsDirectSpaceState3D::_cast_motions_batch(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const PackedVector3Array &p_origins, const PackedVector3Array &p_motions) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Vector<real_t>());
+	ERR_FAIL_COND_V_MSG(p_origins.size() != p_motions.size(), Vector<real_t>(), "The \"origins\" and \"motions\" arrays must have the same size.");
+
+	const ShapeParameters &parameters = p_shape_query->get_parameters();
+	const int count = p_origins.size();
+	LocalVector<Transform3D> transforms;
+	LocalVector<real_t> closest_safe;
+	LocalVector<real_t> closest_unsafe;
+	transforms.resize(count);
+	closest_safe.resize(count);
+	closest_unsafe.resize(count);
+	for (int i = 0; i < count; i++) {
+		transforms[i] = Transform3D(parameters.transform.basis, p_origins[i]);
+	}
+
+	if (!cast_motions_batch(parameters, transforms.ptr(), p_motions.ptr(), count, closest_safe.ptr(), closest_unsafe.ptr())) {
+		return Vector<real_t>();
+	}
+
+	Vector<real_t> ret;
+	ret.resize(count * 2);
+	real_t *ret_w = ret.ptrw();
+	for (int i = 0; i < count; i++) {
+		ret_w[i * 2 + 0] = closest_safe[i];
+		ret_w[i * 2 + 1] = closest_unsafe[i];
+	}
+	return ret;
+}
+
 TypedArray<Vector3> PhysicsDirectSpaceState3D::_collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results) {
 	ERR_FAIL_COND_V(!p_shape_query.is_valid(), TypedArray<Vector3>());
 
@@ -474,6 +560,34 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+int PhysicsDirectSpaceState3D::intersect_rays_batch(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	RayParameters parameters = p_parameters;
+	int hit_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		parameters.from = p_from[i];
+		parameters.to = p_to[i];
+		r_hits[i] = intersect_ray(parameters, r_results[i]);
+		if (r_hits[i]) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
+bool PhysicsDirectSpaceState3D::cast_motions_batch(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ShapeParameters parameters = p_parameters;
+	for (int i = 0; i < p_count; i++) {
+		parameters.transform = p_transforms[i];
+		parameters.motion = p_motions[i];
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		if (!cast_motion(parameters, r_closest_safe[i], r_closest_unsafe[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -482,6 +596,8 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("intersect_ray", "parameters"), &PhysicsDirectSpaceState3D::_intersect_ray);
 	ClassDB::bind_method(D_METHOD("intersect_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("cast_motion", "parameters"), &PhysicsDirectSpaceState3D::_cast_motion);
+	ClassDB::bind_method(D_METHOD("intersect_rays_batch", "parameters", "from", "to"), &PhysicsDirectSpaceState3D::_intersect_rays_batch);
+	ClassDB::bind_method(D_METHOD("cast_motions_batch", "parameters", "origins", "motions"), &PhysicsDirectSpaceState3D::_cast_motions_batch);
 	ClassDB::bind_method(D_METHOD("collide_shape", "parameters", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "parameters"), &PhysicsDirectSpaceState3D::_get_rest_info);
 }
@@ -1071,6 +1187,8 @@ PhysicsServer3D::PhysicsServer3D() {
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.001,or_greater"), 0.05);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_allowed_penetration", PROPERTY_HINT_RANGE, "0.001,0.1,0.001,or_greater"), 0.01);
 	GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "physics/3d/solver/default_contact_bias", PROPERTY_HINT_RANGE, "0,1,0.01"), 0.8);
+	GLOBAL_DEF("physics/3d/solver/use_batched_contact_solver", false);
+	GLOBAL_DEF("physics/3d/solver/deterministic", false);
 }
 
 PhysicsServer3D::~PhysicsServer3D() {
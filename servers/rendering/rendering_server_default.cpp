@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/io/marshalls.h"
+#include "core/os/frame_arena.h"
 #include "core/os/os.h"
 #include "core/templates/sort_array.h"
 #include "renderer_canvas_cull.h"
@@ -339,6 +340,7 @@ void RenderingServerDefault::_thread_exit() {
 
 void RenderingServerDefault::_thread_draw(bool p_swap_buffers, double frame_step) {
 	_draw(p_swap_buffers, frame_step);
+	FrameArena::end_thread_frame();
 }
 
 void RenderingServerDefault::_thread_flush() {
@@ -0,0 +1,182 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct Item {
+	int id = 0;
+};
+
+template <class T>
+class PairTestFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+template <class T>
+class CullTestFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+typedef BVH_Manager<Item, 1, true, 32, PairTestFunction<Item>, CullTestFunction<Item>> PairingBVH;
+
+// Tracks the pairs from the callbacks, and counts the callbacks that don't match a pair.
+struct PairTracker {
+	HashSet<uint64_t> pairs;
+	int mismatched_callbacks = 0;
+	LocalVector<int64_t> callbacks; // Keys of the pairs in callback order, negated for unpairs.
+
+	static uint64_t get_key(const Item *p_a, const Item *p_b) {
+		return (uint64_t(MIN(p_a->id, p_b->id)) << 32) | uint64_t(MAX(p_a->id, p_b->id));
+	}
+
+	static void *pair_callback(void *p_self, uint32_t p_a, Item *p_item_a, int p_subindex_a, uint32_t p_b, Item *p_item_b, int p_subindex_b) {
+		PairTracker *self = static_cast<PairTracker *>(p_self);
+		const uint64_t key = get_key(p_item_a, p_item_b);
+		if (self->pairs.has(key)) {
+			self->mismatched_callbacks++;
+		}
+		self->pairs.insert(key);
+		self->callbacks.push_back(int64_t(key));
+		return nullptr;
+	}
+
+	static void unpair_callback(void *p_self, uint32_t p_a, Item *p_item_a, int p_subindex_a, uint32_t p_b, Item *p_item_b, int p_subindex_b, void *p_pair_data) {
+		PairTracker *self = static_cast<PairTracker *>(p_self);
+		const uint64_t key = get_key(p_item_a, p_item_b);
+		if (!self->pairs.erase(key)) {
+			self->mismatched_callbacks++;
+		}
+		self->callbacks.push_back(-int64_t(key));
+	}
+};
+
+// Returns the callbacks sent while moving items around.
+static LocalVector<int64_t> test_moving_items_pairing(bool p_parallel_pairing) {
+	const int item_count = 300;
+	const int steps = 20;
+	const real_t expansion = 0.1;
+
+	PairTracker tracker;
+	PairingBVH bvh;
+	bvh.set_pair_callback(&PairTracker::pair_callback, &tracker);
+	bvh.set_unpair_callback(&PairTracker::unpair_callback, &tracker);
+	bvh.params_set_pairing_expansion(expansion);
+	bvh.params_set_parallel_pairing(p_parallel_pairing);
+
+	RandomPCG rng(1234);
+	LocalVector<Item> items;
+	LocalVector<BVHHandle> handles;
+	LocalVector<AABB> aabbs;
+	items.resize(item_count);
+	handles.resize(item_count);
+	aabbs.resize(item_count);
+	for (int i = 0; i < item_count; i++) {
+		items[i].id = i;
+		aabbs[i] = AABB(Vector3(rng.randf(), rng.randf(), rng.randf()) * 20.0, Vector3(1, 1, 1));
+		handles[i] = bvh.create(&items[i], true, 0, 1, aabbs[i]);
+	}
+
+	for (int step = 0; step < steps; step++) {
+		for (int i = 0; i < item_count; i++) {
+			aabbs[i].position += Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5);
+			bvh.move(handles[i], aabbs[i]);
+		}
+		bvh.update();
+
+		// Overlapping items must be paired.
+		int missing_pairs = 0;
+		for (int i = 0; i < item_count; i++) {
+			for (int j = i + 1; j < item_count; j++) {
+				if (aabbs[i].intersects(aabbs[j]) && !tracker.pairs.has(PairTracker::get_key(&items[i], &items[j]))) {
+					missing_pairs++;
+				}
+			}
+		}
+		CHECK_MESSAGE(missing_pairs == 0, vformat("Step %d has %d overlapping items that are not paired.", step, missing_pairs));
+
+		// Paired items must still overlap once expanded. An expanded AABB is only moved when the
+		// item leaves it, so it can reach up to twice the expansion past the item.
+		int stale_pairs = 0;
+		for (const uint64_t key : tracker.pairs) {
+			const AABB a = aabbs[key >> 32].grow(2 * expansion + CMP_EPSILON);
+			const AABB b = aabbs[key & 0xFFFFFFFF].grow(2 * expansion + CMP_EPSILON);
+			if (!a.intersects(b)) {
+				stale_pairs++;
+			}
+		}
+		CHECK_MESSAGE(stale_pairs == 0, vformat("Step %d has %d paired items that no longer overlap.", step, stale_pairs));
+	}
+
+	CHECK(tracker.mismatched_callbacks == 0);
+
+	for (int i = 0; i < item_count; i++) {
+		bvh.erase(handles[i]);
+	}
+	CHECK(tracker.pairs.is_empty());
+	CHECK(tracker.mismatched_callbacks == 0);
+
+	return tracker.callbacks;
+}
+
+TEST_CASE("[BVH] Pairing of moving items") {
+	const LocalVector<int64_t> serial_callbacks = test_moving_items_pairing(false);
+	const LocalVector<int64_t> parallel_callbacks = test_moving_items_pairing(true);
+
+	// Both send the same callbacks, in the same order.
+	CHECK(serial_callbacks.size() > 0);
+	REQUIRE(serial_callbacks.size() == parallel_callbacks.size());
+	int first_difference = -1;
+	for (uint32_t i = 0; i < serial_callbacks.size(); i++) {
+		if (serial_callbacks[i] != parallel_callbacks[i]) {
+			first_difference = i;
+			break;
+		}
+	}
+	CHECK_MESSAGE(first_difference == -1, vformat("The callbacks differ from callback %d on.", first_difference));
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
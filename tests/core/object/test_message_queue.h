@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*  test_message_queue.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+static LocalVector<Vector2i> received; // Producer index and sequence number, in the order they were called.
+
+static void record_message(int p_producer, int p_sequence) {
+	received.push_back(Vector2i(p_producer, p_sequence));
+}
+
+static const int MESSAGES_PER_PRODUCER = 500;
+
+static void producer_thread(void *p_userdata) {
+	const int producer = (int)(intptr_t)p_userdata;
+	for (int i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+		MessageQueue::get_singleton()->push_callable(callable_mp_static(&record_message), producer, i);
+	}
+}
+
+TEST_CASE("[SceneTree][MessageQueue] Messages pushed from several threads") {
+	const int producer_count = 8;
+	received.clear();
+
+	Thread threads[producer_count];
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].start(producer_thread, (void *)(intptr_t)i);
+	}
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	MessageQueue::get_singleton()->flush();
+
+	REQUIRE(received.size() == producer_count * MESSAGES_PER_PRODUCER);
+	// Messages of different threads may be interleaved, but each thread's own come in order.
+	int next_sequence[producer_count] = {};
+	bool in_order = true;
+	for (const Vector2i &message : received) {
+		in_order = in_order && message.y == next_sequence[message.x];
+		next_sequence[message.x]++;
+	}
+	CHECK(in_order);
+	received.clear();
+}
+
+static void push_from_thread_while_flushing(int p_producer, int p_sequence) {
+	record_message(p_producer, p_sequence);
+
+	Thread thread;
+	thread.start(producer_thread, (void *)(intptr_t)(p_producer + 1));
+	thread.wait_to_finish();
+}
+
+TEST_CASE("[SceneTree][MessageQueue] Messages pushed from a thread while flushing") {
+	received.clear();
+
+	MessageQueue::get_singleton()->push_callable(callable_mp_static(&push_from_thread_while_flushing), 0, 0);
+	MessageQueue::get_singleton()->flush();
+
+	// Processed by the same flush, right after the message that led to them being pushed.
+	REQUIRE(received.size() == 1 + MESSAGES_PER_PRODUCER);
+	CHECK(received[0] == Vector2i(0, 0));
+	bool in_order = true;
+	for (int i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+		in_order = in_order && received[1 + i] == Vector2i(1, i);
+	}
+	CHECK(in_order);
+	CHECK_FALSE(MessageQueue::get_singleton()->has_messages());
+	received.clear();
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -0,0 +1,203 @@
+/**************************************************************************/
+/*  test_frame_arena.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/os/frame_arena.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Allocations are aligned and don't overlap") {
+	FrameArena::end_frame();
+
+	uint8_t *a = (uint8_t *)FrameArena::alloc(3);
+	uint8_t *b = (uint8_t *)FrameArena::alloc(100);
+	CHECK(((uintptr_t)a % 16) == 0);
+	CHECK(((uintptr_t)b % 16) == 0);
+	CHECK(b >= a + 3);
+
+	memset(a, 0xAA, 3);
+	memset(b, 0xBB, 100);
+	CHECK(a[2] == 0xAA);
+
+	FrameArena::free(b);
+	FrameArena::free(a);
+}
+
+TEST_CASE("[FrameArena] Realloc keeps contents") {
+	FrameArena::end_frame();
+
+	uint32_t *mem = (uint32_t *)FrameArena::alloc(sizeof(uint32_t) * 4);
+	for (uint32_t i = 0; i < 4; i++) {
+		mem[i] = i;
+	}
+	// Last allocation, grows in place.
+	uint32_t *grown = (uint32_t *)FrameArena::realloc(mem, sizeof(uint32_t) * 8);
+	CHECK(grown == mem);
+
+	// Not the last one anymore, so it has to move.
+	void *other = FrameArena::alloc(16);
+	uint32_t *moved = (uint32_t *)FrameArena::realloc(grown, sizeof(uint32_t) * 100000);
+	CHECK(moved != grown);
+	for (uint32_t i = 0; i < 4; i++) {
+		CHECK(moved[i] == i);
+	}
+
+	FrameArena::free(moved);
+	FrameArena::free(other);
+}
+
+TEST_CASE("[FrameArena] Memory is reused across frames") {
+	FrameArena::end_frame();
+	void *first = FrameArena::alloc(64);
+	FrameArena::free(first);
+
+	FrameArena::end_frame();
+	void *second = FrameArena::alloc(64);
+	CHECK(first == second);
+	FrameArena::free(second);
+
+	// No new chunks needed for a frame as big as the previous ones.
+	FrameArena::end_frame();
+	uint64_t chunk_allocs = FrameArena::get_chunk_alloc_count();
+	void *again = FrameArena::alloc(64);
+	CHECK(FrameArena::get_chunk_alloc_count() == chunk_allocs);
+	FrameArena::free(again);
+}
+
+TEST_CASE("[FrameArena] Containers") {
+	FrameArena::end_frame();
+
+	FrameLocalVector<int> vector;
+	for (int i = 0; i < 1000; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.size() == 1000);
+	CHECK(vector[999] == 999);
+
+	FrameHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == 1000);
+	CHECK(map[500] == 1000);
+	map.erase(500);
+	CHECK(!map.has(500));
+}
+
+TEST_CASE("[FrameArena] end_frame() resets even with live allocations") {
+	FrameArena::end_frame();
+	void *leaked = FrameArena::alloc(64);
+
+	ERR_PRINT_OFF;
+	FrameArena::end_frame();
+	ERR_PRINT_ON;
+
+	// The arena doesn't keep growing because of allocations that were never freed.
+	void *next = FrameArena::alloc(64);
+	CHECK(next == leaked);
+	FrameArena::free(next);
+}
+
+static void free_from_other_thread(void *p_memory) {
+	ERR_PRINT_OFF;
+	FrameArena::free(p_memory);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[FrameArena] Memory can't be freed from another thread") {
+	FrameArena::end_frame();
+	void *first = FrameArena::alloc(64);
+	void *second = FrameArena::alloc(64);
+
+	Thread thread;
+	thread.start(free_from_other_thread, second);
+	thread.wait_to_finish();
+
+	// The failed free didn't touch this thread's arena, so the last allocation can still be given back.
+	FrameArena::free(second);
+	void *third = FrameArena::alloc(64);
+	CHECK(third == second);
+	FrameArena::free(third);
+	FrameArena::free(first);
+}
+
+// Counts the system allocations of a LocalVector, to compare with the arena.
+class CountingAllocator {
+public:
+	static inline uint32_t alloc_count = 0;
+	static void *realloc(void *p_memory, size_t p_bytes) {
+		if (!p_memory) {
+			alloc_count++;
+		}
+		return Memory::realloc_static(p_memory, p_bytes);
+	}
+	static void free(void *p_ptr) { Memory::free_static(p_ptr); }
+};
+
+TEST_CASE("[FrameArena] Per-frame containers stop allocating after the first frame") {
+	const int frames = 10;
+	const int elements = 2048;
+
+	CountingAllocator::alloc_count = 0;
+	for (int i = 0; i < frames; i++) {
+		LocalVector<int, uint32_t, false, false, CountingAllocator> results;
+		results.resize(elements);
+		FrameArena::end_frame();
+	}
+	CHECK(CountingAllocator::alloc_count == frames);
+
+	// Warm up, so the arena already has a chunk big enough.
+	{
+		FrameLocalVector<int> results;
+		results.resize(elements);
+	}
+	FrameArena::end_frame();
+
+	const uint64_t chunk_allocs = FrameArena::get_chunk_alloc_count();
+	const uint64_t live_allocs = Memory::get_alloc_count();
+	for (int i = 0; i < frames; i++) {
+		{
+			FrameLocalVector<int> results;
+			results.resize(elements);
+			CHECK(Memory::get_alloc_count() == live_allocs);
+		}
+		FrameArena::end_frame();
+	}
+	CHECK(FrameArena::get_chunk_alloc_count() == chunk_allocs);
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
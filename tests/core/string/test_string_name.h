@@ -0,0 +1,82 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "test_string_name_interning";
+	const StringName b = String("test_string_name_interning");
+	const StringName c = StringName::search("test_string_name_interning");
+
+	CHECK(a == b);
+	CHECK(a.data_unique_pointer() == c.data_unique_pointer());
+	CHECK(StringName::search("test_string_name_interning_missing") == StringName());
+
+	const uint64_t insertions = StringName::get_insertion_count();
+	const StringName d = "test_string_name_interning";
+	CHECK(d == a);
+	CHECK(StringName::get_insertion_count() == insertions);
+}
+
+static const int STRING_NAME_THREAD_NAMES = 512;
+static StringName string_name_thread_results[8][STRING_NAME_THREAD_NAMES];
+
+static void string_name_thread_intern(void *p_arg, uint32_t p_index) {
+	for (int i = 0; i < STRING_NAME_THREAD_NAMES; i++) {
+		string_name_thread_results[p_index][i] = StringName("test_string_name_threads_" + itos(i));
+	}
+}
+
+TEST_CASE("[StringName] Interning from several threads") {
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(string_name_thread_intern, nullptr, 8, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	bool all_unique = true;
+	for (int i = 0; i < STRING_NAME_THREAD_NAMES; i++) {
+		const StringName expected = "test_string_name_threads_" + itos(i);
+		for (int t = 0; t < 8; t++) {
+			all_unique &= string_name_thread_results[t][i].data_unique_pointer() == expected.data_unique_pointer();
+			string_name_thread_results[t][i] = StringName();
+		}
+	}
+	CHECK(all_unique);
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -0,0 +1,213 @@
+/**************************************************************************/
+/*  test_group_hash_map.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GROUP_HASH_MAP_H
+#define TEST_GROUP_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/group_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGroupHashMap {
+
+TEST_CASE("[GroupHashMap] Insert element") {
+	GroupHashMap<int, int> map;
+	GroupHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[GroupHashMap] Overwrite element") {
+	GroupHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[GroupHashMap] Erase via element and key") {
+	GroupHashMap<int, int> map;
+	GroupHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.insert(123, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+
+	CHECK(map.erase(123));
+	CHECK(!map.erase(123));
+	CHECK(map.is_empty());
+}
+
+TEST_CASE("[GroupHashMap] Iteration keeps insertion order") {
+	GroupHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+	map.insert(7, 7, true);
+
+	Vector<Pair<int, int>> expected;
+	expected.push_back(Pair<int, int>(7, 7));
+	expected.push_back(Pair<int, int>(42, 84));
+	expected.push_back(Pair<int, int>(123, 111111));
+	expected.push_back(Pair<int, int>(0, 12934));
+	expected.push_back(Pair<int, int>(123485, 1238888));
+
+	const GroupHashMap<int, int> const_map = map;
+
+	int idx = 0;
+	for (const KeyValue<int, int> &E : const_map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		++idx;
+	}
+	CHECK(idx == expected.size());
+}
+
+TEST_CASE("[GroupHashMap] Replace key") {
+	GroupHashMap<String, int> map;
+	map.insert("a", 1);
+	map.insert("b", 2);
+	map.insert("c", 3);
+
+	CHECK(map.replace_key("b", "d"));
+	CHECK(!map.has("b"));
+	CHECK(map["d"] == 2);
+	CHECK(!map.replace_key("a", "c"));
+
+	Vector<String> expected = { "a", "d", "c" };
+	int idx = 0;
+	for (const KeyValue<String, int> &E : map) {
+		CHECK(E.key == expected[idx]);
+		++idx;
+	}
+}
+
+TEST_CASE("[GroupHashMap] Many insertions and erasures match HashMap") {
+	GroupHashMap<uint32_t, uint32_t> map;
+	HashMap<uint32_t, uint32_t> reference;
+
+	// Keys collide a lot in the low bits, to exercise probing and tombstones.
+	uint32_t seed = 12345;
+	for (int i = 0; i < 20000; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		const uint32_t key = (seed >> 8) % 3000;
+		if (seed & 1) {
+			map.insert(key, i);
+			reference.insert(key, i);
+		} else {
+			CHECK(map.erase(key) == reference.erase(key));
+		}
+	}
+
+	CHECK(map.size() == reference.size());
+	CHECK(map.get_capacity() % HashGroup::WIDTH == 0);
+	for (const KeyValue<uint32_t, uint32_t> &E : reference) {
+		const uint32_t *value = map.getptr(E.key);
+		REQUIRE(value != nullptr);
+		CHECK(*value == E.value);
+	}
+	for (uint32_t key = 0; key < 3000; key++) {
+		CHECK(map.has(key) == reference.has(key));
+	}
+
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK(!map.has(0));
+}
+
+TEST_CASE("[GroupHashMap] Reserve") {
+	GroupHashMap<int, int> map;
+	map.reserve(1000);
+	const uint32_t capacity = map.get_capacity();
+	CHECK(capacity >= 1000);
+
+	for (int i = 0; i < 1000; i++) {
+		map[i] = i * 2;
+	}
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.size() == 1000);
+	CHECK(map[999] == 1998);
+}
+
+template <class TMap>
+static void benchmark_map(const char *p_name, uint32_t p_count) {
+	// An odd multiplier is a bijection on uint32_t, so keys are unique but scattered.
+	const uint32_t multiplier = 2654435761u;
+	TMap map;
+	uint32_t checksum = 0;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_count; i++) {
+		map.insert(i * multiplier, i);
+	}
+	const uint64_t insert_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_count; i++) {
+		checksum += *map.getptr(i * multiplier);
+	}
+	const uint64_t hit_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_count; i++) {
+		checksum += map.has((i + p_count) * multiplier);
+	}
+	const uint64_t miss_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < p_count; i++) {
+		map.erase(i * multiplier);
+	}
+	const uint64_t erase_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(map.is_empty());
+	MESSAGE(vformat("%s, %d elements: insert %.2f ms, hit %.2f ms, miss %.2f ms, erase %.2f ms (checksum %d)", p_name, p_count, insert_usec / 1000.0, hit_usec / 1000.0, miss_usec / 1000.0, erase_usec / 1000.0, checksum).utf8().get_data());
+}
+
+// Compares GroupHashMap with HashMap from 1e3 to 1e7 elements. This is a pending test since timings are
+// only meaningful on optimized builds; run it with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE_PENDING("[GroupHashMap][Benchmark] Insert, lookup and erase against HashMap") {
+	for (uint32_t count = 1000; count <= 10000000; count *= 10) {
+		benchmark_map<HashMap<uint32_t, uint32_t>>("HashMap", count);
+		benchmark_map<GroupHashMap<uint32_t, uint32_t>>("GroupHashMap", count);
+	}
+}
+
+} // namespace TestGroupHashMap
+
+#endif // TEST_GROUP_HASH_MAP_H
@@ -0,0 +1,113 @@
+/**************************************************************************/
+/*  test_group_hash_set.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GROUP_HASH_SET_H
+#define TEST_GROUP_HASH_SET_H
+
+#include "core/templates/group_hash_set.h"
+#include "core/templates/hash_set.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGroupHashSet {
+
+TEST_CASE("[GroupHashSet] Insert element") {
+	GroupHashSet<int> set;
+	GroupHashSet<int>::Iterator e = set.insert(42);
+
+	CHECK(e);
+	CHECK(*e == 42);
+	CHECK(set.has(42));
+	CHECK(set.find(42));
+	set.reset();
+}
+
+TEST_CASE("[GroupHashSet] Insert existing element") {
+	GroupHashSet<int> set;
+	set.insert(42);
+	set.insert(42);
+
+	CHECK(set.has(42));
+	CHECK(set.size() == 1);
+}
+
+TEST_CASE("[GroupHashSet] Erase keeps keys packed") {
+	GroupHashSet<int> set;
+	set.insert(1);
+	set.insert(2);
+	set.insert(3);
+	CHECK(set.erase(1));
+	CHECK(!set.erase(1));
+
+	// The last key takes the place of the erased one.
+	Vector<int> expected = { 3, 2 };
+	int idx = 0;
+	for (const int &E : set) {
+		CHECK(E == expected[idx]);
+		idx++;
+	}
+	CHECK(set.has(2));
+	CHECK(set.has(3));
+}
+
+TEST_CASE("[GroupHashSet] Many insertions and erasures match HashSet") {
+	GroupHashSet<String> set;
+	HashSet<String> reference;
+
+	uint32_t seed = 54321;
+	for (int i = 0; i < 10000; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		const String key = itos((seed >> 8) % 2000);
+		if (seed & 1) {
+			set.insert(key);
+			reference.insert(key);
+		} else {
+			CHECK(set.erase(key) == reference.erase(key));
+		}
+	}
+
+	CHECK(set.size() == reference.size());
+	for (const String &E : reference) {
+		CHECK(set.has(E));
+	}
+	for (const String &E : set) {
+		CHECK(reference.has(E));
+	}
+
+	GroupHashSet<String> copy = set;
+	CHECK(copy.size() == set.size());
+	for (const String &E : set) {
+		CHECK(copy.has(E));
+	}
+}
+
+} // namespace TestGroupHashSet
+
+#endif // TEST_GROUP_HASH_SET_H
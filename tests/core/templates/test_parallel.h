@@ -0,0 +1,117 @@
+/**************************************************************************/
+/*  test_parallel.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PARALLEL_H
+#define TEST_PARALLEL_H
+
+#include "core/math/random_number_generator.h"
+#include "core/templates/parallel.h"
+
+#include "tests/test_macros.h"
+
+namespace TestParallel {
+
+TEST_CASE("[Parallel] parallel_for visits every index once") {
+	for (int64_t count : { 0, 1, 7, 1000, 100000 }) {
+		LocalVector<SafeNumeric<int>> visits;
+		visits.resize(count);
+		parallel_for(0, count, [&](int64_t i) {
+			visits[i].increment();
+		});
+
+		bool all_once = true;
+		for (int64_t i = 0; i < count; i++) {
+			all_once &= visits[i].get() == 1;
+		}
+		CHECK(all_once);
+	}
+
+	// With an explicit grain size, and not starting at 0.
+	SafeNumeric<int64_t> sum;
+	parallel_for(10, 1010, [&](int64_t i) { sum.add(i); }, 3);
+	CHECK(sum.get() == (10 + 1009) * 1000 / 2);
+}
+
+TEST_CASE("[Parallel] parallel_reduce") {
+	const int64_t sum = parallel_reduce(
+			0, 100000, int64_t(0),
+			[](int64_t i) { return i; },
+			[](int64_t a, int64_t b) { return a + b; });
+	CHECK(sum == int64_t(100000) * 99999 / 2);
+
+	// Non-commutative reduction, chunks must be combined in order.
+	const String digits = parallel_reduce(
+			0, 2000, String(),
+			[](int64_t i) { return itos(i % 10); },
+			[](const String &a, const String &b) { return a + b; },
+			16);
+	String expected;
+	for (int i = 0; i < 2000; i++) {
+		expected += itos(i % 10);
+	}
+	CHECK(digits == expected);
+
+	CHECK(parallel_reduce(5, 5, 42, [](int64_t i) { return 0; }, [](int a, int b) { return a + b; }) == 42);
+}
+
+struct ParallelSortGreater {
+	_FORCE_INLINE_ bool operator()(const int &a, const int &b) const { return a > b; }
+};
+
+TEST_CASE("[Parallel] parallel_sort") {
+	Ref<RandomNumberGenerator> rng;
+	rng.instantiate();
+	rng->set_seed(1234);
+
+	for (int count : { 0, 1, 100, 4096, 50000, 100003 }) {
+		LocalVector<int> values;
+		for (int i = 0; i < count; i++) {
+			values.push_back(rng->randi_range(0, 1000));
+		}
+
+		parallel_sort(values.ptr(), values.size());
+		bool sorted = true;
+		for (int i = 1; i < count; i++) {
+			sorted &= values[i - 1] <= values[i];
+		}
+		CHECK(sorted);
+
+		parallel_sort<int, ParallelSortGreater>(values.ptr(), values.size());
+		bool reverse_sorted = true;
+		for (int i = 1; i < count; i++) {
+			reverse_sorted &= values[i - 1] >= values[i];
+		}
+		CHECK(reverse_sorted);
+	}
+}
+
+} // namespace TestParallel
+
+#endif // TEST_PARALLEL_H
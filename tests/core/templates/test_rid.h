@@ -31,7 +31,11 @@
 #ifndef TEST_RID_H
 #define TEST_RID_H
 
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 #include "core/templates/rid.h"
+#include "core/templates/rid_owner.h"
 
 #include "tests/test_macros.h"
 
@@ -96,6 +100,127 @@ TEST_CASE("[RID] 'get_local_index'") {
 	CHECK(RID::from_uint64(4'294'967'295).get_local_index() == 4'294'967'295);
 	CHECK(RID::from_uint64(4'294'967'297).get_local_index() == 1);
 }
+
+TEST_CASE("[RID_Owner] Allocate, get and free") {
+	RID_Owner<int> owner(sizeof(int) * 4); // Small chunks, to make it grow a few times.
+	LocalVector<RID> rids;
+	for (int i = 0; i < 100; i++) {
+		rids.push_back(owner.make_rid(i));
+	}
+	CHECK(owner.get_rid_count() == 100);
+
+	bool all_valid = true;
+	for (int i = 0; i < 100; i++) {
+		all_valid &= owner.owns(rids[i]) && *owner.get_or_null(rids[i]) == i;
+	}
+	CHECK(all_valid);
+
+	owner.free(rids[10]);
+	CHECK_FALSE(owner.owns(rids[10]));
+	CHECK(owner.get_or_null(rids[10]) == nullptr);
+
+	// The freed slot is reused with a new validator, so the old RID stays invalid.
+	RID reused = owner.make_rid(1000);
+	CHECK(reused.get_local_index() == rids[10].get_local_index());
+	CHECK(owner.get_or_null(rids[10]) == nullptr);
+	CHECK(*owner.get_or_null(reused) == 1000);
+
+	rids[10] = reused;
+	for (const RID &rid : rids) {
+		owner.free(rid);
+	}
+	CHECK(owner.get_rid_count() == 0);
+}
+
+static RID_Owner<uint64_t, true> rid_owner_threads(sizeof(uint64_t) * 64);
+static SafeFlag rid_owner_threads_failed;
+
+static void rid_owner_thread_test(void *p_arg, uint32_t p_index) {
+	LocalVector<RID> rids;
+	for (int iteration = 0; iteration < 20; iteration++) {
+		for (uint64_t i = 0; i < 200; i++) {
+			rids.push_back(rid_owner_threads.make_rid((uint64_t(p_index) << 32) | i));
+		}
+		for (uint64_t i = 0; i < 200; i++) {
+			uint64_t *value = rid_owner_threads.get_or_null(rids[i]);
+			if (!value || *value != ((uint64_t(p_index) << 32) | i)) {
+				rid_owner_threads_failed.set();
+			}
+		}
+		for (const RID &rid : rids) {
+			rid_owner_threads.free(rid);
+		}
+		rids.clear();
+	}
+}
+
+TEST_CASE("[RID_Owner] Thread safe allocation and lookups") {
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(rid_owner_thread_test, nullptr, 8, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	CHECK_FALSE(rid_owner_threads_failed.is_set());
+	CHECK(rid_owner_threads.get_rid_count() == 0);
+}
+
+static RID_Owner<uint64_t, true> rid_owner_benchmark;
+static LocalVector<RID> rid_owner_benchmark_rids;
+static SpinLock rid_owner_benchmark_lock;
+static bool rid_owner_benchmark_locked = false;
+
+static void rid_owner_benchmark_thread(void *p_userdata) {
+	const uint32_t lookups = 200000;
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < lookups; i++) {
+		// Some churn, so the spin lock is also taken by allocation and freeing.
+		if (i % 16 == 0) {
+			RID rid = rid_owner_benchmark.make_rid(i);
+			sum += *rid_owner_benchmark.get_or_null(rid);
+			rid_owner_benchmark.free(rid);
+		}
+		const RID &rid = rid_owner_benchmark_rids[i % rid_owner_benchmark_rids.size()];
+		if (rid_owner_benchmark_locked) {
+			// What lookups cost when they had to take the lock.
+			rid_owner_benchmark_lock.lock();
+			sum += *rid_owner_benchmark.get_or_null(rid);
+			rid_owner_benchmark_lock.unlock();
+		} else {
+			sum += *rid_owner_benchmark.get_or_null(rid);
+		}
+	}
+	*(uint64_t *)p_userdata = sum;
+}
+
+// Lookups per thread in a thread safe owner, with and without a lock around them. This is a pending test
+// since timings are only meaningful on optimized builds; run it with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE_PENDING("[RID_Owner][Benchmark] Concurrent lookups") {
+	for (uint64_t i = 0; i < 1024; i++) {
+		rid_owner_benchmark_rids.push_back(rid_owner_benchmark.make_rid(i));
+	}
+
+	for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+		for (int locked = 1; locked >= 0; locked--) {
+			rid_owner_benchmark_locked = locked;
+			Thread threads[8];
+			uint64_t sums[8] = {};
+
+			const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int i = 0; i < thread_count; i++) {
+				threads[i].start(rid_owner_benchmark_thread, &sums[i]);
+			}
+			for (int i = 0; i < thread_count; i++) {
+				threads[i].wait_to_finish();
+			}
+			const uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+			MESSAGE(vformat("%d thread(s), %s lookups: %.2f ms", thread_count, locked ? "locked" : "lock-free", elapsed / 1000.0).utf8().get_data());
+		}
+	}
+
+	for (const RID &rid : rid_owner_benchmark_rids) {
+		rid_owner_benchmark.free(rid);
+	}
+	rid_owner_benchmark_rids.clear();
+}
 } // namespace TestRID
 
 #endif // TEST_RID_H
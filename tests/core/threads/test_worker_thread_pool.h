@@ -106,6 +106,137 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+static SafeNumeric<uint32_t> nested_counter;
+
+static void static_nested_leaf_test(void *p_arg) {
+	nested_counter.increment();
+}
+static void static_nested_post_test(void *p_arg, uint32_t p_index) {
+	// Posted from a pool thread, so these go to its own work queue and may be stolen by idle threads.
+	const uint32_t leaf_count = (uintptr_t)p_arg;
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	tasks.resize(leaf_count);
+	for (uint32_t i = 0; i < leaf_count; i++) {
+		tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_leaf_test, nullptr, true);
+	}
+	for (uint32_t i = 0; i < leaf_count; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+	}
+}
+TEST_CASE("[WorkerThreadPool] Many small tasks posted from pool threads") {
+	const uint32_t leaf_count = 16;
+
+	for (int iterations = 0; iterations < 200; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 6.0f));
+
+		nested_counter.set(0);
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_nested_post_test, (void *)(uintptr_t)leaf_count, count, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+		CHECK(nested_counter.get() == count * leaf_count);
+	}
+}
+
+static SafeNumeric<uint32_t> stage_counter;
+static SafeNumeric<uint32_t> stage_errors;
+
+static void static_first_stage_test(void *p_arg, uint32_t p_index) {
+	stage_counter.increment();
+}
+static void static_second_stage_test(void *p_arg) {
+	// Must only run once every element of the first stage is done.
+	if (stage_counter.get() != (uintptr_t)p_arg) {
+		stage_errors.increment();
+	}
+	stage_counter.increment();
+}
+static void static_third_stage_test(void *p_arg, uint32_t p_index) {
+	if (stage_counter.get() != (uintptr_t)p_arg + 1) {
+		stage_errors.increment();
+	}
+}
+TEST_CASE("[WorkerThreadPool] Tasks with dependencies") {
+	for (int iterations = 0; iterations < 500; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 5.0f));
+		const bool low_priority = Math::rand() % 2;
+
+		stage_counter.set(0);
+		stage_errors.set(0);
+
+		WorkerThreadPool::GroupID first = WorkerThreadPool::get_singleton()->add_native_group_task(static_first_stage_test, nullptr, count, -1, !low_priority);
+		Vector<WorkerThreadPool::TaskID> dependencies;
+		dependencies.push_back(first);
+		WorkerThreadPool::TaskID second = WorkerThreadPool::get_singleton()->add_native_task_with_dependencies(static_second_stage_test, (void *)(uintptr_t)count, dependencies, low_priority);
+		dependencies.push_back(second);
+		WorkerThreadPool::GroupID third = WorkerThreadPool::get_singleton()->add_native_group_task_with_dependencies(static_third_stage_test, (void *)(uintptr_t)count, count, dependencies, -1, !low_priority);
+
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(third);
+		CHECK(WorkerThreadPool::get_singleton()->is_task_completed(second));
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(second);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(first);
+
+		CHECK(stage_errors.get() == 0);
+		CHECK(stage_counter.get() == (uint32_t)count + 1);
+	}
+}
+
+static SafeFlag slow_dependency_done;
+
+static void static_slow_dependency_test(void *p_arg) {
+	OS::get_singleton()->delay_usec(1000);
+	slow_dependency_done.set();
+}
+static void static_empty_group_test(void *p_arg, uint32_t p_index) {
+	stage_errors.increment(); // Never called, the group has no elements.
+}
+TEST_CASE("[WorkerThreadPool] Empty group with dependencies") {
+	for (int iterations = 0; iterations < 20; iterations++) {
+		slow_dependency_done.clear();
+		stage_errors.set(0);
+
+		Vector<WorkerThreadPool::TaskID> dependencies;
+		dependencies.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_slow_dependency_test, nullptr, iterations % 2));
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task_with_dependencies(static_empty_group_test, nullptr, 0, dependencies);
+
+		// Waiting for the group also waits for its dependencies, even without elements.
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		CHECK(slow_dependency_done.is_set());
+		CHECK(stage_errors.get() == 0);
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(dependencies[0]);
+	}
+
+	// Without dependencies, it's completed right away.
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_empty_group_test, nullptr, 0);
+	CHECK(WorkerThreadPool::get_singleton()->is_group_task_completed(group));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+
+// Every pool thread posting tiny tasks at once, which is where submitting contends the most.
+// This is a pending test since timings are only meaningful on optimized builds;
+// run it with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE_PENDING("[WorkerThreadPool][Benchmark] Tasks posted concurrently from pool threads") {
+	const uint32_t leaf_count = 4096;
+	const int posters = MAX(1, WorkerThreadPool::get_singleton()->get_thread_count());
+
+	for (int from_pool = 0; from_pool < 2; from_pool++) {
+		nested_counter.set(0);
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		if (from_pool) {
+			WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_nested_post_test, (void *)(uintptr_t)leaf_count, posters, posters, true);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		} else {
+			// Same amount of tasks, all posted from this thread through the shared queue.
+			for (int i = 0; i < posters; i++) {
+				static_nested_post_test((void *)(uintptr_t)leaf_count, i);
+			}
+		}
+		const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		CHECK(nested_counter.get() == posters * leaf_count);
+		MESSAGE(vformat("Posted from %s: %d tasks in %.2f ms, %.0f tasks/s", from_pool ? "pool threads" : "the main thread", posters * leaf_count, elapsed / 1000.0, posters * leaf_count * 1000000.0 / elapsed).utf8().get_data());
+	}
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
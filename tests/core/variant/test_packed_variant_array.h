@@ -0,0 +1,148 @@
+/**************************************************************************/
+/*  test_packed_variant_array.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PACKED_VARIANT_ARRAY_H
+#define TEST_PACKED_VARIANT_ARRAY_H
+
+#include "core/variant/packed_variant_array.h"
+#include "tests/test_macros.h"
+
+namespace TestPackedVariantArray {
+
+TEST_CASE("[PackedVariantArray] Supported types") {
+	CHECK(PackedVariantArray::is_type_supported(Variant::TRANSFORM2D));
+	CHECK(PackedVariantArray::is_type_supported(Variant::AABB));
+	CHECK(PackedVariantArray::is_type_supported(Variant::BASIS));
+	CHECK(PackedVariantArray::is_type_supported(Variant::TRANSFORM3D));
+	CHECK(PackedVariantArray::is_type_supported(Variant::PROJECTION));
+	// Stored inline in `Variant`, packed arrays exist for these already.
+	CHECK_FALSE(PackedVariantArray::is_type_supported(Variant::VECTOR3));
+	CHECK_FALSE(PackedVariantArray::is_type_supported(Variant::NIL));
+
+	ERR_PRINT_OFF;
+	PackedVariantArray invalid(Variant::VECTOR3);
+	CHECK(invalid.get_type() == Variant::NIL);
+	CHECK(invalid.resize(4) == ERR_UNCONFIGURED);
+	ERR_PRINT_ON;
+	CHECK(invalid.is_empty());
+}
+
+TEST_CASE("[PackedVariantArray] Values are stored contiguously") {
+	PackedVariantArray transforms(Variant::TRANSFORM3D);
+	CHECK(transforms.resize(64) == OK);
+	CHECK(transforms.size() == 64);
+
+	// New elements are default constructed, not zeroed.
+	const Transform3D *values = transforms.ptr<Transform3D>();
+	REQUIRE(values != nullptr);
+	CHECK(values[0] == Transform3D());
+	CHECK(values[63] == Transform3D());
+
+	Transform3D *written = transforms.ptrw<Transform3D>();
+	for (int i = 0; i < transforms.size(); i++) {
+		written[i].origin = Vector3(i, 0, 0);
+	}
+	CHECK(Transform3D(transforms.get(10)).origin == Vector3(10, 0, 0));
+
+	ERR_PRINT_OFF;
+	CHECK(transforms.ptr<Basis>() == nullptr);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[PackedVariantArray] set(), get() and push_back()") {
+	PackedVariantArray boxes(Variant::AABB);
+	const AABB box(Vector3(1, 2, 3), Vector3(4, 5, 6));
+	boxes.push_back(box);
+	boxes.push_back(AABB());
+	CHECK(boxes.size() == 2);
+	CHECK(boxes.get(0).get_type() == Variant::AABB);
+	CHECK(AABB(boxes.get(0)) == box);
+
+	boxes.set(1, box);
+	CHECK(AABB(boxes.get(1)) == box);
+
+	// Values of other types and indices out of bounds are rejected.
+	ERR_PRINT_OFF;
+	boxes.set(0, Transform3D());
+	boxes.push_back(Basis());
+	CHECK(boxes.get(2) == Variant());
+	ERR_PRINT_ON;
+	CHECK(boxes.size() == 2);
+	CHECK(AABB(boxes.get(0)) == box);
+}
+
+TEST_CASE("[PackedVariantArray] Copies share the buffer until written") {
+	PackedVariantArray a(Variant::BASIS);
+	a.push_back(Basis::from_scale(Vector3(2, 2, 2)));
+	PackedVariantArray b = a;
+	CHECK(a.ptr<Basis>() == b.ptr<Basis>());
+
+	b.set(0, Basis());
+	CHECK(a.ptr<Basis>() != b.ptr<Basis>());
+	CHECK(Basis(a.get(0)) == Basis::from_scale(Vector3(2, 2, 2)));
+	CHECK(Basis(b.get(0)) == Basis());
+}
+
+TEST_CASE("[PackedVariantArray] Conversion to and from Array") {
+	PackedVariantArray transforms(Variant::TRANSFORM2D);
+	for (int i = 0; i < 8; i++) {
+		transforms.push_back(Transform2D(i * 0.1, Vector2(i, -i)));
+	}
+
+	Array array = transforms.to_array();
+	CHECK(array.is_typed());
+	CHECK(array.get_typed_builtin() == Variant::TRANSFORM2D);
+	REQUIRE(array.size() == 8);
+	for (int i = 0; i < 8; i++) {
+		CHECK(Transform2D(array[i]) == Transform2D(transforms.get(i)));
+	}
+
+	PackedVariantArray converted(Variant::TRANSFORM2D);
+	CHECK(converted.from_array(array) == OK);
+	CHECK(converted.size() == 8);
+	CHECK(Transform2D(converted.get(7)) == Transform2D(transforms.get(7)));
+
+	// Untyped arrays work as long as every element has the stored type.
+	Array untyped;
+	untyped.push_back(Transform2D());
+	untyped.push_back(Transform3D());
+	ERR_PRINT_OFF;
+	CHECK(converted.from_array(untyped) == ERR_INVALID_PARAMETER);
+	ERR_PRINT_ON;
+	// Left as it was.
+	CHECK(converted.size() == 8);
+	untyped.pop_back();
+	CHECK(converted.from_array(untyped) == OK);
+	CHECK(converted.size() == 1);
+}
+
+} // namespace TestPackedVariantArray
+
+#endif // TEST_PACKED_VARIANT_ARRAY_H
@@ -0,0 +1,154 @@
+/**************************************************************************/
+/*  test_physics_server_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "servers/physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+TEST_CASE("[SceneTree][PhysicsServer2D] Batched queries match single queries") {
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+
+	// A floor with a row of static boxes on it.
+	RID floor_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(floor_shape, Vector2(20, 1));
+	RID box_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(box_shape, Vector2(0.5, 0.5));
+	Vector<RID> bodies;
+	for (int i = 0; i < 9; i++) {
+		RID body = ps->body_create();
+		ps->body_set_mode(body, PhysicsServer2D::BODY_MODE_STATIC);
+		ps->body_set_space(body, space);
+		ps->body_add_shape(body, i == 0 ? floor_shape : box_shape);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, i == 0 ? Transform2D(0, Vector2(0, 1)) : Transform2D(i * 0.3, Vector2(i * 2.0 - 10.0, -1.0 - (i % 3))));
+		bodies.push_back(body);
+	}
+	ps->step(1.0 / 60.0);
+
+	PhysicsDirectSpaceState2D *space_state = ps->space_get_direct_state(space);
+	REQUIRE(space_state != nullptr);
+
+	// More than the 2048 entries of a chunk's cull buffers, so the batch is split and runs on
+	// several threads. Batches of 64 or less run on this thread.
+	const int max_count = 3000;
+	Vector<Vector2> from;
+	Vector<Vector2> to;
+	Vector<Transform2D> transforms;
+	Vector<Vector2> motions;
+	for (int i = 0; i < max_count; i++) {
+		// Mostly down onto the boxes and the floor, every fourth query goes up and misses.
+		const Vector2 origin((i % 97) * 0.25 - 12.0, -4.0 - (i % 7) * 0.5);
+		const Vector2 motion(Math::sin(i * 0.1) * 3.0, i % 4 == 0 ? -4.0 : 6.0 + (i % 5));
+		from.push_back(origin);
+		to.push_back(origin + motion);
+		transforms.push_back(Transform2D(i * 0.05, origin));
+		motions.push_back(motion);
+	}
+
+	RID cast_shape = ps->rectangle_shape_create();
+	ps->shape_set_data(cast_shape, Vector2(0.2, 0.3));
+
+	const int counts[] = { 1, 64, max_count };
+	for (int count : counts) {
+		PhysicsDirectSpaceState2D::RayParameters ray_parameters;
+		Vector<PhysicsDirectSpaceState2D::RayResult> results;
+		results.resize(count);
+		Vector<uint8_t> hits;
+		hits.resize(count);
+		const int hit_count = space_state->intersect_rays_batch(ray_parameters, from.ptr(), to.ptr(), count, results.ptrw(), (bool *)hits.ptrw());
+
+		int single_hit_count = 0;
+		int ray_mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			ray_parameters.from = from[i];
+			ray_parameters.to = to[i];
+			PhysicsDirectSpaceState2D::RayResult result;
+			const bool hit = space_state->intersect_ray(ray_parameters, result);
+			single_hit_count += hit;
+			if (hit != bool(hits[i])) {
+				ray_mismatches++;
+			} else if (hit && (result.position != results[i].position || result.normal != results[i].normal || result.rid != results[i].rid || result.shape != results[i].shape)) {
+				ray_mismatches++;
+			}
+		}
+		CHECK_MESSAGE(ray_mismatches == 0, vformat("%d of %d rays differ from single queries.", ray_mismatches, count));
+		CHECK(hit_count == single_hit_count);
+		if (count == max_count) {
+			CHECK(hit_count > 0);
+			CHECK(hit_count < count);
+		}
+
+		PhysicsDirectSpaceState2D::ShapeParameters shape_parameters;
+		shape_parameters.shape_rid = cast_shape;
+		Vector<real_t> safe;
+		Vector<real_t> unsafe;
+		safe.resize(count);
+		unsafe.resize(count);
+		REQUIRE(space_state->cast_motions_batch(shape_parameters, transforms.ptr(), motions.ptr(), count, safe.ptrw(), unsafe.ptrw()));
+
+		int blocked_count = 0;
+		int motion_mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			shape_parameters.transform = transforms[i];
+			shape_parameters.motion = motions[i];
+			real_t single_safe = 0;
+			real_t single_unsafe = 0;
+			REQUIRE(space_state->cast_motion(shape_parameters, single_safe, single_unsafe));
+			blocked_count += single_safe < 1;
+			if (single_safe != safe[i] || single_unsafe != unsafe[i]) {
+				motion_mismatches++;
+			}
+		}
+		CHECK_MESSAGE(motion_mismatches == 0, vformat("%d of %d motions differ from single queries.", motion_mismatches, count));
+		if (count == max_count) {
+			CHECK(blocked_count > 0);
+			CHECK(blocked_count < count);
+		}
+	}
+
+	ps->free(cast_shape);
+	for (const RID &body : bodies) {
+		ps->free(body);
+	}
+	ps->free(box_shape);
+	ps->free(floor_shape);
+	ps->free(space);
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H
@@ -0,0 +1,338 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/config/project_settings.h"
+#include "core/os/frame_arena.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_body_pair_3d.h"
+#include "servers/physics_3d/godot_physics_server_3d.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+// A space with a static floor and a grid of box stacks resting on it.
+struct BoxScene {
+	RID space;
+	RID box_shape;
+	RID floor_shape;
+	RID floor;
+	Vector<RID> boxes;
+
+	BoxScene(bool p_batched, int p_columns, int p_height) {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+
+		// The solver is picked when the space is created.
+		const Variant previous = GLOBAL_GET("physics/3d/solver/use_batched_contact_solver");
+		ProjectSettings::get_singleton()->set_setting("physics/3d/solver/use_batched_contact_solver", p_batched);
+		space = ps->space_create();
+		ProjectSettings::get_singleton()->set_setting("physics/3d/solver/use_batched_contact_solver", previous);
+		ps->space_set_active(space, true);
+
+		floor_shape = ps->box_shape_create();
+		ps->shape_set_data(floor_shape, Vector3(p_columns * 2.0 + 10.0, 0.5, p_columns * 2.0 + 10.0));
+		floor = ps->body_create();
+		ps->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		ps->body_set_space(floor, space);
+		ps->body_add_shape(floor, floor_shape);
+		ps->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+
+		box_shape = ps->box_shape_create();
+		ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+		for (int x = 0; x < p_columns; x++) {
+			for (int z = 0; z < p_columns; z++) {
+				for (int y = 0; y < p_height; y++) {
+					RID box = ps->body_create();
+					ps->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+					ps->body_set_space(box, space);
+					ps->body_add_shape(box, box_shape);
+					ps->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), get_rest_position(x, y, z)));
+					boxes.push_back(box);
+				}
+			}
+		}
+	}
+
+	~BoxScene() {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (const RID &box : boxes) {
+			ps->free(box);
+		}
+		ps->free(floor);
+		ps->free(box_shape);
+		ps->free(floor_shape);
+		ps->free(space);
+	}
+
+	static Vector3 get_rest_position(int p_x, int p_y, int p_z) {
+		return Vector3(p_x * 2.0, 0.5 + p_y, p_z * 2.0);
+	}
+
+	Vector3 get_box_position(int p_index) const {
+		Transform3D transform = PhysicsServer3D::get_singleton()->body_get_state(boxes[p_index], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		return transform.origin;
+	}
+
+	void step(int p_steps) {
+		PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+		for (int i = 0; i < p_steps; i++) {
+			ps->step(1.0 / 60.0);
+		}
+	}
+};
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Box stack stays upright") {
+	const int height = 5;
+
+	SUBCASE("Sequential contact solver") {
+		BoxScene scene(false, 1, height);
+		scene.step(120);
+		for (int y = 0; y < height; y++) {
+			CHECK(scene.get_box_position(y).distance_to(BoxScene::get_rest_position(0, y, 0)) < 0.2);
+		}
+	}
+
+	SUBCASE("Batched contact solver") {
+		BoxScene scene(true, 1, height);
+		scene.step(120);
+		for (int y = 0; y < height; y++) {
+			CHECK(scene.get_box_position(y).distance_to(BoxScene::get_rest_position(0, y, 0)) < 0.2);
+		}
+	}
+}
+
+TEST_CASE("[PhysicsServer3D] Contact manifold reduction keeps the widest contacts") {
+	SUBCASE("A shallow contact far from the others is kept") {
+		// Deeper contacts bunched up in a corner, and a new one across the face. Dropping the
+		// least deep contact, the new one, would leave the body balanced on the corner.
+		const Vector3 points[] = { Vector3(0, 0, 0), Vector3(0.1, 0, 0), Vector3(0, 0, 0.1), Vector3(0.1, 0, 0.1), Vector3(2, 0, 2) };
+		const real_t depths[] = { 0.05, 0.04, 0.04, 0.04, 0.01 };
+		CHECK(GodotBodyPair3D::get_contact_to_remove(points, depths) == 3);
+	}
+
+	SUBCASE("A contact inside the others is dropped") {
+		const Vector3 points[] = { Vector3(-1, 0, -1), Vector3(1, 0, -1), Vector3(1, 0, 1), Vector3(-1, 0, 1), Vector3(0.2, 0, 0.1) };
+		const real_t depths[] = { 0.02, 0.02, 0.02, 0.02, 0.01 };
+		CHECK(GodotBodyPair3D::get_contact_to_remove(points, depths) == 4);
+	}
+
+	SUBCASE("The deepest contact is kept") {
+		// The new contact widens the manifold past the last corner, which is dropped unless it's the deepest.
+		const Vector3 points[] = { Vector3(-1, 0, -1), Vector3(1, 0, -1), Vector3(1, 0, 1), Vector3(-1, 0, 1), Vector3(-1.5, 0, 1.5) };
+		real_t depths[] = { 0.02, 0.02, 0.02, 0.02, 0.01 };
+		CHECK(GodotBodyPair3D::get_contact_to_remove(points, depths) == 3);
+		depths[3] = 0.05;
+		CHECK(GodotBodyPair3D::get_contact_to_remove(points, depths) == 4);
+	}
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Deterministic space replays from a snapshot") {
+	GodotPhysicsServer3D *ps = Object::cast_to<GodotPhysicsServer3D>(PhysicsServer3D::get_singleton());
+	REQUIRE_MESSAGE(ps != nullptr, "Snapshots are only supported by Godot Physics.");
+
+	const Variant previous = GLOBAL_GET("physics/3d/solver/deterministic");
+	ProjectSettings::get_singleton()->set_setting("physics/3d/solver/deterministic", true);
+	BoxScene scene(false, 2, 4);
+	ProjectSettings::get_singleton()->set_setting("physics/3d/solver/deterministic", previous);
+
+	// Give the stacks some sideways motion so the replay goes through changing contacts.
+	for (int i = 0; i < scene.boxes.size(); i++) {
+		ps->body_set_state(scene.boxes[i], PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(0.5 * (i % 3), 0, -0.25 * (i % 2)));
+	}
+	scene.step(30);
+
+	GodotSpace3D::Snapshot snapshot;
+	ps->space_save_snapshot(scene.space, snapshot);
+	CHECK(snapshot.bodies.size() == (uint32_t)scene.boxes.size() + 1);
+	CHECK(snapshot.pairs.size() > 0);
+
+	scene.step(60);
+	Vector<Transform3D> transforms;
+	for (const RID &box : scene.boxes) {
+		transforms.push_back(ps->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM));
+	}
+
+	ps->space_restore_snapshot(scene.space, snapshot);
+	scene.step(60);
+	for (int i = 0; i < scene.boxes.size(); i++) {
+		const Transform3D transform = ps->body_get_state(scene.boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK_MESSAGE(transform == transforms[i], vformat("Box %d ended at %s instead of %s.", i, transform, transforms[i]));
+	}
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched ray queries reuse the frame arena") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	BoxScene scene(false, 1, 1);
+	scene.step(1);
+
+	PhysicsDirectSpaceState3D *space_state = ps->space_get_direct_state(scene.space);
+	REQUIRE(space_state != nullptr);
+
+	// Small enough to run on this thread, so only its arena is involved.
+	const int ray_count = 32;
+	Vector3 from[ray_count];
+	Vector3 to[ray_count];
+	for (int i = 0; i < ray_count; i++) {
+		from[i] = Vector3(-0.4 + i * 0.025, 5, 0);
+		to[i] = from[i] - Vector3(0, 10, 0);
+	}
+	PhysicsDirectSpaceState3D::RayParameters parameters;
+	PhysicsDirectSpaceState3D::RayResult results[ray_count];
+	bool hits[ray_count];
+
+	// The first frame sizes the arena.
+	CHECK(space_state->intersect_rays_batch(parameters, from, to, ray_count, results, hits) == ray_count);
+	FrameArena::end_frame();
+
+	// After that, the cull result lists don't allocate anymore.
+	const uint64_t chunk_allocs = FrameArena::get_chunk_alloc_count();
+	for (int frame = 0; frame < 10; frame++) {
+		CHECK(space_state->intersect_rays_batch(parameters, from, to, ray_count, results, hits) == ray_count);
+		FrameArena::end_frame();
+	}
+	CHECK(FrameArena::get_chunk_alloc_count() == chunk_allocs);
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Batched queries match single queries") {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	BoxScene scene(false, 4, 2);
+	scene.step(1);
+
+	PhysicsDirectSpaceState3D *space_state = ps->space_get_direct_state(scene.space);
+	REQUIRE(space_state != nullptr);
+
+	// More than the 2048 entries of a chunk's cull buffers, so the batch is split and runs on
+	// several threads. Batches of 64 or less run on this thread.
+	const int max_count = 3000;
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	Vector<Transform3D> transforms;
+	Vector<Vector3> motions;
+	for (int i = 0; i < max_count; i++) {
+		// Mostly down onto the stacks and the floor, every fourth query goes up and misses.
+		const Vector3 origin((i % 53) * 0.25 - 2.0, 2.5 + (i % 7) * 0.5, ((i / 53) % 53) * 0.25 - 2.0);
+		const Vector3 motion(Math::sin(i * 0.1) * 3.0, i % 4 == 0 ? 4.0 : -6.0 - (i % 5), Math::cos(i * 0.1) * 3.0);
+		from.push_back(origin);
+		to.push_back(origin + motion);
+		transforms.push_back(Transform3D(Basis(Vector3(0, 1, 0), i * 0.05), origin));
+		motions.push_back(motion);
+	}
+
+	RID cast_shape = ps->box_shape_create();
+	ps->shape_set_data(cast_shape, Vector3(0.2, 0.1, 0.3));
+
+	const int counts[] = { 1, 64, max_count };
+	for (int count : counts) {
+		PhysicsDirectSpaceState3D::RayParameters ray_parameters;
+		Vector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(count);
+		Vector<uint8_t> hits;
+		hits.resize(count);
+		const int hit_count = space_state->intersect_rays_batch(ray_parameters, from.ptr(), to.ptr(), count, results.ptrw(), (bool *)hits.ptrw());
+
+		int single_hit_count = 0;
+		int ray_mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			ray_parameters.from = from[i];
+			ray_parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult result;
+			const bool hit = space_state->intersect_ray(ray_parameters, result);
+			single_hit_count += hit;
+			if (hit != bool(hits[i])) {
+				ray_mismatches++;
+			} else if (hit && (result.position != results[i].position || result.normal != results[i].normal || result.rid != results[i].rid || result.shape != results[i].shape)) {
+				ray_mismatches++;
+			}
+		}
+		CHECK_MESSAGE(ray_mismatches == 0, vformat("%d of %d rays differ from single queries.", ray_mismatches, count));
+		CHECK(hit_count == single_hit_count);
+		if (count == max_count) {
+			CHECK(hit_count > 0);
+			CHECK(hit_count < count);
+		}
+
+		PhysicsDirectSpaceState3D::ShapeParameters shape_parameters;
+		shape_parameters.shape_rid = cast_shape;
+		Vector<real_t> safe;
+		Vector<real_t> unsafe;
+		safe.resize(count);
+		unsafe.resize(count);
+		REQUIRE(space_state->cast_motions_batch(shape_parameters, transforms.ptr(), motions.ptr(), count, safe.ptrw(), unsafe.ptrw()));
+
+		int blocked_count = 0;
+		int motion_mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			shape_parameters.transform = transforms[i];
+			shape_parameters.motion = motions[i];
+			real_t single_safe = 0;
+			real_t single_unsafe = 0;
+			REQUIRE(space_state->cast_motion(shape_parameters, single_safe, single_unsafe));
+			blocked_count += single_safe < 1;
+			if (single_safe != safe[i] || single_unsafe != unsafe[i]) {
+				motion_mismatches++;
+			}
+		}
+		CHECK_MESSAGE(motion_mismatches == 0, vformat("%d of %d motions differ from single queries.", motion_mismatches, count));
+		if (count == max_count) {
+			CHECK(blocked_count > 0);
+			CHECK(blocked_count < count);
+		}
+	}
+
+	ps->free(cast_shape);
+}
+
+// Steps per second on a pile large enough to form big islands. This is a pending test since timings
+// are only meaningful on optimized builds; run it with `--test --no-skip --test-case="*Benchmark*"`.
+TEST_CASE_PENDING("[SceneTree][PhysicsServer3D][Benchmark] Box stacks step throughput") {
+	const int columns = 16;
+	const int height = 8;
+	const int steps = 300;
+
+	for (int batched = 0; batched < 2; batched++) {
+		BoxScene scene(batched, columns, height);
+		// Let the stacks settle so the measured steps have their contacts in place.
+		scene.step(30);
+
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		scene.step(steps);
+		const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+		MESSAGE(vformat("%s solver: %d bodies, %d steps in %.2f ms, %.1f steps/s", batched ? "Batched" : "Sequential", scene.boxes.size(), steps, elapsed / 1000.0, steps * 1000000.0 / elapsed).utf8().get_data());
+	}
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H